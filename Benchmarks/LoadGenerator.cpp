@@ -0,0 +1,460 @@
+/**
+ * @file LoadGenerator.cpp
+ * @brief Simula jugadores que usan /repairitems y /deleteplayer para planificar la capacidad del servidor.
+ *
+ * Cada jugador es un AShooterPlayerController del sustituto de AseApi con
+ * un inventario de objetos dañados. Los comandos se ejecutan con
+ * RunChatCommand, por lo que pasan por RepairItemsCallback y
+ * DeletePlayerCallback reales, y el hilo principal hace de hilo del juego:
+ * llama a Tick a la frecuencia indicada y a Timer una vez por segundo. Los
+ * comandos de cada jugador llegan como un proceso de Poisson con la tasa
+ * indicada por minuto.
+ *
+ * La latencia de un comando va desde RunChatCommand hasta que el plugin
+ * libera al jugador con ReleasePlayerCommand, e incluye la espera de las
+ * continuaciones al siguiente tick. El tiempo de bloqueo es el que el
+ * plugin pasa en el hilo del juego dentro de los comandos y de Tick.
+ *
+ * Sin archivo de configuración usa SQLite en un directorio temporal. Con
+ * un config.json del plugin usa sus bases de datos, por ejemplo MySQL o
+ * MariaDB en un contenedor local; las tablas de permisos y puntos se crean
+ * si no existen y se rellenan con los jugadores simulados, por lo que
+ * debe apuntar a una base de datos de pruebas.
+ *
+ * Uso: LoadGenerator [jugadores] [segundos] [repairitems por jugador y minuto]
+ *                    [deleteplayer por jugador y minuto] [ticks por segundo] [config.json]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PluginCore.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int ItemsPerPlayer = 30;
+	constexpr uint64 FirstPlayerId = 76561198000000000ULL;
+
+	/**
+	 * @brief Jugador simulado con su personaje, inventario y próximos comandos.
+	 */
+	struct Player
+	{
+		AShooterPlayerController controller;
+		AShooterCharacter character;
+		UPrimalInventoryComponent inventory;
+		std::vector<UPrimalItem> items;
+
+		Clock::time_point nextRepair;
+		Clock::time_point nextDelete;
+
+		// Comando en curso, hasta que el plugin libera al jugador
+		bool pending = false;
+		bool pendingRepair = false;
+		Clock::time_point started;
+	};
+
+	struct Stats
+	{
+		std::vector<double> repairMs;
+		std::vector<double> deleteMs;
+		std::vector<double> tickUs;
+		size_t issued = 0;
+		size_t busy = 0;
+		size_t rejected = 0;
+		size_t overBudget = 0;
+		double blockedSeconds = 0;
+	};
+
+	double Percentile(const std::vector<double>& sorted, double percentile)
+	{
+		if (sorted.empty()) return 0;
+		return sorted[std::min(sorted.size() - 1, static_cast<size_t>(percentile * sorted.size()))];
+	}
+
+	/**
+	 * @brief Tiempo hasta el siguiente comando de un jugador, o infinito si la tasa es 0.
+	 */
+	Clock::duration NextArrival(std::mt19937_64& random, double perMinute)
+	{
+		if (perMinute <= 0) return Clock::duration::max() / 2;
+
+		std::exponential_distribution<double> distribution(perMinute / 60.0);
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(distribution(random)));
+	}
+
+	/**
+	 * @brief Bloque de SQLite con los valores por defecto de Configs/config.json.
+	 */
+	nlohmann::json SQLiteSettings(const std::filesystem::path& path, const char* table)
+	{
+		return {
+			{ "Enabled", true },
+			{ "UseMySQL", false },
+			{ "UseMemory", false },
+			{ "TableName", table },
+			{ "SQLiteDatabasePath", path.string() },
+			{ "SQLiteTuning", {
+				{ "JournalMode", "WAL" },
+				{ "Synchronous", "NORMAL" },
+				{ "MmapSizeBytes", 268435456 },
+				{ "CacheSizeKiB", 16384 },
+				{ "TempStore", "MEMORY" },
+				{ "BusyTimeoutMs", 5000 },
+				{ "WalCheckpointSeconds", 60 }
+			} }
+		};
+	}
+
+	/**
+	 * @brief Configuración del plugin con archivos SQLite en el directorio indicado.
+	 */
+	nlohmann::json DefaultConfig(const std::filesystem::path& directory)
+	{
+		nlohmann::json config = {
+			{ "General", { { "IgnoreInvRepairRequirements", true }, { "DatabaseWorkers", 2 }, { "SlowQueryMs", 200 } } },
+			{ "Commands", { { "RepairItemCMD", "/repairitems" }, { "DeletePlayerCMD", "/deleteplayer" } } },
+			{ "Messages", nlohmann::json::object() },
+			{ "PermissionGroups", { { "Default", { { "Priority", 99 } } } } }
+		};
+
+		config["PluginDBSettings"] = SQLiteSettings(directory / "PluginTemplate.db", "PluginTemplate");
+		config["PermissionsDBSettings"] = SQLiteSettings(directory / "Permissions.db", "Players");
+		config["PointsDBSettings"] = SQLiteSettings(directory / "ArkShop.db", "ArkShopPlayers");
+
+		return config;
+	}
+
+	/**
+	 * @brief Crea las tablas de permisos y puntos y registra a los jugadores simulados.
+	 */
+	void SeedPlayers(const std::vector<std::unique_ptr<Player>>& players)
+	{
+		const nlohmann::json& permissions = PluginTemplate::config["PermissionsDBSettings"];
+		const nlohmann::json& points = PluginTemplate::config["PointsDBSettings"];
+
+		std::string permissionsTable = permissions.value("TableName", "Players");
+		std::string permissionsId = permissions.value("UniqueIDField", "EOS_Id");
+		std::string permissionsField = permissions.value("PermissionGroupField", "PermissionGroups");
+
+		std::string pointsTable = points.value("TableName", "ArkShopPlayers");
+		std::string pointsId = points.value("UniqueIDField", "EosId");
+		std::string pointsField = points.value("PointsField", "Points");
+		std::string spentField = points.value("TotalSpentField", "TotalSpent");
+
+		PluginTemplate::permissionsDB->createTableIfNotExist(permissionsTable, nlohmann::ordered_json{
+			{ permissionsId, "VARCHAR(50) NOT NULL PRIMARY KEY" },
+			{ permissionsField, "VARCHAR(256)" }
+		});
+		PluginTemplate::pointsDB->createTableIfNotExist(pointsTable, nlohmann::ordered_json{
+			{ pointsId, "VARCHAR(50) NOT NULL PRIMARY KEY" },
+			{ pointsField, "BIGINT" },
+			{ spentField, "BIGINT" }
+		});
+
+		std::vector<DbParams> permissionRows, pointRows;
+		for (const auto& player : players)
+		{
+			std::string eosId = std::to_string(player->controller.playerId);
+			permissionRows.push_back({ eosId, std::string("Default") });
+			pointRows.push_back({ eosId, int64_t{ 1000000000 }, int64_t{ 0 } });
+		}
+
+		for (size_t start = 0; start < players.size(); start += 500)
+		{
+			size_t end = std::min(players.size(), start + 500);
+
+			if (!PluginTemplate::permissionsDB->upsert(permissionsTable, { permissionsId, permissionsField },
+					std::vector<DbParams>(permissionRows.begin() + start, permissionRows.begin() + end), permissionsId, { permissionsField })
+				|| !PluginTemplate::pointsDB->upsert(pointsTable, { pointsId, pointsField, spentField },
+					std::vector<DbParams>(pointRows.begin() + start, pointRows.begin() + end), pointsId, { pointsField, spentField }))
+			{
+				throw std::runtime_error("No se pudieron registrar los jugadores simulados");
+			}
+		}
+	}
+
+	/**
+	 * @brief Ejecuta un tick del hilo del juego y cierra los comandos que el plugin ya liberó.
+	 *
+	 * @return Tiempo que el plugin pasó dentro de Tick.
+	 */
+	Clock::duration Tick(std::vector<std::unique_ptr<Player>>& players, float deltaSeconds, Stats& stats)
+	{
+		Clock::time_point start = Clock::now();
+		ArkApi::GetCommands().Tick(deltaSeconds);
+		Clock::time_point end = Clock::now();
+
+		for (const auto& player : players)
+		{
+			if (!player->pending || PluginTemplate::pendingCommands.count(player->controller.playerId)) continue;
+
+			player->pending = false;
+			double ms = std::chrono::duration<double, std::milli>(end - player->started).count();
+			(player->pendingRepair ? stats.repairMs : stats.deleteMs).push_back(ms);
+		}
+
+		return end - start;
+	}
+
+	/**
+	 * @brief Ejecuta un comando de chat como lo haría el jugador.
+	 *
+	 * @return Tiempo que el plugin pasó dentro del comando.
+	 */
+	Clock::duration Issue(Player& player, const std::string& command, bool repair, Stats& stats)
+	{
+		stats.issued++;
+
+		if (player.pending)
+		{
+			// El plugin ignora el comando mientras el anterior no termine
+			stats.busy++;
+		}
+		else if (repair)
+		{
+			for (UPrimalItem& item : player.items)
+			{
+				item.durability = 0.0f;
+			}
+		}
+
+		Clock::time_point start = Clock::now();
+		ArkApi::GetCommands().RunChatCommand(command, &player.controller);
+		Clock::time_point end = Clock::now();
+
+		if (!player.pending)
+		{
+			if (PluginTemplate::pendingCommands.count(player.controller.playerId))
+			{
+				player.pending = true;
+				player.pendingRepair = repair;
+				player.started = start;
+			}
+			else
+			{
+				stats.rejected++;
+			}
+		}
+
+		return end - start;
+	}
+
+	void PrintLatency(const char* name, std::vector<double>& latencies, double seconds)
+	{
+		std::sort(latencies.begin(), latencies.end());
+		std::printf("%-14s %9zu %10.1f %9.2f %9.2f %9.2f %9.2f %9.2f\n", name, latencies.size(), latencies.size() / seconds,
+			Percentile(latencies, 0.50), Percentile(latencies, 0.90), Percentile(latencies, 0.99), Percentile(latencies, 0.999),
+			latencies.empty() ? 0.0 : latencies.back());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int playerCount = argc > 1 ? std::atoi(argv[1]) : 100;
+	double seconds = argc > 2 ? std::atof(argv[2]) : 30;
+	double repairRate = argc > 3 ? std::atof(argv[3]) : 2;
+	double deleteRate = argc > 4 ? std::atof(argv[4]) : 0.5;
+	double tickRate = argc > 5 ? std::atof(argv[5]) : 30;
+	const char* configPath = argc > 6 ? argv[6] : nullptr;
+
+	// Los comandos escriben un aviso en cada llamada; el registro del sustituto no representa el del servidor
+	Log::GetLog()->set_level(spdlog::level::err);
+
+	std::filesystem::path directory;
+	if (configPath)
+	{
+		std::ifstream file{ configPath };
+		if (!file.is_open())
+		{
+			std::fprintf(stderr, "No se puede abrir %s\n", configPath);
+			return 1;
+		}
+		file >> PluginTemplate::config;
+	}
+	else
+	{
+		directory = std::filesystem::temp_directory_path() / fmt::format("LoadGenerator-{}", Clock::now().time_since_epoch().count());
+		std::filesystem::create_directories(directory);
+		PluginTemplate::config = DefaultConfig(directory);
+	}
+
+	// Los jugadores simulados usan el grupo Default, que debe poder usar los dos comandos
+	PluginTemplate::config["Debug"] = { { "PluginTemplate", false }, { "Permissions", false }, { "Points", false } };
+	PluginTemplate::config["PermissionsDBSettings"]["Enabled"] = true;
+	PluginTemplate::config["PointsDBSettings"]["Enabled"] = true;
+	for (const char* command : { "RepairItemCMD", "DeletePlayerCMD" })
+	{
+		nlohmann::json& settings = PluginTemplate::config["PermissionGroups"]["Default"]["Commands"][command];
+		if (settings.is_null()) settings = { { "Enabled", true }, { "Cost", 1 } };
+	}
+
+	QueryStats::Get().configure(PluginTemplate::config["General"].value("SlowQueryMs", 200));
+
+	// Igual que OnServerReady
+	StartDatabase();
+	StartDatabaseWorkers();
+	AddOrRemoveCommands();
+	SetTimers();
+
+	const std::string repairCommand = PluginTemplate::config["Commands"]["RepairItemCMD"].get<std::string>();
+	const std::string deleteCommand = PluginTemplate::config["Commands"]["DeletePlayerCMD"].get<std::string>();
+
+	PluginTemplate::databaseLoad.wait();
+	if (PluginTemplate::databaseState != PluginTemplate::DatabaseState::Ready)
+	{
+		std::fprintf(stderr, "No se pudieron cargar las bases de datos\n");
+		return 1;
+	}
+
+	std::mt19937_64 random(12345);
+	std::vector<std::unique_ptr<Player>> players;
+
+	for (int i = 0; i < playerCount; i++)
+	{
+		auto player = std::make_unique<Player>();
+		player->items.resize(ItemsPerPlayer);
+		for (UPrimalItem& item : player->items)
+		{
+			player->inventory.items.Add(&item);
+		}
+
+		player->character.inventory = &player->inventory;
+		player->character.playerName = FString(fmt::format("Player{}", i));
+		player->controller.playerId = FirstPlayerId + i;
+		player->controller.characterName = player->character.playerName;
+		player->controller.character = &player->character;
+
+		ArkApi::GetApiUtils().AddPlayer(&player->controller);
+		players.push_back(std::move(player));
+	}
+
+	try
+	{
+		SeedPlayers(players);
+	}
+	catch (const std::exception& error)
+	{
+		std::fprintf(stderr, "%s\n", error.what());
+		return 1;
+	}
+
+	std::printf("%d jugadores, %.0f s, %.2f /repairitems y %.2f /deleteplayer por jugador y minuto, %.0f ticks por segundo\n",
+		playerCount, seconds, repairRate, deleteRate, tickRate);
+
+	Stats stats;
+	const Clock::duration tickInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+	const float deltaSeconds = static_cast<float>(1.0 / tickRate);
+
+	Clock::time_point begin = Clock::now();
+	for (const auto& player : players)
+	{
+		player->nextRepair = begin + NextArrival(random, repairRate);
+		player->nextDelete = begin + NextArrival(random, deleteRate);
+	}
+
+	const Clock::time_point stopIssuing = begin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+	// Tras dejar de enviar comandos se esperan hasta 30 s a los que siguen en curso
+	const Clock::time_point deadline = stopIssuing + std::chrono::seconds(30);
+
+	Clock::time_point nextTick = begin;
+	Clock::time_point nextTimer = begin + std::chrono::seconds(1);
+
+	while (true)
+	{
+		Clock::time_point now = Clock::now();
+		bool issuing = now < stopIssuing;
+
+		if (!issuing && std::none_of(players.begin(), players.end(), [](const auto& player) { return player->pending; })) break;
+		if (now >= deadline) break;
+
+		Clock::duration blocked{ 0 };
+
+		if (issuing)
+		{
+			for (const auto& player : players)
+			{
+				while (player->nextRepair <= now)
+				{
+					blocked += Issue(*player, repairCommand, true, stats);
+					player->nextRepair += NextArrival(random, repairRate);
+				}
+
+				while (player->nextDelete <= now)
+				{
+					blocked += Issue(*player, deleteCommand, false, stats);
+					player->nextDelete += NextArrival(random, deleteRate);
+				}
+			}
+		}
+
+		blocked += Tick(players, deltaSeconds, stats);
+
+		if (now >= nextTimer)
+		{
+			Clock::time_point start = Clock::now();
+			ArkApi::GetCommands().Timer();
+			blocked += Clock::now() - start;
+			nextTimer += std::chrono::seconds(1);
+		}
+
+		stats.tickUs.push_back(std::chrono::duration<double, std::micro>(blocked).count());
+		stats.blockedSeconds += std::chrono::duration<double>(blocked).count();
+		if (blocked > tickInterval) stats.overBudget++;
+
+		nextTick += tickInterval;
+		if (nextTick < Clock::now()) nextTick = Clock::now();
+		std::this_thread::sleep_until(nextTick);
+	}
+
+	double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+	size_t unfinished = std::count_if(players.begin(), players.end(), [](const auto& player) { return player->pending; });
+
+	std::printf("\n%zu comandos enviados, %zu ignorados por tener otro en curso, %zu rechazados sin consultar, %zu sin terminar\n",
+		stats.issued, stats.busy, stats.rejected, unfinished);
+	std::printf("\n%-14s %9s %10s %9s %9s %9s %9s %9s\n", "comando", "completos", "por s", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+	PrintLatency(repairCommand.c_str(), stats.repairMs, seconds);
+	PrintLatency(deleteCommand.c_str(), stats.deleteMs, seconds);
+
+	std::sort(stats.tickUs.begin(), stats.tickUs.end());
+	std::printf("\nHilo del juego: %.3f s bloqueado en %.1f s (%.2f%%), %zu ticks\n",
+		stats.blockedSeconds, elapsed, 100.0 * stats.blockedSeconds / elapsed, stats.tickUs.size());
+	std::printf("Por tick: p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us; %zu ticks superaron los %.1f ms del intervalo\n",
+		Percentile(stats.tickUs, 0.50), Percentile(stats.tickUs, 0.99), Percentile(stats.tickUs, 0.999),
+		stats.tickUs.empty() ? 0.0 : stats.tickUs.back(), stats.overBudget, 1000.0 / tickRate);
+	std::printf("Notificaciones enviadas: %llu\n", static_cast<unsigned long long>(ArkApi::GetApiUtils().notifications.load()));
+
+	// Igual que Plugin_Unload
+	AddOrRemoveCommands(false);
+	SetTimers(false);
+	AsyncDatabase::Get().stop();
+	NonblockingPoller::Get().clear();
+	PluginTemplate::playerWrites.flush();
+
+	for (const auto& player : players)
+	{
+		ArkApi::GetApiUtils().RemovePlayer(player->controller.playerId);
+	}
+
+	PluginTemplate::pluginTemplateDB.reset();
+	PluginTemplate::permissionsDB.reset();
+	PluginTemplate::pointsDB.reset();
+
+	if (!directory.empty())
+	{
+		std::filesystem::remove_all(directory);
+	}
+
+	return 0;
+}
@@ -0,0 +1,386 @@
+/**
+ * @file PluginBenchmarks.cpp
+ * @brief Mide con Google Benchmark las funciones que se ejecutan en cada comando.
+ *
+ * Cubre GetPriorPermByEOSID, GetCommandString, Points (comprobación y
+ * descuento), ReadPlayer, UpdatePlayer, escapeString de cada conector y
+ * la copia a ResultSet de las filas que devuelve read(). Las funciones de
+ * base de datos se miden con cada conector: "sqlite" usa un archivo por
+ * base de datos en un directorio temporal y "memory" usa MemoryConnector.
+ * Las bases de datos se abren con LoadDatabase, igual que en el servidor.
+ *
+ * Si PLUGINTEMPLATE_BENCH_MYSQL apunta a un archivo JSON con un bloque de
+ * conexión (Host, User, Password, Database y Port, como PluginDBSettings),
+ * también se mide con "mysql". Las tablas usan el prefijo Bench, por lo que
+ * no tocan las del plugin. PLUGINTEMPLATE_BENCH_DIR cambia el directorio
+ * donde se crean los archivos de SQLite.
+ *
+ * Uso: PluginBenchmarks [opciones de Google Benchmark]
+ *
+ * Para comparar dos versiones se guarda el resultado en JSON:
+ *   PluginBenchmarks --benchmark_out=resultados.json --benchmark_out_format=json
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "PluginCore.h"
+
+namespace
+{
+	constexpr int PlayerCount = 1000;
+	constexpr int MaterializeRows = 4096;
+
+	const char* PluginTable = "BenchPluginTemplate";
+	const char* PermissionsTable = "BenchPlayers";
+	const char* PointsTable = "BenchArkShopPlayers";
+	const char* RowsTable = "BenchRows";
+
+	/**
+	 * @brief Conexiones abiertas con LoadDatabase para un tipo de conector.
+	 */
+	struct Backend
+	{
+		std::string name;
+		std::shared_ptr<IDatabaseConnector> plugin;
+		std::shared_ptr<IDatabaseConnector> permissions;
+		std::shared_ptr<IDatabaseConnector> points;
+	};
+
+	std::vector<FString> players;
+
+	/**
+	 * @brief Apunta las conexiones globales del plugin al conector del benchmark.
+	 */
+	void Use(const Backend& backend)
+	{
+		PluginTemplate::pluginTemplateDB = backend.plugin;
+		PluginTemplate::permissionsDB = backend.permissions;
+		PluginTemplate::pointsDB = backend.points;
+	}
+
+	const FString& NextPlayer(size_t& index)
+	{
+		const FString& player = players[index];
+		index = (index + 1) % players.size();
+		return player;
+	}
+
+	/**
+	 * @brief Configuración del plugin con las tablas del benchmark y sin mensajes de depuración.
+	 *
+	 * @param connection Bloque de conexión común a las tres bases de datos.
+	 * @param directory Directorio de los archivos de SQLite, vacío para otros conectores.
+	 */
+	nlohmann::json MakeConfig(const nlohmann::json& connection, const std::filesystem::path& directory)
+	{
+		nlohmann::json config = {
+			{ "Debug", { { "PluginTemplate", false }, { "Permissions", false }, { "Points", false } } },
+			{ "Commands", { { "RepairItemCMD", "/repairitems" }, { "DeletePlayerCMD", "/deleteplayer" } } },
+			{ "PermissionGroups", {
+				{ "Default", { { "Priority", 99 }, { "Commands", { { "RepairItemCMD", { { "Enabled", true }, { "Cost", 10 } } } } } } },
+				{ "VIP", { { "Priority", 10 }, { "Commands", { { "RepairItemCMD", { { "Enabled", true }, { "Cost", 5 } } } } } } },
+				{ "Admins", { { "Priority", 1 }, { "Commands", { { "RepairItemCMD", { { "Enabled", true }, { "Cost", 0 } } } } } } }
+			} }
+		};
+
+		auto block = [&](const char* file, const char* table)
+		{
+			nlohmann::json settings = connection;
+			settings["Enabled"] = true;
+			settings["TableName"] = table;
+			if (!directory.empty())
+			{
+				settings["SQLiteDatabasePath"] = (directory / file).string();
+			}
+			return settings;
+		};
+
+		config["PluginDBSettings"] = block("Plugin.db", PluginTable);
+		config["PermissionsDBSettings"] = block("Permissions.db", PermissionsTable);
+		config["PermissionsDBSettings"]["UniqueIDField"] = "EOS_Id";
+		config["PermissionsDBSettings"]["PermissionGroupField"] = "PermissionGroups";
+		config["PointsDBSettings"] = block("Points.db", PointsTable);
+		config["PointsDBSettings"]["UniqueIDField"] = "EosId";
+		config["PointsDBSettings"]["PointsField"] = "Points";
+		config["PointsDBSettings"]["TotalSpentField"] = "TotalSpent";
+
+		return config;
+	}
+
+	/**
+	 * @brief Inserta o reemplaza las filas en lotes de 500.
+	 */
+	void Seed(IDatabaseConnector& db, const std::string& table, const std::vector<std::string>& columns, const std::vector<DbParams>& rows)
+	{
+		std::vector<std::string> updateColumns(columns.begin() + 1, columns.end());
+
+		for (size_t start = 0; start < rows.size(); start += 500)
+		{
+			std::vector<DbParams> chunk(rows.begin() + start, rows.begin() + std::min(rows.size(), start + 500));
+			if (!db.upsert(table, columns, chunk, columns.front(), updateColumns))
+			{
+				throw std::runtime_error("No se pudieron insertar las filas de " + table);
+			}
+		}
+	}
+
+	/**
+	 * @brief Abre las bases de datos con LoadDatabase y crea las tablas del benchmark.
+	 */
+	Backend Open(const std::string& name, const nlohmann::json& config)
+	{
+		PluginTemplate::config = config;
+		LoadDatabase(config);
+
+		Backend backend{ name, PluginTemplate::pluginTemplateDB, PluginTemplate::permissionsDB, PluginTemplate::pointsDB };
+
+		backend.permissions->createTableIfNotExist(PermissionsTable, nlohmann::ordered_json{
+			{ "EOS_Id", "VARCHAR(50) NOT NULL PRIMARY KEY" },
+			{ "PermissionGroups", "VARCHAR(256)" }
+		});
+		backend.points->createTableIfNotExist(PointsTable, nlohmann::ordered_json{
+			{ "EosId", "VARCHAR(50) NOT NULL PRIMARY KEY" },
+			{ "Points", "BIGINT" },
+			{ "TotalSpent", "BIGINT" }
+		});
+		backend.plugin->createTableIfNotExist(RowsTable, nlohmann::ordered_json{
+			{ "Id", "INTEGER NOT NULL PRIMARY KEY" },
+			{ "EosId", "VARCHAR(50)" },
+			{ "PlayerName", "VARCHAR(100)" },
+			{ "Points", "BIGINT" }
+		});
+
+		std::vector<DbParams> permissions, points, plugin, rows;
+		for (int i = 0; i < PlayerCount; i++)
+		{
+			std::string eosId = players[i].ToString();
+			permissions.push_back({ eosId, std::string(i % 10 == 0 ? "Default,VIP,Admins" : "Default,VIP") });
+			points.push_back({ eosId, int64_t{ 1000000000 }, int64_t{ 0 } });
+			plugin.push_back({ eosId, std::to_string(i), "Player" + std::to_string(i) });
+		}
+
+		for (int i = 0; i < MaterializeRows; i++)
+		{
+			rows.push_back({ int64_t{ i }, players[i % PlayerCount].ToString(), "Player" + std::to_string(i), int64_t{ i * 10 } });
+		}
+
+		Seed(*backend.permissions, PermissionsTable, { "EOS_Id", "PermissionGroups" }, permissions);
+		Seed(*backend.points, PointsTable, { "EosId", "Points", "TotalSpent" }, points);
+		Seed(*backend.plugin, PluginTable, PluginTemplate::PlayersTable::insertColumns(), plugin);
+		Seed(*backend.plugin, RowsTable, { "Id", "EosId", "PlayerName", "Points" }, rows);
+
+		return backend;
+	}
+
+	void BM_GetCommandString(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(GetCommandString("VIP", "RepairItemCMD"));
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_GetPriorPermByEOSID(benchmark::State& state, const Backend* backend)
+	{
+		Use(*backend);
+		size_t index = 0;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(GetPriorPermByEOSID(NextPlayer(index)));
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_PointsCheck(benchmark::State& state, const Backend* backend)
+	{
+		Use(*backend);
+		size_t index = 0;
+
+		for (auto _ : state)
+		{
+			if (!Points(NextPlayer(index), 10, true))
+			{
+				state.SkipWithError("Points no encontró al jugador");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_PointsDeduct(benchmark::State& state, const Backend* backend)
+	{
+		Use(*backend);
+		size_t index = 0;
+
+		for (auto _ : state)
+		{
+			if (!Points(NextPlayer(index), 1, false))
+			{
+				state.SkipWithError("Points no pudo descontar");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_ReadPlayer(benchmark::State& state, const Backend* backend)
+	{
+		Use(*backend);
+		size_t index = 0;
+
+		for (auto _ : state)
+		{
+			if (!ReadPlayer(NextPlayer(index)))
+			{
+				state.SkipWithError("ReadPlayer no encontró al jugador");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_UpdatePlayer(benchmark::State& state, const Backend* backend)
+	{
+		Use(*backend);
+		size_t index = 0;
+		FString name = "Player";
+
+		for (auto _ : state)
+		{
+			if (!UpdatePlayer(NextPlayer(index), name))
+			{
+				state.SkipWithError("UpdatePlayer falló");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_EscapeString(benchmark::State& state, const Backend* backend)
+	{
+		// Un nombre de jugador con comillas y barras, repetido hasta el largo pedido
+		const std::string pattern = "O'Brien \"\\x\" ";
+		std::string value;
+		while (value.size() < static_cast<size_t>(state.range(0))) value += pattern;
+		value.resize(state.range(0));
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(backend->plugin->escapeString(value));
+		}
+
+		state.SetBytesProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_ReadMaterialize(benchmark::State& state, const Backend* backend)
+	{
+		std::string query = fmt::format("SELECT * FROM {} LIMIT {}", RowsTable, state.range(0));
+		ResultSet results;
+
+		for (auto _ : state)
+		{
+			if (!backend->plugin->read(query, {}, results) || results.rowCount() != static_cast<size_t>(state.range(0)))
+			{
+				state.SkipWithError("read no devolvió las filas esperadas");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	/**
+	 * @brief Registra las mediciones de base de datos con el nombre del conector.
+	 */
+	void Register(const Backend& backend)
+	{
+		auto name = [&](const char* benchmark) { return std::string(benchmark) + "/" + backend.name; };
+
+		benchmark::RegisterBenchmark(name("GetPriorPermByEOSID").c_str(), BM_GetPriorPermByEOSID, &backend);
+		benchmark::RegisterBenchmark(name("PointsCheck").c_str(), BM_PointsCheck, &backend);
+		benchmark::RegisterBenchmark(name("PointsDeduct").c_str(), BM_PointsDeduct, &backend);
+		benchmark::RegisterBenchmark(name("ReadPlayer").c_str(), BM_ReadPlayer, &backend);
+		benchmark::RegisterBenchmark(name("UpdatePlayer").c_str(), BM_UpdatePlayer, &backend);
+		benchmark::RegisterBenchmark(name("EscapeString").c_str(), BM_EscapeString, &backend)->Arg(16)->Arg(256);
+		benchmark::RegisterBenchmark(name("ReadMaterialize").c_str(), BM_ReadMaterialize, &backend)->Arg(1)->Arg(64)->Arg(MaterializeRows);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+	Log::GetLog()->set_level(spdlog::level::err);
+
+	for (int i = 0; i < PlayerCount; i++)
+	{
+		players.push_back(FString(fmt::format("000200{:026}", i)));
+	}
+
+	const char* benchDir = std::getenv("PLUGINTEMPLATE_BENCH_DIR");
+	std::filesystem::path directory = std::filesystem::path(benchDir ? benchDir : std::filesystem::temp_directory_path().string())
+		/ fmt::format("PluginBenchmarks-{}", std::chrono::steady_clock::now().time_since_epoch().count());
+	std::filesystem::create_directories(directory);
+
+	// Las direcciones de cada Backend deben ser estables: las mediciones guardan un puntero
+	std::vector<std::unique_ptr<Backend>> backends;
+
+	try
+	{
+		backends.push_back(std::make_unique<Backend>(Open("sqlite", MakeConfig({ { "UseMySQL", false }, { "UseMemory", false } }, directory))));
+		backends.push_back(std::make_unique<Backend>(Open("memory", MakeConfig({ { "UseMySQL", false }, { "UseMemory", true } }, {}))));
+
+		if (const char* mysqlConfig = std::getenv("PLUGINTEMPLATE_BENCH_MYSQL"))
+		{
+			std::ifstream file{ mysqlConfig };
+			nlohmann::json connection = nlohmann::json::parse(file);
+			connection["UseMySQL"] = true;
+			connection["UseMemory"] = false;
+
+			backends.push_back(std::make_unique<Backend>(Open("mysql", MakeConfig(connection, {}))));
+		}
+	}
+	catch (const std::exception& error)
+	{
+		std::fprintf(stderr, "No se pudieron preparar las bases de datos: %s\n", error.what());
+		std::filesystem::remove_all(directory);
+		return 1;
+	}
+
+	benchmark::AddCustomContext("sqlite_version", sqlite3_libversion());
+	benchmark::AddCustomContext("players", std::to_string(PlayerCount));
+
+	benchmark::RegisterBenchmark("GetCommandString", BM_GetCommandString);
+	for (const auto& backend : backends)
+	{
+		Register(*backend);
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	PluginTemplate::playerWrites.configure(nullptr, "", std::chrono::milliseconds(0), 0);
+	Use({});
+	backends.clear();
+	std::filesystem::remove_all(directory);
+
+	return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file QueryBuilderBenchmark.cpp
+ * @brief Compara las reservas de memoria al construir consultas con cadenas y con QueryBuilder.
+ *
+ * Cada comando construye el INSERT y el UPDATE que genera
+ * SQLiteConnector::create y SQLiteConnector::update para la tabla del
+ * plugin. La versión con cadenas reproduce el código anterior, que
+ * concatenaba std::string y escapaba cada valor en una cadena nueva.
+ * Las reservas se cuentan reemplazando el operator new global.
+ *
+ * Uso: QueryBuilderBenchmark [comandos]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "QueryBuilder.h"
+
+namespace
+{
+	std::atomic<size_t> allocations{ 0 };
+
+	using Row = std::vector<std::pair<std::string, std::string>>;
+
+	std::string EscapeString(const std::string& value)
+	{
+		std::string escaped;
+		escaped.reserve(value.length());
+
+		for (char c : value)
+		{
+			switch (c)
+			{
+			case '\'':
+				escaped += "''";
+				break;
+			default:
+				escaped += c;
+				break;
+			}
+		}
+
+		return escaped;
+	}
+
+	size_t StringCreate(const std::string& tableName, const Row& data)
+	{
+		std::string query = "INSERT INTO " + tableName + " (";
+		std::string values = " VALUES (";
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			query += data[i].first;
+			values += "'" + EscapeString(data[i].second) + "'";
+			if (i < data.size() - 1)
+			{
+				query += ", ";
+				values += ", ";
+			}
+		}
+
+		query += ") " + values + ")";
+
+		return query.size();
+	}
+
+	size_t StringUpdate(const std::string& tableName, const Row& data, const std::string& condition)
+	{
+		std::string query = "UPDATE " + tableName + " SET ";
+
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			query += data[i].first + " = '" + EscapeString(data[i].second) + "'";
+			if (i < data.size() - 1)
+			{
+				query += ", ";
+			}
+		}
+
+		query += " WHERE " + condition;
+
+		return query.size();
+	}
+
+	size_t BuilderCreate(const std::string& tableName, const Row& data)
+	{
+		QueryBuilder query;
+		query.append("INSERT INTO ").append(tableName).append(" (");
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			if (i > 0) query.append(", ");
+			query.append(data[i].first);
+		}
+
+		query.append(") VALUES (");
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			if (i > 0) query.append(", ");
+			query.appendQuoted(data[i].second);
+		}
+
+		query.append(')');
+
+		return std::char_traits<char>::length(query.c_str());
+	}
+
+	size_t BuilderUpdate(const std::string& tableName, const Row& data, const std::string& condition)
+	{
+		QueryBuilder query;
+		query.append("UPDATE ").append(tableName).append(" SET ");
+
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			if (i > 0) query.append(", ");
+			query.append(data[i].first).append(" = ").appendQuoted(data[i].second);
+		}
+
+		query.append(" WHERE ").append(condition);
+
+		return std::char_traits<char>::length(query.c_str());
+	}
+
+	struct Result
+	{
+		double allocationsPerCommand = 0;
+		double nanosPerCommand = 0;
+		// Se imprime para que el compilador no descarte las consultas
+		size_t bytes = 0;
+	};
+
+	template <typename Create, typename Update>
+	Result Run(int commands, const std::vector<Row>& rows, const std::vector<std::string>& conditions, Create create, Update update)
+	{
+		const std::string tableName = "PluginTemplate";
+		Result result;
+
+		// Primera pasada fuera de la medición, como tras unos minutos de servidor
+		result.bytes += create(tableName, rows[0]) + update(tableName, rows[0], conditions[0]);
+
+		size_t before = allocations.load();
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < commands; i++)
+		{
+			const Row& row = rows[i % rows.size()];
+			result.bytes += create(tableName, row);
+			result.bytes += update(tableName, row, conditions[i % conditions.size()]);
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		result.allocationsPerCommand = static_cast<double>(allocations.load() - before) / commands;
+		result.nanosPerCommand = std::chrono::duration<double, std::nano>(end - start).count() / commands;
+		return result;
+	}
+}
+
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+int main(int argc, char** argv)
+{
+	int commands = argc > 1 ? std::atoi(argv[1]) : 200000;
+	if (commands <= 0) commands = 1;
+
+	std::vector<Row> rows;
+	std::vector<std::string> conditions;
+	for (int i = 0; i < 1000; i++)
+	{
+		std::string eosId = "0002" + std::to_string(1000000000 + i) + "f3c1a9e4b7d2";
+		std::string name = i % 10 == 0 ? "O'Player " + std::to_string(i) : "Player " + std::to_string(i);
+
+		conditions.push_back("EosId = '" + eosId + "'");
+		rows.push_back({ { "EosId", eosId }, { "PlayerId", std::to_string(500000 + i) }, { "PlayerName", std::move(name) } });
+	}
+
+	Result strings = Run(commands, rows, conditions, StringCreate, StringUpdate);
+	Result builder = Run(commands, rows, conditions, BuilderCreate, BuilderUpdate);
+
+	std::printf("%-14s %16s %12s %14s\n", "builder", "allocs/command", "ns/command", "bytes");
+	std::printf("%-14s %16.2f %12.0f %14zu\n", "std::string", strings.allocationsPerCommand, strings.nanosPerCommand, strings.bytes);
+	std::printf("%-14s %16.2f %12.0f %14zu\n", "QueryBuilder", builder.allocationsPerCommand, builder.nanosPerCommand, builder.bytes);
+
+	return 0;
+}
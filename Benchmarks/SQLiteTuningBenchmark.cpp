@@ -0,0 +1,274 @@
+/**
+ * @file SQLiteTuningBenchmark.cpp
+ * @brief Compara los perfiles de SQLiteTuning con la carga de escritura del plugin.
+ *
+ * Cada hilo simula comandos de jugadores: registra al jugador con un
+ * upsert en la tabla del plugin y descuenta puntos con una lectura y una
+ * actualización en una transacción, en una conexión distinta como hacen
+ * pluginTemplateDB y pointsDB. Cada hilo usa sus propias conexiones al
+ * mismo archivo, por lo que los perfiles sin busy_timeout muestran los
+ * errores SQLITE_BUSY.
+ *
+ * Uso: SQLiteTuningBenchmark [directorio] [comandos por hilo] [hilos]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SQLiteTuning.h"
+
+namespace
+{
+	struct Profile
+	{
+		const char* name;
+		SQLiteTuning tuning;
+	};
+
+	struct Result
+	{
+		double seconds = 0;
+		size_t commands = 0;
+		size_t busyErrors = 0;
+		size_t otherErrors = 0;
+		std::vector<double> latenciesUs;
+	};
+
+	sqlite3* Open(const std::string& path, const SQLiteTuning& tuning)
+	{
+		sqlite3* db = nullptr;
+		if (sqlite3_open(path.c_str(), &db) != SQLITE_OK)
+		{
+			std::fprintf(stderr, "No se pudo abrir %s: %s\n", path.c_str(), sqlite3_errmsg(db));
+			std::exit(1);
+		}
+
+		std::vector<std::string> errors;
+		tuning.apply(db, errors);
+		for (const std::string& error : errors)
+		{
+			std::fprintf(stderr, "%s\n", error.c_str());
+		}
+
+		return db;
+	}
+
+	void Exec(sqlite3* db, const char* sql)
+	{
+		char* error = nullptr;
+		if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK)
+		{
+			std::fprintf(stderr, "%s: %s\n", sql, error);
+			std::exit(1);
+		}
+	}
+
+	/**
+	 * @brief Prepara una sentencia reintentando mientras el esquema esté bloqueado.
+	 */
+	sqlite3_stmt* Prepare(sqlite3* db, const char* sql)
+	{
+		sqlite3_stmt* stmt = nullptr;
+		int rc;
+		while ((rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr)) == SQLITE_BUSY)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		if (rc != SQLITE_OK)
+		{
+			std::fprintf(stderr, "%s: %s\n", sql, sqlite3_errmsg(db));
+			std::exit(1);
+		}
+
+		return stmt;
+	}
+
+	/**
+	 * @brief Ejecuta una sentencia hasta SQLITE_DONE y cuenta los errores.
+	 */
+	bool Step(sqlite3_stmt* stmt, Result& result)
+	{
+		int rc;
+		while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+		{
+		}
+		sqlite3_reset(stmt);
+
+		if (rc == SQLITE_DONE) return true;
+
+		if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED)
+		{
+			result.busyErrors++;
+		}
+		else
+		{
+			result.otherErrors++;
+		}
+
+		return false;
+	}
+
+	void Worker(const std::string& path, const SQLiteTuning& tuning, int thread, int commands, Result& result)
+	{
+		sqlite3* pluginDB = Open(path, tuning);
+		sqlite3* pointsDB = Open(path, tuning);
+
+		sqlite3_stmt* upsertPlayer = Prepare(pluginDB, "INSERT INTO PluginTemplate (EosId, PlayerId, PlayerName) VALUES (?, ?, ?) ON CONFLICT(EosId) DO UPDATE SET PlayerName = excluded.PlayerName");
+
+		// Igual que SQLiteConnector::beginTransaction
+		sqlite3_stmt* begin = Prepare(pointsDB, "BEGIN IMMEDIATE");
+		sqlite3_stmt* commit = Prepare(pointsDB, "COMMIT");
+		sqlite3_stmt* rollback = Prepare(pointsDB, "ROLLBACK");
+		sqlite3_stmt* readPoints = Prepare(pointsDB, "SELECT Points, TotalSpent FROM ArkShopPlayers WHERE EosId = ?");
+		sqlite3_stmt* updatePoints = Prepare(pointsDB, "UPDATE ArkShopPlayers SET Points = ?, TotalSpent = ? WHERE EosId = ?");
+
+		result.latenciesUs.reserve(commands);
+
+		for (int i = 0; i < commands; i++)
+		{
+			std::string eosId = std::to_string(thread * 1000 + i % 1000);
+			std::string name = "Player" + std::to_string(i);
+
+			auto start = std::chrono::steady_clock::now();
+
+			sqlite3_bind_text(upsertPlayer, 1, eosId.c_str(), -1, SQLITE_STATIC);
+			sqlite3_bind_text(upsertPlayer, 2, eosId.c_str(), -1, SQLITE_STATIC);
+			sqlite3_bind_text(upsertPlayer, 3, name.c_str(), -1, SQLITE_STATIC);
+			bool success = Step(upsertPlayer, result);
+
+			if (success && Step(begin, result))
+			{
+				sqlite3_bind_text(readPoints, 1, eosId.c_str(), -1, SQLITE_STATIC);
+				int64_t points = 0;
+				int64_t spent = 0;
+				int rc = sqlite3_step(readPoints);
+				if (rc == SQLITE_ROW)
+				{
+					points = sqlite3_column_int64(readPoints, 0);
+					spent = sqlite3_column_int64(readPoints, 1);
+				}
+				sqlite3_reset(readPoints);
+
+				sqlite3_bind_int64(updatePoints, 1, points - 1);
+				sqlite3_bind_int64(updatePoints, 2, spent + 1);
+				sqlite3_bind_text(updatePoints, 3, eosId.c_str(), -1, SQLITE_STATIC);
+
+				success = (rc == SQLITE_ROW || rc == SQLITE_DONE) && Step(updatePoints, result) && Step(commit, result);
+				if (!success && !sqlite3_get_autocommit(pointsDB))
+				{
+					sqlite3_step(rollback);
+					sqlite3_reset(rollback);
+				}
+			}
+
+			auto end = std::chrono::steady_clock::now();
+			if (success)
+			{
+				result.commands++;
+				result.latenciesUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+			}
+		}
+
+		for (sqlite3_stmt* stmt : { upsertPlayer, begin, commit, rollback, readPoints, updatePoints })
+		{
+			sqlite3_finalize(stmt);
+		}
+		sqlite3_close(pluginDB);
+		sqlite3_close(pointsDB);
+	}
+
+	Result Run(const std::string& directory, const Profile& profile, int commands, int threads)
+	{
+		std::string path = directory + "/sqlite-tuning-" + profile.name + ".db";
+		for (const char* suffix : { "", "-wal", "-shm", "-journal" })
+		{
+			std::remove((path + suffix).c_str());
+		}
+
+		sqlite3* setup = Open(path, profile.tuning);
+		Exec(setup, "CREATE TABLE PluginTemplate (Id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, EosId TEXT NOT NULL UNIQUE, PlayerId TEXT NOT NULL, PlayerName TEXT NOT NULL, CreateAt DATETIME DEFAULT CURRENT_TIMESTAMP)");
+		Exec(setup, "CREATE TABLE ArkShopPlayers (Id INTEGER PRIMARY KEY AUTOINCREMENT, EosId TEXT NOT NULL UNIQUE, Points INTEGER DEFAULT 0, TotalSpent INTEGER DEFAULT 0)");
+		Exec(setup, "BEGIN");
+		for (int thread = 0; thread < threads; thread++)
+		{
+			for (int i = 0; i < 1000; i++)
+			{
+				std::string sql = "INSERT INTO ArkShopPlayers (EosId, Points) VALUES ('" + std::to_string(thread * 1000 + i) + "', 1000000)";
+				Exec(setup, sql.c_str());
+			}
+		}
+		Exec(setup, "COMMIT");
+
+		std::vector<Result> results(threads);
+		std::vector<std::thread> workers;
+
+		auto start = std::chrono::steady_clock::now();
+		for (int thread = 0; thread < threads; thread++)
+		{
+			workers.emplace_back(Worker, path, std::cref(profile.tuning), thread, commands, std::ref(results[thread]));
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		sqlite3_close(setup);
+
+		Result total;
+		total.seconds = std::chrono::duration<double>(end - start).count();
+		for (Result& result : results)
+		{
+			total.commands += result.commands;
+			total.busyErrors += result.busyErrors;
+			total.otherErrors += result.otherErrors;
+			total.latenciesUs.insert(total.latenciesUs.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+		}
+		std::sort(total.latenciesUs.begin(), total.latenciesUs.end());
+
+		return total;
+	}
+
+	double Percentile(const std::vector<double>& sorted, double percentile)
+	{
+		if (sorted.empty()) return 0;
+		return sorted[std::min(sorted.size() - 1, static_cast<size_t>(percentile * sorted.size()))];
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string directory = argc > 1 ? argv[1] : ".";
+	int commands = argc > 2 ? std::atoi(argv[2]) : 2000;
+	int threads = argc > 3 ? std::atoi(argv[3]) : 2;
+
+	SQLiteTuning walFull;
+	walFull.synchronous = "FULL";
+	walFull.mmapSizeBytes = -1;
+	walFull.cacheSizeKiB = -1;
+	walFull.tempStore = "";
+
+	const Profile profiles[] = {
+		{ "default", SQLiteTuning::defaults() },
+		{ "wal-full", walFull },
+		{ "recommended", SQLiteTuning() },
+	};
+
+	std::printf("%-12s %10s %12s %10s %10s %8s %8s\n", "profile", "commands", "commands/s", "p50 us", "p99 us", "busy", "errors");
+
+	for (const Profile& profile : profiles)
+	{
+		Result result = Run(directory, profile, commands, threads);
+
+		std::printf("%-12s %10zu %12.0f %10.0f %10.0f %8zu %8zu\n", profile.name, result.commands, result.commands / result.seconds,
+			Percentile(result.latenciesUs, 0.50), Percentile(result.latenciesUs, 0.99), result.busyErrors, result.otherErrors);
+	}
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @file PluginCore.h
+ * @brief Núcleo del plugin: base de datos, permisos y puntos, configuración y comandos.
+ *
+ * Reúne todo lo que no depende de los ganchos del servidor. Solo usa la
+ * parte de AseApi que cubre Stubs/ArkApi, por lo que también se compila
+ * en Linux para las herramientas de medición (ver CMakeLists.txt).
+ */
+
+#include "API/ARK/Ark.h"
+
+#include "PluginTemplate.h"
+
+#include "Utils.h"
+
+// Todas las demás cabeceras van aquí
+#include "RepairItems.h"
+
+// Fin de otras cabeceras
+
+#include "Timers.h"
+
+#include "Commands.h"
+
+#include "Reload.h"
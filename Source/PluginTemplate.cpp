@@ -2,23 +2,10 @@
 
 #include "API/ARK/Ark.h"
 
-#include "PluginTemplate.h"
-
-#include "Utils.h"
-
-// Todas las demás cabeceras van aquí
-#include "RepairItems.h"
-
-// Fin de otras cabeceras
+#include "PluginCore.h"
 
 #include "Hooks.h"
 
-#include "Timers.h"
-
-#include "Commands.h"
-
-#include "Reload.h"
-
 #pragma comment(lib, "ArkApi.lib")
 
 /**
@@ -27,15 +14,35 @@
  * Esta función se ejecuta cuando el servidor ARK ha terminado de cargar
  * y está listo para aceptar conexiones. Inicializa el plugin cargando
  * la configuración, bases de datos, comandos, temporizadores y ganchos.
+ * Las bases de datos se conectan en segundo plano: los comandos quedan
+ * registrados de inmediato y responden que el plugin se está iniciando
+ * hasta que terminan de cargarse.
+ * Si la configuración no se puede leer no se registra nada y el plugin
+ * queda sin iniciar, para que una llamada posterior vuelva a intentarlo.
  */
 void OnServerReady()
 {
+	// BeginPlay puede llegar después de que Plugin_Init ya inicializó el plugin
+	if (PluginTemplate::started.exchange(true)) return;
+
 	Log::GetLog()->info("PluginTemplate Inicializado");
 
 	// Agregar función aquí
-	ReadConfig();
-	LoadDatabase();
+	try
+	{
+		ReadConfig();
+	}
+	catch (const std::exception& error)
+	{
+		// Sin configuración no se registra nada; un BeginPlay o Plugin_Init posterior puede reintentar
+		Log::GetLog()->error("No se pudo leer la configuración de PluginTemplate: {}", error.what());
+		PluginTemplate::started = false;
+		return;
+	}
+	StartDatabase();
+	StartDatabaseWorkers();
 	AddReloadCommands();
+	AddOrRemoveCommands();
 	SetTimers();
 	SetHooks();
 }
@@ -84,6 +91,15 @@ extern "C" __declspec(dllexport) void Plugin_Unload()
 
 	// Realizar limpieza aquí
 	AddReloadCommands(false);
+	if (PluginTemplate::started) AddOrRemoveCommands(false);
 	SetTimers(false);
 	SetHooks(false);
+	AsyncDatabase::Get().stop();
+	NonblockingPoller::Get().clear();
+
+	// Una carga en curso debe terminar antes de cerrar las conexiones
+	if (PluginTemplate::databaseLoad.valid()) PluginTemplate::databaseLoad.wait();
+
+	// Las escrituras diferidas se guardan antes de cerrar las conexiones
+	PluginTemplate::playerWrites.flush();
 }
\ No newline at end of file
@@ -0,0 +1,325 @@
+#ifndef ASYNCDATABASE_H
+#define ASYNCDATABASE_H
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <API/ARK/Ark.h> // requerido en GetLog y Log
+
+/**
+ * @class AsyncDatabase
+ * @brief Ejecuta el trabajo de base de datos fuera del hilo del juego.
+ *
+ * Las tareas se encolan desde el hilo del juego y se ejecutan en uno o
+ * varios hilos de trabajo. Las continuaciones que reciben el resultado se
+ * guardan en una cola y se ejecutan de nuevo en el hilo del juego cuando
+ * se llama a poll() desde el tick del servidor, por lo que pueden usar
+ * objetos del juego con seguridad.
+ */
+class AsyncDatabase
+{
+public:
+	/**
+	 * @brief Obtiene la instancia única del ejecutor.
+	 *
+	 * @return Referencia al ejecutor de base de datos del plugin.
+	 */
+	static AsyncDatabase& Get()
+	{
+		static AsyncDatabase instance;
+		return instance;
+	}
+
+	AsyncDatabase(const AsyncDatabase&) = delete;
+	AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+
+	~AsyncDatabase()
+	{
+		stop();
+	}
+
+	/**
+	 * @brief Inicia los hilos de trabajo.
+	 *
+	 * Si el ejecutor ya está en marcha no hace nada.
+	 *
+	 * @param workers Número de hilos de trabajo (mínimo 1).
+	 */
+	void start(size_t workers = 1)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!threads.empty()) return;
+
+		stopping = false;
+		for (size_t i = 0; i < (workers > 0 ? workers : 1); i++)
+		{
+			threads.emplace_back([this]() { workerLoop(); });
+		}
+	}
+
+	/**
+	 * @brief Detiene los hilos de trabajo.
+	 *
+	 * Las tareas ya encoladas se terminan de ejecutar antes de salir. Las
+	 * continuaciones pendientes se descartan porque el plugin se está
+	 * descargando y los objetos del juego pueden no ser válidos.
+	 */
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (threads.empty()) return;
+			stopping = true;
+		}
+		jobAvailable.notify_all();
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		threads.clear();
+
+		std::lock_guard<std::mutex> lock(completedMutex);
+		completed.clear();
+	}
+
+	/**
+	 * @brief Espera a que no quede ninguna tarea pendiente ni en ejecución.
+	 *
+	 * Se usa antes de recargar la configuración para que ningún hilo de
+	 * trabajo la lea mientras se reemplaza.
+	 */
+	void drain()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.wait(lock, [this]() { return jobs.empty() && busy == 0; });
+	}
+
+	/**
+	 * @brief Ejecuta una tarea en segundo plano y su continuación en el hilo del juego.
+	 *
+	 * Si la tarea lanza una excepción se registra el error y en lugar de la
+	 * continuación se ejecuta onError, también en el hilo del juego. Así quien
+	 * llama siempre recibe una respuesta y puede liberar su estado.
+	 *
+	 * @param work Tarea a ejecutar en un hilo de trabajo.
+	 * @param then Continuación que recibe el resultado de la tarea (si no es void).
+	 * @param onError Continuación a ejecutar si la tarea falla.
+	 */
+	template <typename Work, typename Then, typename OnError>
+	void run(Work&& work, Then&& then, OnError&& onError)
+	{
+		using Result = std::invoke_result_t<Work>;
+
+		enqueue([this, work = std::forward<Work>(work), then = std::forward<Then>(then), onError = std::forward<OnError>(onError)]() mutable
+		{
+			try
+			{
+				if constexpr (std::is_void_v<Result>)
+				{
+					work();
+					complete(std::move(then));
+				}
+				else
+				{
+					complete([then = std::move(then), result = work()]() mutable { then(std::move(result)); });
+				}
+				return;
+			}
+			catch (const std::exception& error)
+			{
+				Log::GetLog()->error("Error en tarea de base de datos: {}", error.what());
+			}
+			catch (...)
+			{
+				Log::GetLog()->error("Error desconocido en tarea de base de datos");
+			}
+
+			complete(std::move(onError));
+		});
+	}
+
+	/**
+	 * @brief Ejecuta una tarea en segundo plano y su continuación en el hilo del juego.
+	 *
+	 * Si la tarea lanza una excepción se registra el error y la
+	 * continuación no se ejecuta.
+	 *
+	 * @param work Tarea a ejecutar en un hilo de trabajo.
+	 * @param then Continuación que recibe el resultado de la tarea (si no es void).
+	 */
+	template <typename Work, typename Then>
+	void run(Work&& work, Then&& then)
+	{
+		run(std::forward<Work>(work), std::forward<Then>(then), []() {});
+	}
+
+	/**
+	 * @brief Ejecuta una tarea en segundo plano sin continuación.
+	 *
+	 * @param work Tarea a ejecutar en un hilo de trabajo.
+	 */
+	void run(std::function<void()> work)
+	{
+		enqueue(std::move(work));
+	}
+
+	/**
+	 * @brief Ejecuta una tarea en segundo plano y devuelve un future con su resultado.
+	 *
+	 * @param work Tarea a ejecutar en un hilo de trabajo.
+	 * @return Future que recibe el resultado o la excepción de la tarea.
+	 */
+	template <typename Work>
+	std::future<std::invoke_result_t<Work>> submit(Work&& work)
+	{
+		using Result = std::invoke_result_t<Work>;
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Work>(work));
+		std::future<Result> future = task->get_future();
+
+		enqueue([task]() { (*task)(); });
+
+		return future;
+	}
+
+	/**
+	 * @brief Ejecuta en el hilo del juego las continuaciones de las tareas terminadas.
+	 *
+	 * Debe llamarse desde el tick del servidor.
+	 */
+	void poll()
+	{
+		std::vector<std::function<void()>> ready;
+		{
+			std::lock_guard<std::mutex> lock(completedMutex);
+			if (completed.empty()) return;
+			ready.swap(completed);
+		}
+
+		for (auto& continuation : ready)
+		{
+			try
+			{
+				continuation();
+			}
+			catch (const std::exception& error)
+			{
+				Log::GetLog()->error("Error en continuación de base de datos: {}", error.what());
+			}
+			catch (...)
+			{
+				Log::GetLog()->error("Error desconocido en continuación de base de datos");
+			}
+		}
+	}
+
+private:
+	AsyncDatabase() = default;
+
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable idle;
+	std::deque<std::function<void()>> jobs;
+	std::vector<std::thread> threads;
+	size_t busy = 0;
+	bool stopping = false;
+
+	std::mutex completedMutex;
+	std::vector<std::function<void()>> completed;
+
+	/**
+	 * @brief Agrega una tarea a la cola de trabajo.
+	 *
+	 * Si los hilos no están en marcha la tarea se ejecuta de inmediato en
+	 * el hilo que llama, para no perder escrituras durante la carga o la
+	 * descarga del plugin.
+	 *
+	 * @param job Tarea a encolar.
+	 */
+	void enqueue(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!threads.empty() && !stopping)
+			{
+				jobs.push_back(std::move(job));
+				jobAvailable.notify_one();
+				return;
+			}
+		}
+
+		execute(job);
+	}
+
+	/**
+	 * @brief Guarda una continuación para ejecutarla en el hilo del juego.
+	 *
+	 * @param continuation Función a ejecutar en el próximo poll().
+	 */
+	void complete(std::function<void()> continuation)
+	{
+		std::lock_guard<std::mutex> lock(completedMutex);
+		completed.push_back(std::move(continuation));
+	}
+
+	/**
+	 * @brief Ejecuta una tarea registrando cualquier excepción.
+	 *
+	 * @param job Tarea a ejecutar.
+	 */
+	void execute(std::function<void()>& job)
+	{
+		try
+		{
+			job();
+		}
+		catch (const std::exception& error)
+		{
+			Log::GetLog()->error("Error en tarea de base de datos: {}", error.what());
+		}
+		catch (...)
+		{
+			Log::GetLog()->error("Error desconocido en tarea de base de datos");
+		}
+	}
+
+	/**
+	 * @brief Bucle principal de cada hilo de trabajo.
+	 */
+	void workerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+				if (jobs.empty()) return;
+
+				job = std::move(jobs.front());
+				jobs.pop_front();
+				busy++;
+			}
+
+			execute(job);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				busy--;
+				if (jobs.empty() && busy == 0) idle.notify_all();
+			}
+		}
+	}
+};
+
+#endif // ASYNCDATABASE_H
@@ -0,0 +1,481 @@
+#ifndef CACHINGCONNECTOR_H
+#define CACHINGCONNECTOR_H
+
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ForwardingConnector.h"
+#include "QueryStats.h"
+#include <fmt/format.h>
+
+/**
+ * @struct CacheOptions
+ * @brief Tamaño y tiempos de vida de la caché de CachingConnector.
+ */
+struct CacheOptions
+{
+	size_t maxEntries = 1024;
+	std::chrono::milliseconds defaultTtl{ 5000 };
+
+	// Tiempo de vida por tabla, con el nombre en minúsculas; cero no guarda la tabla en caché
+	std::unordered_map<std::string, std::chrono::milliseconds> tableTtl;
+};
+
+/**
+ * @class CachingConnector
+ * @brief Conector que guarda en caché los resultados de las lecturas.
+ *
+ * Solo se guardan las lecturas SELECT de una sola tabla hechas fuera de
+ * una transacción. La clave es el texto de la consulta normalizado
+ * (espacios, mayúsculas) junto con sus parámetros, de modo que la misma
+ * lectura escrita de otra forma comparte la entrada. Cada entrada vence al
+ * pasar el tiempo de vida de su tabla y la caché descarta la menos usada
+ * al llegar a maxEntries.
+ *
+ * Cada tabla tiene una generación que aumenta con cada escritura a través
+ * de este conector (create, update, deleteRow, upsert o execute) y al
+ * confirmar o revertir una transacción que la escribió. Una entrada de una
+ * generación anterior ya no se usa, y una lectura que empezó antes de una
+ * escritura no guarda su resultado. Las escrituras hechas por otros
+ * programas en la misma base de datos solo se ven al vencer la entrada.
+ */
+class CachingConnector : public ForwardingConnector
+{
+public:
+	/**
+	 * @struct Stats
+	 * @brief Contadores de la caché.
+	 */
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t invalidations = 0;
+		uint64_t evictions = 0;
+		size_t entries = 0;
+	};
+
+	CachingConnector(std::shared_ptr<IDatabaseConnector> inner, CacheOptions options)
+		: ForwardingConnector(std::move(inner)), options(std::move(options))
+	{
+		if (this->options.maxEntries == 0) this->options.maxEntries = 1;
+	}
+
+	bool createTableIfNotExist(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		return written(tableName, inner->createTableIfNotExist(tableName, tableDefinition));
+	}
+
+	bool alterTableIfNotExists(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		return written(tableName, inner->alterTableIfNotExists(tableName, tableDefinition));
+	}
+
+	bool reorderColumns(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		return written(tableName, inner->reorderColumns(tableName, tableDefinition));
+	}
+
+	bool create(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data)
+	{
+		return written(tableName, inner->create(tableName, data));
+	}
+
+	bool read(const std::string& query, ResultSet& results)
+	{
+		return cachedRead(query, {}, results, [&]() { return inner->read(query, results); });
+	}
+
+	bool update(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data, const std::string& condition)
+	{
+		return written(tableName, inner->update(tableName, data, condition));
+	}
+
+	bool deleteRow(const std::string& tableName, const std::string& condition)
+	{
+		return written(tableName, inner->deleteRow(tableName, condition));
+	}
+
+	/**
+	 * @brief Ejecuta una sentencia e invalida la tabla que escribe.
+	 *
+	 * Si la sentencia no es un INSERT, UPDATE, DELETE o REPLACE con una
+	 * tabla reconocible, como una sentencia DDL, se invalida toda la caché.
+	 */
+	bool execute(const std::string& query, const DbParams& params)
+	{
+		bool success = inner->execute(query, params);
+		invalidateWrite(query);
+		return success;
+	}
+
+	bool read(const std::string& query, const DbParams& params, ResultSet& results)
+	{
+		return cachedRead(query, params, results, [&]() { return inner->read(query, params, results); });
+	}
+
+	bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns)
+	{
+		return written(tableName, inner->upsert(tableName, columns, rows, conflictKey, updateColumns));
+	}
+
+	/**
+	 * @brief Ejecuta un lote e invalida las tablas que escribe cada sentencia.
+	 */
+	bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results)
+	{
+		bool success = inner->executeBatch(statements, results);
+
+		for (const BatchStatement& statement : statements)
+		{
+			invalidateWrite(statement.query);
+		}
+
+		return success;
+	}
+
+	bool beginTransaction()
+	{
+		if (!inner->beginTransaction()) return false;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		transactions[std::this_thread::get_id()].depth++;
+		return true;
+	}
+
+	bool commit()
+	{
+		bool success = inner->commit();
+		endTransaction();
+		return success;
+	}
+
+	bool rollback()
+	{
+		bool success = inner->rollback();
+		endTransaction();
+		return success;
+	}
+
+	/**
+	 * @brief Copia de los contadores actuales.
+	 */
+	Stats stats()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		Stats result;
+		result.hits = hits;
+		result.misses = misses;
+		result.invalidations = invalidations;
+		result.evictions = evictions;
+		result.entries = entries.size();
+		return result;
+	}
+
+	/**
+	 * @brief Resumen de los contadores en una línea, para DbStats.
+	 *
+	 * @param name Nombre de la base de datos en el resumen.
+	 */
+	std::string report(const std::string& name)
+	{
+		Stats current = stats();
+		uint64_t lookups = current.hits + current.misses;
+
+		return fmt::format("caché {}: aciertos={} fallos={} tasa={:.1f}% entradas={}/{} invalidaciones={} expulsiones={}\n", name,
+			current.hits, current.misses, lookups == 0 ? 0.0 : 100.0 * current.hits / lookups,
+			current.entries, options.maxEntries, current.invalidations, current.evictions);
+	}
+
+	/**
+	 * @brief Vacía la caché sin tocar los contadores.
+	 */
+	void clear()
+	{
+		invalidateAll();
+	}
+
+private:
+	struct Entry
+	{
+		std::string key;
+		std::string table;
+		uint64_t generation;
+		std::chrono::steady_clock::time_point expiresAt;
+		ResultSet results;
+	};
+
+	/**
+	 * @struct TransactionState
+	 * @brief Profundidad y tablas escritas de la transacción abierta por un hilo.
+	 */
+	struct TransactionState
+	{
+		int depth = 0;
+		std::vector<std::string> tables;
+	};
+
+	CacheOptions options;
+
+	std::mutex mutex;
+	std::list<Entry> entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> index;
+	std::unordered_map<std::string, uint64_t> generations;
+	uint64_t epoch = 0;
+	std::unordered_map<std::thread::id, TransactionState> transactions;
+
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t invalidations = 0;
+	uint64_t evictions = 0;
+
+	static std::string lower(std::string value)
+	{
+		for (char& c : value)
+		{
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+
+		return value;
+	}
+
+	/**
+	 * @brief Clave de caché de una consulta y sus parámetros.
+	 *
+	 * Fuera de los literales pasa el texto a minúsculas, compacta los
+	 * espacios y quita los que rodean a '=', ',', '(' y ')' y el ';' final.
+	 */
+	static std::string cacheKey(std::string_view query, const DbParams& params)
+	{
+		std::string key;
+		key.reserve(query.size() + params.size() * 16);
+
+		auto isPunctuation = [](char c) { return c == '=' || c == ',' || c == '(' || c == ')'; };
+
+		for (size_t i = 0; i < query.size(); i++)
+		{
+			char c = query[i];
+
+			if (c == '\'' || c == '"')
+			{
+				size_t j = i + 1;
+				while (j < query.size())
+				{
+					if (query[j] == '\\') j++;
+					else if (query[j] == c)
+					{
+						if (j + 1 < query.size() && query[j + 1] == c) j++;
+						else break;
+					}
+					j++;
+				}
+
+				key.append(query.substr(i, std::min(j, query.size() - 1) - i + 1));
+				i = j;
+			}
+			else if (std::isspace(static_cast<unsigned char>(c)))
+			{
+				if (!key.empty() && key.back() != ' ' && !isPunctuation(key.back())) key += ' ';
+			}
+			else
+			{
+				if (isPunctuation(c) && !key.empty() && key.back() == ' ') key.pop_back();
+				key += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+			}
+		}
+
+		while (!key.empty() && (key.back() == ' ' || key.back() == ';')) key.pop_back();
+
+		for (const DbValue& param : params)
+		{
+			key += '\x1f';
+			if (std::holds_alternative<int64_t>(param)) key += 'i' + std::to_string(std::get<int64_t>(param));
+			else if (std::holds_alternative<double>(param)) key += 'd' + std::to_string(std::get<double>(param));
+			else if (std::holds_alternative<std::string>(param)) key += 's' + std::get<std::string>(param);
+			else key += 'n';
+		}
+
+		return key;
+	}
+
+	/**
+	 * @brief Lee desde la caché o desde el conector envuelto y guarda el resultado.
+	 *
+	 * @param query Consulta SQL.
+	 * @param params Parámetros de la consulta.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @param load Lectura en el conector envuelto.
+	 * @return Resultado de la lectura.
+	 */
+	template <typename Load>
+	bool cachedRead(const std::string& query, const DbParams& params, ResultSet& results, Load&& load)
+	{
+		std::string operation;
+		std::string table;
+		QueryStats::classify(query, operation, table);
+		table = lower(table);
+
+		std::chrono::milliseconds ttl = ttlFor(table);
+		if (operation != "SELECT" || table.empty() || ttl <= std::chrono::milliseconds::zero() || !cacheable(query)) return load();
+
+		std::string key = cacheKey(query, params);
+		uint64_t generation;
+		uint64_t startEpoch;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (inTransaction()) return load();
+
+			auto it = index.find(key);
+			if (it != index.end())
+			{
+				Entry& entry = *it->second;
+				if (entry.generation == generations[table] && std::chrono::steady_clock::now() < entry.expiresAt)
+				{
+					entries.splice(entries.begin(), entries, it->second);
+					results = entry.results;
+					hits++;
+					return true;
+				}
+
+				entries.erase(it->second);
+				index.erase(it);
+			}
+
+			misses++;
+			generation = generations[table];
+			startEpoch = epoch;
+		}
+
+		if (!load()) return false;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Una escritura durante la lectura hace que el resultado ya no sea seguro
+		if (generations[table] != generation || epoch != startEpoch || index.count(key) > 0) return true;
+
+		entries.push_front({ key, table, generation, std::chrono::steady_clock::now() + ttl, results });
+		index.emplace(std::move(key), entries.begin());
+
+		while (entries.size() > options.maxEntries)
+		{
+			index.erase(entries.back().key);
+			entries.pop_back();
+			evictions++;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Descarta las lecturas que dependen de más de una tabla.
+	 */
+	static bool cacheable(const std::string& query)
+	{
+		std::string text = lower(query);
+		return text.find(" join ") == std::string::npos && text.find("(select") == std::string::npos &&
+			text.find("( select") == std::string::npos && text.find(" union ") == std::string::npos;
+	}
+
+	std::chrono::milliseconds ttlFor(const std::string& table) const
+	{
+		auto it = options.tableTtl.find(table);
+		return it == options.tableTtl.end() ? options.defaultTtl : it->second;
+	}
+
+	/**
+	 * @brief Indica si el hilo actual tiene una transacción abierta; requiere el mutex.
+	 */
+	bool inTransaction() const
+	{
+		auto it = transactions.find(std::this_thread::get_id());
+		return it != transactions.end() && it->second.depth > 0;
+	}
+
+	/**
+	 * @brief Invalida una tabla después de escribirla.
+	 *
+	 * Dentro de una transacción la tabla se invalida otra vez al terminarla,
+	 * porque otro hilo pudo leer el valor anterior antes de la confirmación.
+	 *
+	 * @param table Tabla escrita.
+	 * @param success Resultado de la escritura.
+	 * @return El mismo resultado.
+	 */
+	bool written(const std::string& table, bool success)
+	{
+		std::string key = lower(table);
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		generations[key]++;
+		invalidations++;
+
+		auto it = transactions.find(std::this_thread::get_id());
+		if (it != transactions.end() && it->second.depth > 0) it->second.tables.push_back(std::move(key));
+
+		return success;
+	}
+
+	/**
+	 * @brief Invalida lo que puede haber cambiado una sentencia de texto libre.
+	 *
+	 * @param query Sentencia ejecutada.
+	 */
+	void invalidateWrite(const std::string& query)
+	{
+		std::string operation;
+		std::string table;
+		QueryStats::classify(query, operation, table);
+
+		if (operation == "SELECT") return;
+
+		if ((operation == "INSERT" || operation == "UPDATE" || operation == "DELETE" || operation == "REPLACE") && !table.empty())
+		{
+			written(table, true);
+			return;
+		}
+
+		invalidateAll();
+	}
+
+	void endTransaction()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto it = transactions.find(std::this_thread::get_id());
+		if (it == transactions.end()) return;
+
+		if (--it->second.depth > 0) return;
+
+		for (const std::string& table : it->second.tables)
+		{
+			generations[table]++;
+		}
+
+		transactions.erase(it);
+	}
+
+	void invalidateAll()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		entries.clear();
+		index.clear();
+		epoch++;
+		invalidations++;
+	}
+};
+
+#endif // CACHINGCONNECTOR_H
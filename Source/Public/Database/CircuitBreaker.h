@@ -0,0 +1,149 @@
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+
+/**
+ * @struct CircuitBreakerOptions
+ * @brief Umbral de fallos y tiempos de espera de un CircuitBreaker.
+ */
+struct CircuitBreakerOptions
+{
+	unsigned int failureThreshold = 3;
+	unsigned int baseDelayMs = 500;
+	unsigned int maxDelayMs = 30000;
+};
+
+/**
+ * @class CircuitBreaker
+ * @brief Interruptor que deja de intentar conexiones mientras el servidor no responde.
+ *
+ * Cerrado: todas las operaciones se intentan. Tras failureThreshold
+ * fallos de conexión seguidos pasa a abierto y las operaciones fallan
+ * de inmediato sin tocar la red. Cuando vence la espera pasa a
+ * semiabierto y deja pasar una sola operación de prueba: si funciona
+ * vuelve a cerrado, si falla vuelve a abierto con el doble de espera.
+ *
+ * La espera crece de forma exponencial desde baseDelayMs hasta
+ * maxDelayMs y se elige al azar entre la mitad y el total, para que
+ * varios servidores no reintenten a la vez.
+ */
+class CircuitBreaker
+{
+public:
+	enum class State
+	{
+		Closed,
+		Open,
+		HalfOpen
+	};
+
+	explicit CircuitBreaker(const CircuitBreakerOptions& options = CircuitBreakerOptions())
+		: options(options), random(std::random_device{}())
+	{
+	}
+
+	/**
+	 * @brief Indica si se puede intentar una operación.
+	 *
+	 * En estado abierto, la primera llamada después de la espera pasa a
+	 * semiabierto y recibe true; es la operación de prueba.
+	 *
+	 * @return true si se debe intentar la operación, false si debe fallar de inmediato.
+	 */
+	bool allow()
+	{
+		if (state.load(std::memory_order_acquire) == State::Closed) return true;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (state == State::Closed) return true;
+		if (std::chrono::steady_clock::now() < retryAt) return false;
+
+		// Si la prueba no informa su resultado se permite otra al vencer la espera
+		state.store(State::HalfOpen, std::memory_order_release);
+		retryAt = std::chrono::steady_clock::now() + currentDelay;
+		return true;
+	}
+
+	/**
+	 * @brief Registra que el servidor respondió.
+	 *
+	 * @return true si el interruptor estaba abierto o semiabierto y se cerró.
+	 */
+	bool success()
+	{
+		if (state.load(std::memory_order_acquire) == State::Closed && failures.load(std::memory_order_relaxed) == 0) return false;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		bool recovered = state != State::Closed;
+		state.store(State::Closed, std::memory_order_release);
+		failures.store(0, std::memory_order_relaxed);
+		attempt = 0;
+
+		return recovered;
+	}
+
+	/**
+	 * @brief Registra un fallo de conexión.
+	 *
+	 * @return Espera hasta el siguiente intento si el interruptor se abrió con este fallo, cero en caso contrario.
+	 */
+	std::chrono::milliseconds failure()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		unsigned int count = failures.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		if (state == State::Open) return std::chrono::milliseconds::zero();
+		if (state == State::Closed && count < options.failureThreshold) return std::chrono::milliseconds::zero();
+
+		currentDelay = nextDelay();
+		retryAt = std::chrono::steady_clock::now() + currentDelay;
+		state.store(State::Open, std::memory_order_release);
+
+		return currentDelay;
+	}
+
+	State current() const
+	{
+		return state.load(std::memory_order_acquire);
+	}
+
+private:
+	CircuitBreakerOptions options;
+	std::mutex mutex;
+	std::atomic<State> state{ State::Closed };
+	std::atomic<unsigned int> failures{ 0 };
+	unsigned int attempt = 0;
+	std::chrono::milliseconds currentDelay{ 0 };
+	std::chrono::steady_clock::time_point retryAt;
+	std::mt19937 random;
+
+	/**
+	 * @brief Calcula la siguiente espera con retroceso exponencial y variación aleatoria.
+	 */
+	std::chrono::milliseconds nextDelay()
+	{
+		unsigned int maxDelay = std::max(options.maxDelayMs, 1u);
+		unsigned int delay = std::max(options.baseDelayMs, 1u);
+		for (unsigned int i = 0; i < attempt && delay < maxDelay; i++)
+		{
+			delay *= 2;
+		}
+		delay = std::min(delay, maxDelay);
+		attempt++;
+
+		std::uniform_int_distribution<unsigned int> jitter(delay / 2, delay);
+		return std::chrono::milliseconds(jitter(random));
+	}
+};
+
+#endif // CIRCUITBREAKER_H
@@ -3,10 +3,20 @@
 
 #pragma once
 
+#include "CachingConnector.h"
+#include "CircuitBreaker.h"
+#include "MemoryConnector.h"
+#ifndef PLUGINTEMPLATE_NO_MYSQL
 #include "MySQLConnector.h"
+#endif
+#include "RoutingConnector.h"
 #include "SQLiteConnector.h"
 #include <json.hpp>
+#include <filesystem>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 
 /**
  * @class DatabaseFactory
@@ -14,8 +24,8 @@
  * 
  * Esta clase proporciona un método estático para crear instancias
  * de conectores de bases de datos según la configuración especificada.
- * Permite crear conectores para MySQL o SQLite dependiendo de
- * la configuración del plugin.
+ * Permite crear conectores para MySQL, SQLite o tablas en memoria
+ * dependiendo de la configuración del plugin.
  */
 class DatabaseFactory
 {
@@ -24,36 +34,284 @@ public:
 	 * @brief Crea un conector de base de datos según la configuración.
 	 * 
 	 * Este método fábrica crea una instancia del conector de base de datos
-	 * apropiado (MySQL o SQLite) basado en la configuración proporcionada.
+	 * apropiado (memoria, MySQL o SQLite) basado en la configuración proporcionada.
+	 * UseMemory tiene prioridad sobre UseMySQL. Con QueryCache.Enabled el
+	 * conector se envuelve en un CachingConnector, que también se comparte
+	 * entre las configuraciones que apuntan a la misma base de datos con las
+	 * mismas opciones de QueryCache.
+	 * 
+	 * Las configuraciones que apuntan al mismo servidor MySQL (host, puerto,
+	 * usuario y base de datos) o al mismo archivo SQLite reciben el mismo
+	 * conector mientras alguna lo siga usando; el resto de las opciones de
+	 * conexión se toman de la primera que lo creó.
+	 * 
+	 * Si el plugin se compiló con PLUGINTEMPLATE_NO_MYSQL, como la
+	 * compilación de Linux sin cliente MySQL, UseMySQL lanza una excepción.
 	 * 
 	 * @param config Configuración JSON que especifica el tipo de base de datos y sus parámetros.
-	 * @return Puntero único al conector de base de datos creado.
+	 * @return Puntero compartido al conector de base de datos creado.
 	 */
-	static std::unique_ptr<IDatabaseConnector> createConnector(const nlohmann::json config)
+	static std::shared_ptr<IDatabaseConnector> createConnector(const nlohmann::json config)
 	{
-		int sslMode = config.value("MysqlSSLMode", -1);
-		std::string tlsVersion = config.value("MysqlTLSVersion", "");
+		nlohmann::json queryCache = config.value("QueryCache", nlohmann::json::object());
+		if (queryCache.value("Enabled", false) == true)
+		{
+			// Sin QueryCache en la configuración envuelta, las réplicas no tienen su propia caché
+			nlohmann::json innerConfig = config;
+			innerConfig.erase("QueryCache");
+
+			auto create = [&]() { return std::make_shared<CachingConnector>(createConnector(innerConfig), readCacheOptions(queryCache)); };
+
+			// Los bloques que leen la misma base de datos comparten la caché, así las escrituras de uno invalidan las lecturas de todos
+			std::string dsn = connectionKey(innerConfig);
+			if (dsn.empty()) return create();
+
+			return shared(dsn + "?cache=" + queryCache.dump(), create);
+		}
+
+		size_t statementCacheSize = config.value("StatementCacheSize", 32);
+
+		if (config.value("UseMemory", false) == true)
+		{
+			return std::make_shared<MemoryConnector>(statementCacheSize);
+		}
 
 		if (config.value("UseMySQL", true) == true)
 		{	
-			return std::make_unique<MySQLConnector>(
+#ifdef PLUGINTEMPLATE_NO_MYSQL
+			throw std::runtime_error("El plugin se compiló sin el cliente MySQL; usa UseMySQL false o UseMemory.");
+#else
+			nlohmann::json replicas = config.value("Replicas", nlohmann::json::array());
+			if (replicas.is_array() && !replicas.empty())
+			{
+				return createRoutingConnector(config, replicas);
+			}
+
+			int sslMode = config.value("MysqlSSLMode", -1);
+			std::string tlsVersion = config.value("MysqlTLSVersion", "");
+			size_t poolSize = config.value("MysqlPoolSize", 4);
+			unsigned int idleValidationSeconds = config.value("MysqlPoolIdleValidationSeconds", 30);
+			unsigned int connectTimeoutSeconds = config.value("MysqlConnectTimeoutSeconds", 5);
+
+			CircuitBreakerOptions breakerOptions;
+			breakerOptions.failureThreshold = config.value("MysqlBreakerFailureThreshold", breakerOptions.failureThreshold);
+			breakerOptions.baseDelayMs = config.value("MysqlBreakerBaseDelayMs", breakerOptions.baseDelayMs);
+			breakerOptions.maxDelayMs = config.value("MysqlBreakerMaxDelayMs", breakerOptions.maxDelayMs);
+
+			return shared(connectionKey(config), [&]() { return std::make_shared<MySQLConnector>(
 				config["Host"],
 				config["User"],
 				config["Password"],
 				config["Database"],
 				config["Port"],
 				sslMode,
-				tlsVersion
-			);
+				tlsVersion,
+				statementCacheSize,
+				poolSize,
+				idleValidationSeconds,
+				connectTimeoutSeconds,
+				breakerOptions
+			); });
+#endif
 		}
 		else
 		{
-			std::string default_path = ArkApi::Tools::GetCurrentDir() + "/ArkApi/Plugins/" + PROJECT_NAME + "/" + PROJECT_NAME + ".db";
-			std::string sqlitePath = config.value("SQLiteDatabasePath","");
-			std::string db_path = (sqlitePath.empty()) ? default_path : sqlitePath;
+			std::string db_path = sqlitePath(config);
+			size_t readConnections = config.value("SQLiteReadConnections", 0);
+
+			return shared(connectionKey(config), [&]() { return std::make_shared<SQLiteConnector>(db_path, statementCacheSize,
+				readSQLiteTuning(config.value("SQLiteTuning", nlohmann::json::object())), readConnections); });
+		}
+	}
+
+	/**
+	 * @brief Identifica la base de datos a la que apunta una configuración.
+	 * 
+	 * Con réplicas la clave incluye la de cada réplica. Las tablas en
+	 * memoria no se comparten y devuelven una cadena vacía, igual que
+	 * MySQL si el plugin se compiló con PLUGINTEMPLATE_NO_MYSQL.
+	 * 
+	 * @param config Configuración de la base de datos.
+	 * @return DSN de la conexión, o una cadena vacía si no se comparte.
+	 */
+	static std::string connectionKey(const nlohmann::json& config)
+	{
+		if (config.value("UseMemory", false) == true) return "";
+
+		if (config.value("UseMySQL", true) == true)
+		{
+#ifdef PLUGINTEMPLATE_NO_MYSQL
+			return "";
+#else
+			std::string dsn = fmt::format("mysql://{}@{}:{}/{}", config["User"].get<std::string>(), lower(config["Host"].get<std::string>()),
+				config["Port"].get<int>(), config["Database"].get<std::string>());
+
+			nlohmann::json replicas = config.value("Replicas", nlohmann::json::array());
+			if (replicas.is_array())
+			{
+				nlohmann::json primaryConfig = config;
+				primaryConfig.erase("Replicas");
+
+				for (const nlohmann::json& replica : replicas)
+				{
+					nlohmann::json replicaConfig = primaryConfig;
+					replicaConfig.update(replica);
+
+					dsn += "," + connectionKey(replicaConfig);
+				}
+			}
+
+			return dsn;
+#endif
+		}
+
+		std::error_code error;
+		std::string db_path = sqlitePath(config);
+		std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(db_path, error);
+		return "sqlite://" + (error ? db_path : canonicalPath.string());
+	}
+
+	/**
+	 * @brief Ruta del archivo SQLite de una configuración.
+	 * 
+	 * @param config Configuración de la base de datos.
+	 * @return SQLiteDatabasePath, o el archivo del plugin si está vacío.
+	 */
+	static std::string sqlitePath(const nlohmann::json& config)
+	{
+		std::string path = config.value("SQLiteDatabasePath", "");
+		if (!path.empty()) return path;
+
+		return ArkApi::Tools::GetCurrentDir() + "/ArkApi/Plugins/" + PROJECT_NAME + "/" + PROJECT_NAME + ".db";
+	}
+
+	/**
+	 * @brief Crea un conector que reparte las lecturas entre las réplicas.
+	 * 
+	 * Cada elemento de Replicas reemplaza las claves de la configuración
+	 * principal que define, normalmente Host y Port, y el resto se hereda.
+	 * 
+	 * @param config Configuración del servidor principal.
+	 * @param replicas Lista de configuraciones de las réplicas.
+	 * @return Puntero compartido al conector con el principal y las réplicas.
+	 */
+	static std::shared_ptr<IDatabaseConnector> createRoutingConnector(const nlohmann::json& config, const nlohmann::json& replicas)
+	{
+		nlohmann::json primaryConfig = config;
+		primaryConfig.erase("Replicas");
+
+		std::vector<std::shared_ptr<IDatabaseConnector>> replicaConnectors;
+		for (const nlohmann::json& replica : replicas)
+		{
+			nlohmann::json replicaConfig = primaryConfig;
+			replicaConfig.update(replica);
 
-			return std::make_unique<SQLiteConnector>(db_path);
+			replicaConnectors.push_back(createConnector(replicaConfig));
 		}
+
+		return std::make_shared<RoutingConnector>(
+			createConnector(primaryConfig),
+			std::move(replicaConnectors),
+			std::chrono::seconds(config.value("ReplicaStickinessSeconds", 5))
+		);
+	}
+
+	/**
+	 * @brief Devuelve el conector abierto para un DSN o crea uno nuevo.
+	 * 
+	 * El registro solo guarda referencias débiles: la conexión se cierra
+	 * cuando el último conector que la usa se destruye. Las llamadas con
+	 * el mismo DSN esperan a que termine de conectar la primera; las de
+	 * distintos DSN conectan en paralelo.
+	 * 
+	 * @param dsn Identificador del servidor o del archivo de la conexión.
+	 * @param create Función que abre la conexión si no existe.
+	 * @return Puntero compartido al conector.
+	 */
+	template <typename Create>
+	static std::shared_ptr<IDatabaseConnector> shared(const std::string& dsn, Create&& create)
+	{
+		struct Slot
+		{
+			std::mutex mutex;
+			std::weak_ptr<IDatabaseConnector> connector;
+		};
+
+		static std::mutex registryMutex;
+		static std::unordered_map<std::string, std::shared_ptr<Slot>> slots;
+
+		std::shared_ptr<Slot> slot;
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+
+			std::shared_ptr<Slot>& entry = slots[dsn];
+			if (!entry) entry = std::make_shared<Slot>();
+			slot = entry;
+		}
+
+		std::lock_guard<std::mutex> lock(slot->mutex);
+
+		std::shared_ptr<IDatabaseConnector> connector = slot->connector.lock();
+		if (connector)
+		{
+			Log::GetLog()->info("Reutilizando la conexión a {}", dsn);
+			return connector;
+		}
+
+		connector = create();
+		slot->connector = connector;
+		return connector;
+	}
+
+	static std::string lower(std::string value)
+	{
+		std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return value;
+	}
+
+	/**
+	 * @brief Lee el bloque SQLiteTuning de la configuración.
+	 * 
+	 * Las claves ausentes conservan el perfil recomendado de SQLiteTuning.
+	 * 
+	 * @param config Bloque SQLiteTuning de la configuración de la base de datos.
+	 * @return Opciones de rendimiento para el conector SQLite.
+	 */
+	static SQLiteTuning readSQLiteTuning(const nlohmann::json& config)
+	{
+		SQLiteTuning tuning;
+
+		tuning.journalMode = config.value("JournalMode", tuning.journalMode);
+		tuning.synchronous = config.value("Synchronous", tuning.synchronous);
+		tuning.mmapSizeBytes = config.value("MmapSizeBytes", tuning.mmapSizeBytes);
+		tuning.cacheSizeKiB = config.value("CacheSizeKiB", tuning.cacheSizeKiB);
+		tuning.tempStore = config.value("TempStore", tuning.tempStore);
+		tuning.busyTimeoutMs = config.value("BusyTimeoutMs", tuning.busyTimeoutMs);
+		tuning.walCheckpointSeconds = config.value("WalCheckpointSeconds", tuning.walCheckpointSeconds);
+
+		return tuning;
+	}
+
+	/**
+	 * @brief Lee el bloque QueryCache de la configuración.
+	 * 
+	 * @param config Bloque QueryCache de la configuración de la base de datos.
+	 * @return Opciones de la caché de lecturas.
+	 */
+	static CacheOptions readCacheOptions(const nlohmann::json& config)
+	{
+		CacheOptions options;
+
+		options.maxEntries = config.value("MaxEntries", options.maxEntries);
+		options.defaultTtl = std::chrono::milliseconds(config.value("TtlMs", options.defaultTtl.count()));
+
+		nlohmann::json tableTtl = config.value("TableTtlMs", nlohmann::json::object());
+		for (auto it = tableTtl.begin(); it != tableTtl.end(); ++it)
+		{
+			options.tableTtl[lower(it.key())] = std::chrono::milliseconds(it.value().get<int64_t>());
+		}
+
+		return options;
 	}
 };
 
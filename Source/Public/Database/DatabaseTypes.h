@@ -0,0 +1,47 @@
+#ifndef DATABASETYPES_H
+#define DATABASETYPES_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * @typedef DbValue
+ * @brief Valor que se enlaza a un parámetro de una sentencia preparada.
+ *
+ * Puede ser NULL (nullptr), un entero de 64 bits, un número de punto
+ * flotante o una cadena de texto. Los valores se envían al motor de base
+ * de datos sin escapar, por lo que no es necesario llamar a escapeString.
+ */
+using DbValue = std::variant<std::nullptr_t, int64_t, double, std::string>;
+
+/**
+ * @typedef DbParams
+ * @brief Lista ordenada de parámetros para los marcadores '?' de una consulta.
+ */
+using DbParams = std::vector<DbValue>;
+
+/**
+ * @struct BatchStatement
+ * @brief Sentencia de un lote de executeBatch con sus parámetros.
+ */
+struct BatchStatement
+{
+	std::string query;
+	DbParams params;
+};
+
+/**
+ * @enum SqlDialect
+ * @brief Variante de SQL que entiende un conector.
+ */
+enum class SqlDialect
+{
+	MySQL,
+	SQLite
+};
+
+#endif // DATABASETYPES_H
@@ -0,0 +1,123 @@
+#ifndef FORWARDINGCONNECTOR_H
+#define FORWARDINGCONNECTOR_H
+
+#pragma once
+
+#include <memory>
+#include "IDatabaseConnector.h"
+
+/**
+ * @class ForwardingConnector
+ * @brief Conector que delega todas las operaciones en otro conector.
+ *
+ * Base de los conectores que envuelven a otro para cambiar solo algunas
+ * operaciones: las clases derivadas sobrescriben esas y heredan el resto.
+ */
+class ForwardingConnector : public IDatabaseConnector
+{
+public:
+	/**
+	 * @brief Constructor que comparte la propiedad del conector envuelto.
+	 *
+	 * @param inner Conector que recibe las operaciones.
+	 */
+	explicit ForwardingConnector(std::shared_ptr<IDatabaseConnector> inner)
+		: inner(std::move(inner))
+	{
+	}
+
+	bool createTableIfNotExist(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		return inner->createTableIfNotExist(tableName, tableDefinition);
+	}
+
+	bool alterTableIfNotExists(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		return inner->alterTableIfNotExists(tableName, tableDefinition);
+	}
+
+	bool reorderColumns(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		return inner->reorderColumns(tableName, tableDefinition);
+	}
+
+	bool create(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data)
+	{
+		return inner->create(tableName, data);
+	}
+
+	bool read(const std::string& query, ResultSet& results)
+	{
+		return inner->read(query, results);
+	}
+
+	bool update(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data, const std::string& condition)
+	{
+		return inner->update(tableName, data, condition);
+	}
+
+	bool deleteRow(const std::string& tableName, const std::string& condition)
+	{
+		return inner->deleteRow(tableName, condition);
+	}
+
+	bool prepare(const std::string& query)
+	{
+		return inner->prepare(query);
+	}
+
+	bool execute(const std::string& query, const DbParams& params)
+	{
+		return inner->execute(query, params);
+	}
+
+	bool read(const std::string& query, const DbParams& params, ResultSet& results)
+	{
+		return inner->read(query, params, results);
+	}
+
+	bool forEachRow(const std::string& query, const DbParams& params, const RowVisitor& visitor)
+	{
+		return inner->forEachRow(query, params, visitor);
+	}
+
+	bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns)
+	{
+		return inner->upsert(tableName, columns, rows, conflictKey, updateColumns);
+	}
+
+	bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results)
+	{
+		return inner->executeBatch(statements, results);
+	}
+
+	bool beginTransaction()
+	{
+		return inner->beginTransaction();
+	}
+
+	bool commit()
+	{
+		return inner->commit();
+	}
+
+	bool rollback()
+	{
+		return inner->rollback();
+	}
+
+	std::string escapeString(const std::string& value)
+	{
+		return inner->escapeString(value);
+	}
+
+	SqlDialect dialect() const
+	{
+		return inner->dialect();
+	}
+
+protected:
+	std::shared_ptr<IDatabaseConnector> inner;
+};
+
+#endif // FORWARDINGCONNECTOR_H
@@ -10,6 +10,9 @@
 #include <string>
 #include <vector>
 
+#include "DatabaseTypes.h"
+#include "ResultSet.h"
+
 #include <API/ARK/Ark.h> // requerido en GetLog y Log
 
 /**
@@ -78,13 +81,13 @@ public:
 	 * @brief Lee datos de la base de datos.
 	 * 
 	 * Este método ejecuta una consulta SELECT y devuelve los resultados
-	 * en un vector de mapas.
+	 * en un ResultSet.
 	 * 
 	 * @param query Consulta SQL a ejecutar.
-	 * @param results Vector donde se almacenarán los resultados.
+	 * @param results ResultSet donde se almacenarán los resultados.
 	 * @return true si la operación fue exitosa, false en caso contrario.
 	 */
-	virtual bool read(const std::string& query, std::vector<std::map<std::string,std::string>>& results) = 0;
+	virtual bool read(const std::string& query, ResultSet& results) = 0;
 
 	/**
 	 * @brief Actualiza registros en una tabla.
@@ -111,6 +114,112 @@ public:
 	 */
 	virtual bool deleteRow(const std::string& tableName, const std::string& condition) = 0;
 
+	/**
+	 * @brief Prepara una sentencia y la guarda en la caché del conector.
+	 * 
+	 * Las llamadas posteriores a execute() o read() con el mismo texto SQL
+	 * reutilizan la sentencia ya analizada por el motor de base de datos.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @return true si la sentencia se preparó correctamente, false en caso contrario.
+	 */
+	virtual bool prepare(const std::string& query) = 0;
+
+	/**
+	 * @brief Ejecuta una sentencia preparada que no devuelve filas.
+	 * 
+	 * Este método enlaza los parámetros a los marcadores '?' de la consulta
+	 * y la ejecuta. Los valores no necesitan escaparse.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	virtual bool execute(const std::string& query, const DbParams& params) = 0;
+
+	/**
+	 * @brief Lee datos usando una sentencia preparada.
+	 * 
+	 * Este método enlaza los parámetros a los marcadores '?' de la consulta
+	 * SELECT y devuelve los resultados en un ResultSet.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	virtual bool read(const std::string& query, const DbParams& params, ResultSet& results) = 0;
+
+	/**
+	 * @brief Lee datos fila por fila sin cargar todo el resultado en memoria.
+	 *
+	 * Cada fila se entrega al visitante en cuanto se recibe de la base de
+	 * datos. Si el visitante devuelve false la lectura se detiene y las
+	 * filas restantes se descartan.
+	 *
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param visitor Función que recibe cada fila.
+	 * @return true si la lectura terminó o fue detenida por el visitante, false si hubo un error.
+	 */
+	virtual bool forEachRow(const std::string& query, const DbParams& params, const RowVisitor& visitor) = 0;
+
+	/**
+	 * @brief Inserta varias filas o actualiza las que ya existen.
+	 *
+	 * Genera un INSERT de varias filas con la cláusula de conflicto nativa
+	 * de cada motor y lo divide en lotes para no superar los límites del
+	 * servidor. Todos los lotes se ejecutan en una misma transacción.
+	 *
+	 * @param tableName Nombre de la tabla.
+	 * @param columns Columnas a insertar.
+	 * @param rows Valores de cada fila, en el mismo orden que las columnas.
+	 * @param conflictKey Columna o columnas únicas que identifican una fila existente.
+	 * @param updateColumns Columnas a actualizar si la fila ya existe; si está vacío la fila existente no se modifica.
+	 * @return true si todas las filas se escribieron, false en caso contrario.
+	 */
+	virtual bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns) = 0;
+
+	/**
+	 * @brief Ejecuta varias sentencias como una unidad.
+	 *
+	 * Las sentencias se ejecutan en orden dentro de una transacción, o de
+	 * un savepoint si el hilo ya tiene una activa: si alguna falla no se
+	 * aplica ninguna. Los conectores que lo permiten envían el lote en un
+	 * solo viaje al servidor.
+	 *
+	 * @param statements Sentencias con marcadores '?' y sus parámetros.
+	 * @param results Recibe un ResultSet por sentencia, vacío si la sentencia no devuelve filas.
+	 * @return true si todas las sentencias se ejecutaron y se confirmaron, false en caso contrario.
+	 */
+	virtual bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results) = 0;
+
+	/**
+	 * @brief Inicia una transacción.
+	 *
+	 * Si el hilo ya tiene una transacción activa en este conector se crea
+	 * un savepoint, de modo que las transacciones pueden anidarse. Todas
+	 * las operaciones del hilo hasta el commit() o rollback() se ejecutan
+	 * dentro de la transacción.
+	 *
+	 * @return true si la transacción se inició, false en caso contrario.
+	 */
+	virtual bool beginTransaction() = 0;
+
+	/**
+	 * @brief Confirma la transacción o el savepoint más reciente.
+	 *
+	 * @return true si los cambios se confirmaron, false en caso contrario.
+	 */
+	virtual bool commit() = 0;
+
+	/**
+	 * @brief Revierte la transacción o el savepoint más reciente.
+	 *
+	 * @return true si los cambios se revirtieron, false en caso contrario.
+	 */
+	virtual bool rollback() = 0;
+
 	/**
 	 * @brief Escapa una cadena para prevenir inyecciones SQL.
 	 * 
@@ -122,6 +231,13 @@ public:
 	 * @return Cadena escapada y segura para usar en consultas SQL.
 	 */
 	virtual std::string escapeString(const std::string& value) = 0;
+
+	/**
+	 * @brief Indica la variante de SQL del motor de base de datos.
+	 *
+	 * @return Dialecto que deben usar las sentencias DDL y las migraciones.
+	 */
+	virtual SqlDialect dialect() const = 0;
 };
 
 
@@ -0,0 +1,1408 @@
+#ifndef MEMORYCONNECTOR_H
+#define MEMORYCONNECTOR_H
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <fmt/chrono.h>
+#include "IDatabaseConnector.h"
+#include "MemorySqlParser.h"
+#include "QueryBuilder.h"
+#include "QueryStats.h"
+#include "StatementCache.h"
+
+/**
+ * @class MemoryConnector
+ * @brief Conector que guarda las tablas en memoria, sin disco ni red.
+ *
+ * Cada tabla guarda sus filas en un vector y mantiene un índice hash por
+ * cada clave primaria, columna UNIQUE o índice creado con CREATE INDEX.
+ * Una búsqueda por igualdad sobre las columnas de un índice no recorre la
+ * tabla. Las consultas se analizan una vez con MemorySql::Parser y se
+ * guardan en caché por su texto, igual que las sentencias preparadas de
+ * los otros conectores.
+ *
+ * Entiende el SQL que genera el plugin en el dialecto de SQLite; una
+ * consulta fuera de ese subconjunto falla con un error en el log. Las
+ * transacciones y savepoints se implementan con un registro de deshacer.
+ * Los datos se pierden al cerrar el servidor.
+ */
+class MemoryConnector : public IDatabaseConnector
+{
+public:
+	/**
+	 * @brief Constructor con el tamaño de la caché de sentencias analizadas.
+	 *
+	 * @param statementCacheSize Número máximo de sentencias en caché.
+	 */
+	explicit MemoryConnector(size_t statementCacheSize = 32)
+		: statements(statementCacheSize, [](MemorySql::Statement* statement) { delete statement; })
+	{
+	}
+
+	/**
+	 * @brief Crea una tabla si no existe.
+	 *
+	 * @param tableName Nombre de la tabla a crear.
+	 * @param tableDefinition Definición de la estructura de la tabla en formato JSON.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool createTableIfNotExist(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		std::string query = "CREATE TABLE IF NOT EXISTS " + tableName + " (";
+
+		bool first = true;
+		for (auto& [columnName, dataType] : tableDefinition.items())
+		{
+			query += (first ? "" : ", ") + columnName + " " + dataType.get<std::string>();
+			first = false;
+		}
+
+		query += ")";
+
+		return executeQuery(query, {});
+	}
+
+	/**
+	 * @brief Añade las columnas de la definición que la tabla todavía no tiene.
+	 *
+	 * @param tableName Nombre de la tabla a modificar.
+	 * @param tableDefinition Definición de las columnas a añadir en formato JSON.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool alterTableIfNotExists(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		Table* table = findTable(tableName);
+		if (table == nullptr) return false;
+
+		for (auto& [columnName, dataType] : tableDefinition.items())
+		{
+			if (table->column(columnName) >= 0) continue;
+
+			if (!executeQuery("ALTER TABLE " + tableName + " ADD COLUMN " + columnName + " " + dataType.get<std::string>(), {})) return false;
+
+			// ALTER TABLE reemplaza la tabla
+			table = findTable(tableName);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Reordena las columnas de una tabla.
+	 *
+	 * No está soportado, igual que en SQLite.
+	 *
+	 * @return Siempre retorna false.
+	 */
+	bool reorderColumns(const std::string& /*tableName*/, const nlohmann::ordered_json& /*tableDefinition*/)
+	{
+		return false;
+	}
+
+	/**
+	 * @brief Crea un nuevo registro en una tabla.
+	 *
+	 * @param tableName Nombre de la tabla donde insertar el registro.
+	 * @param data Vector de pares clave-valor con los datos a insertar.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool create(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data)
+	{
+		QueryBuilder query;
+		query.append("INSERT INTO ").append(tableName).append(" (");
+
+		DbParams params;
+		params.reserve(data.size());
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			if (i > 0) query.append(", ");
+			query.append(data[i].first);
+			params.push_back(data[i].second);
+		}
+
+		query.append(") VALUES (");
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			query.append(i > 0 ? ", ?" : "?");
+		}
+
+		query.append(')');
+
+		return executeQuery(query.str(), params);
+	}
+
+	/**
+	 * @brief Lee datos de una consulta sin parámetros.
+	 *
+	 * @param query Consulta SQL a ejecutar.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool read(const std::string& query, ResultSet& results)
+	{
+		return executeQuery(query, {}, &results);
+	}
+
+	/**
+	 * @brief Actualiza registros en una tabla.
+	 *
+	 * @param tableName Nombre de la tabla a actualizar.
+	 * @param data Vector de pares clave-valor con los datos a actualizar.
+	 * @param condition Condición SQL para determinar qué registros actualizar.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool update(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data, const std::string& condition)
+	{
+		QueryBuilder query;
+		query.append("UPDATE ").append(tableName).append(" SET ");
+
+		DbParams params;
+		params.reserve(data.size());
+
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			if (i > 0) query.append(", ");
+			query.append(data[i].first).append(" = ?");
+			params.push_back(data[i].second);
+		}
+
+		query.append(" WHERE ").append(condition);
+
+		return executeQuery(query.str(), params);
+	}
+
+	/**
+	 * @brief Elimina registros de una tabla.
+	 *
+	 * @param tableName Nombre de la tabla de la cual eliminar registros.
+	 * @param condition Condición SQL para determinar qué registros eliminar.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool deleteRow(const std::string& tableName, const std::string& condition)
+	{
+		return executeQuery("DELETE FROM " + tableName + " WHERE " + condition, {});
+	}
+
+	/**
+	 * @brief Analiza una sentencia y la guarda en la caché del conector.
+	 *
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @return true si la sentencia pertenece al subconjunto soportado, false en caso contrario.
+	 */
+	bool prepare(const std::string& query)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		return acquireStatement(query) != nullptr;
+	}
+
+	/**
+	 * @brief Ejecuta una sentencia que no devuelve filas.
+	 *
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool execute(const std::string& query, const DbParams& params)
+	{
+		return executeQuery(query, params);
+	}
+
+	/**
+	 * @brief Lee datos con una sentencia parametrizada.
+	 *
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool read(const std::string& query, const DbParams& params, ResultSet& results)
+	{
+		return executeQuery(query, params, &results);
+	}
+
+	/**
+	 * @brief Lee datos fila por fila.
+	 *
+	 * La conexión queda bloqueada para otros hilos mientras dure la lectura.
+	 *
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param visitor Función que recibe cada fila.
+	 * @return true si la lectura terminó o fue detenida por el visitante, false si hubo un error.
+	 */
+	bool forEachRow(const std::string& query, const DbParams& params, const RowVisitor& visitor)
+	{
+		ResultSet row;
+		return executeQuery(query, params, &row, &visitor);
+	}
+
+	/**
+	 * @brief Inserta varias filas o actualiza las que ya existen.
+	 *
+	 * Las filas se buscan por las columnas de conflictKey con el índice que
+	 * las cubre. Todas las filas se escriben o ninguna.
+	 *
+	 * @param tableName Nombre de la tabla.
+	 * @param columns Columnas a insertar.
+	 * @param rows Valores de cada fila, en el mismo orden que las columnas.
+	 * @param conflictKey Columna o columnas, separadas por comas, de la restricción UNIQUE o PRIMARY KEY.
+	 * @param updateColumns Columnas a actualizar si la fila ya existe; si está vacío la fila existente no cambia.
+	 * @return true si todas las filas se escribieron, false en caso contrario.
+	 */
+	bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns)
+	{
+		if (rows.empty()) return true;
+
+		std::string query = "INSERT INTO " + tableName;
+		QueryTimer timer(query);
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		Table* table = findTable(tableName);
+		if (table == nullptr) return false;
+
+		std::vector<size_t> targets;
+		std::vector<size_t> keys;
+		std::vector<size_t> updates;
+		if (!resolveColumns(*table, columns, targets) || !resolveColumns(*table, splitColumns(conflictKey), keys) || !resolveColumns(*table, updateColumns, updates))
+		{
+			return false;
+		}
+
+		size_t mark = undoLog.size();
+		bool success = true;
+
+		for (size_t i = 0; i < rows.size() && success; i++)
+		{
+			if (rows[i].size() != columns.size())
+			{
+				printError(fmt::format("upsert en {}: la fila {} tiene {} valores, se esperaban {}", tableName, i, rows[i].size(), columns.size()));
+				success = false;
+				break;
+			}
+
+			Row row(table->columns.size());
+			for (size_t j = 0; j < targets.size(); j++)
+			{
+				row[targets[j]] = toText(rows[i][j]);
+			}
+
+			std::vector<std::pair<size_t, std::optional<std::string>>> conditions;
+			for (size_t key : keys)
+			{
+				conditions.emplace_back(key, row[key]);
+			}
+
+			std::vector<size_t> existing = findRows(*table, conditions, 1);
+			if (existing.empty())
+			{
+				success = insertRow(*table, std::move(row));
+			}
+			else if (!updates.empty())
+			{
+				Row updated = *table->rows[existing[0]];
+				for (size_t column : updates)
+				{
+					updated[column] = row[column];
+				}
+
+				success = storeRow(*table, existing[0], std::move(updated));
+			}
+		}
+
+		finishStatement(*table, mark, success);
+		return success;
+	}
+
+	/**
+	 * @brief Ejecuta varias sentencias en una transacción.
+	 *
+	 * @param statements Sentencias con marcadores '?' y sus parámetros.
+	 * @param results Recibe un ResultSet por sentencia, vacío si la sentencia no devuelve filas.
+	 * @return true si todas las sentencias se ejecutaron y se confirmaron, false en caso contrario.
+	 */
+	bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results)
+	{
+		results.assign(statements.size(), ResultSet());
+		if (!beginTransaction()) return false;
+
+		for (size_t i = 0; i < statements.size(); i++)
+		{
+			std::string operation;
+			std::string table;
+			QueryStats::classify(statements[i].query, operation, table);
+
+			bool success = operation == "SELECT" ? read(statements[i].query, statements[i].params, results[i]) : execute(statements[i].query, statements[i].params);
+			if (!success)
+			{
+				rollback();
+				return false;
+			}
+		}
+
+		return commit();
+	}
+
+	/**
+	 * @brief Inicia una transacción o un savepoint si ya hay una activa.
+	 *
+	 * La conexión queda bloqueada para el hilo que llama hasta el commit o
+	 * rollback correspondiente, igual que en SQLiteConnector.
+	 *
+	 * @return true si la transacción se inició.
+	 */
+	bool beginTransaction()
+	{
+		mutex.lock();
+
+		savepoints.push_back(undoLog.size());
+		return true;
+	}
+
+	/**
+	 * @brief Confirma la transacción o libera el savepoint más reciente.
+	 *
+	 * @return true si los cambios se confirmaron, false si no había transacción.
+	 */
+	bool commit()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		if (savepoints.empty())
+		{
+			Log::GetLog()->error("No hay ninguna transacción en memoria activa");
+			return false;
+		}
+
+		savepoints.pop_back();
+		if (savepoints.empty()) undoLog.clear();
+
+		mutex.unlock(); // bloqueo tomado en beginTransaction
+		return true;
+	}
+
+	/**
+	 * @brief Revierte la transacción o los cambios desde el savepoint más reciente.
+	 *
+	 * @return true si los cambios se revirtieron, false si no había transacción.
+	 */
+	bool rollback()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		if (savepoints.empty())
+		{
+			Log::GetLog()->error("No hay ninguna transacción en memoria activa");
+			return false;
+		}
+
+		undoTo(savepoints.back());
+		savepoints.pop_back();
+
+		mutex.unlock(); // bloqueo tomado en beginTransaction
+		return true;
+	}
+
+	/**
+	 * @brief Escapa una cadena con las reglas de SQLite.
+	 *
+	 * @param value Cadena a escapar.
+	 * @return Cadena escapada y segura para usar en consultas SQL.
+	 */
+	std::string escapeString(const std::string& value)
+	{
+		QueryBuilder escaped;
+		escaped.appendEscaped(value);
+
+		return escaped.str();
+	}
+
+	/**
+	 * @brief Indica la variante de SQL del conector.
+	 *
+	 * Las migraciones y el esquema tipado se generan con la sintaxis de SQLite.
+	 *
+	 * @return SqlDialect::SQLite.
+	 */
+	SqlDialect dialect() const
+	{
+		return SqlDialect::SQLite;
+	}
+
+private:
+	using Row = std::vector<std::optional<std::string>>;
+
+	/**
+	 * @struct Index
+	 * @brief Índice hash de una o varias columnas.
+	 *
+	 * Las filas con NULL en alguna columna del índice no se indexan, por lo
+	 * que un índice UNIQUE admite varios NULL, como en SQL.
+	 */
+	struct Index
+	{
+		std::vector<size_t> columns;
+		bool unique = false;
+		std::unordered_map<std::string, std::vector<size_t>> entries;
+	};
+
+	/**
+	 * @struct Table
+	 * @brief Columnas, filas e índices de una tabla.
+	 *
+	 * Las filas eliminadas dejan un hueco en el vector para que las
+	 * posiciones guardadas en los índices y en el registro de deshacer
+	 * sigan siendo válidas; los huecos se compactan fuera de las transacciones.
+	 */
+	struct Table
+	{
+		std::string name;
+		std::vector<MemorySql::ColumnDef> columns;
+		std::unordered_map<std::string, size_t> columnIndexes;
+		std::vector<std::optional<Row>> rows;
+		size_t liveRows = 0;
+		int64_t sequence = 0;
+		std::vector<Index> indexes;
+
+		int column(std::string_view name) const
+		{
+			auto it = columnIndexes.find(MemorySql::lower(name));
+			return it == columnIndexes.end() ? -1 : static_cast<int>(it->second);
+		}
+	};
+
+	/**
+	 * @struct Undo
+	 * @brief Entrada del registro de deshacer: una fila o una tabla completa.
+	 */
+	struct Undo
+	{
+		std::string table;
+		bool schema = false;
+		std::shared_ptr<Table> previousTable;
+		size_t slot = 0;
+		std::optional<Row> previousRow;
+		int64_t sequence = 0;
+	};
+
+	static constexpr size_t COMPACT_MIN_DEAD_ROWS = 1024;
+
+	std::recursive_mutex mutex;
+	StatementCache<MemorySql::Statement*> statements;
+	std::unordered_map<std::string, std::shared_ptr<Table>> tables;
+	std::vector<Undo> undoLog;
+	std::vector<size_t> savepoints;
+
+	void printError(const std::string& message)
+	{
+		Log::GetLog()->error("Error en la base de datos en memoria: {}", message);
+	}
+
+	/**
+	 * @brief Obtiene una sentencia analizada de la caché o la analiza.
+	 *
+	 * @param query Texto de la consulta.
+	 * @return La sentencia, o nullptr si no pertenece al subconjunto soportado.
+	 */
+	MemorySql::Statement* acquireStatement(const std::string& query)
+	{
+		MemorySql::Statement* statement = statements.find(query);
+		if (statement != nullptr) return statement;
+
+		auto parsed = std::make_unique<MemorySql::Statement>();
+		std::string error;
+		if (!MemorySql::Parser::parse(query, *parsed, error))
+		{
+			printError(error + ": " + query);
+			return nullptr;
+		}
+
+		statement = parsed.release();
+		statements.insert(query, statement);
+		return statement;
+	}
+
+	/**
+	 * @brief Ejecuta una consulta y deshace sus cambios si falla a mitad.
+	 *
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param results ResultSet de una lectura, o nullptr.
+	 * @param visitor Función que recibe cada fila de una lectura, o nullptr.
+	 * @return true si la consulta se ejecutó, false en caso contrario.
+	 */
+	bool executeQuery(const std::string& query, const DbParams& params, ResultSet* results = nullptr, const RowVisitor* visitor = nullptr)
+	{
+		QueryTimer timer(query);
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		MemorySql::Statement* statement = acquireStatement(query);
+		if (statement == nullptr) return false;
+
+		if (params.size() != statement->paramCount)
+		{
+			Log::GetLog()->error("La sentencia en memoria espera {} parámetros, recibió {}", statement->paramCount, params.size());
+			return false;
+		}
+
+		switch (statement->kind)
+		{
+		case MemorySql::Kind::Begin:
+			return beginTransaction();
+		case MemorySql::Kind::Commit:
+			return commit();
+		case MemorySql::Kind::Rollback:
+			return rollback();
+		case MemorySql::Kind::CreateTable:
+			return createTable(*statement);
+		case MemorySql::Kind::DropTable:
+			return dropTable(*statement);
+		default:
+			break;
+		}
+
+		// El catálogo se arma en cada consulta; solo se usa para comprobar si una tabla existe
+		if (statement->kind == MemorySql::Kind::Select && MemorySql::lower(statement->table) == "sqlite_master")
+		{
+			if (results != nullptr) results->clear();
+			return select(catalog(), *statement, params, results, visitor);
+		}
+
+		Table* table = findTable(statement->table);
+		if (table == nullptr) return false;
+
+		if (statement->kind == MemorySql::Kind::Select)
+		{
+			if (results != nullptr) results->clear();
+			return select(*table, *statement, params, results, visitor);
+		}
+
+		size_t mark = undoLog.size();
+		bool success = false;
+
+		switch (statement->kind)
+		{
+		case MemorySql::Kind::CreateIndex:
+			success = createIndex(*table, *statement);
+			break;
+		case MemorySql::Kind::AlterTable:
+			success = alterTable(*table, *statement);
+			break;
+		case MemorySql::Kind::Insert:
+			success = insert(*table, *statement, params);
+			break;
+		case MemorySql::Kind::Update:
+			success = update(*table, *statement, params);
+			break;
+		case MemorySql::Kind::Delete:
+			success = remove(*table, *statement, params);
+			break;
+		default:
+			break;
+		}
+
+		// CREATE INDEX y ALTER TABLE reemplazan la tabla
+		table = findTable(statement->table);
+		if (table != nullptr) finishStatement(*table, mark, success);
+		return success;
+	}
+
+	/**
+	 * @brief Deshace una sentencia fallida y, fuera de una transacción, descarta el registro.
+	 */
+	void finishStatement(Table& table, size_t mark, bool success)
+	{
+		if (!success) undoTo(mark);
+		if (!savepoints.empty()) return;
+
+		undoLog.clear();
+
+		size_t deadRows = table.rows.size() - table.liveRows;
+		if (deadRows >= COMPACT_MIN_DEAD_ROWS && deadRows > table.liveRows) compact(table);
+	}
+
+	/**
+	 * @brief Tabla sqlite_master con el tipo y el nombre de cada tabla, como en SQLite.
+	 */
+	Table catalog() const
+	{
+		Table table;
+		table.name = "sqlite_master";
+
+		for (const char* name : { "type", "name" })
+		{
+			MemorySql::ColumnDef column;
+			column.name = name;
+			table.columnIndexes[column.name] = table.columns.size();
+			table.columns.push_back(std::move(column));
+		}
+
+		for (const auto& [key, entry] : tables)
+		{
+			table.rows.push_back(Row{ std::string("table"), entry->name });
+		}
+		table.liveRows = table.rows.size();
+
+		return table;
+	}
+
+	Table* findTable(const std::string& name)
+	{
+		auto it = tables.find(MemorySql::lower(name));
+		if (it == tables.end())
+		{
+			printError("no existe la tabla " + name);
+			return nullptr;
+		}
+
+		return it->second.get();
+	}
+
+	/**
+	 * @brief Reemplaza una tabla guardando la anterior en el registro de deshacer.
+	 *
+	 * @param name Nombre de la tabla.
+	 * @param table Nueva tabla, o nullptr para eliminarla.
+	 */
+	void replaceTable(const std::string& name, std::shared_ptr<Table> table)
+	{
+		std::string key = MemorySql::lower(name);
+
+		Undo undo;
+		undo.table = key;
+		undo.schema = true;
+
+		auto it = tables.find(key);
+		if (it != tables.end()) undo.previousTable = it->second;
+		undoLog.push_back(std::move(undo));
+
+		if (table)
+		{
+			tables[key] = std::move(table);
+		}
+		else
+		{
+			tables.erase(key);
+		}
+	}
+
+	bool resolveColumns(const Table& table, const std::vector<std::string>& names, std::vector<size_t>& columns)
+	{
+		columns.clear();
+		columns.reserve(names.size());
+
+		for (const std::string& name : names)
+		{
+			int column = table.column(name);
+			if (column < 0)
+			{
+				printError("no existe la columna " + name + " en " + table.name);
+				return false;
+			}
+
+			columns.push_back(static_cast<size_t>(column));
+		}
+
+		return true;
+	}
+
+	static std::vector<std::string> splitColumns(const std::string& list)
+	{
+		std::vector<std::string> names;
+
+		size_t start = 0;
+		while (start <= list.size())
+		{
+			size_t end = std::min(list.find(',', start), list.size());
+			std::string name = list.substr(start, end - start);
+			name.erase(0, name.find_first_not_of(" \t"));
+			name.erase(name.find_last_not_of(" \t") + 1);
+			if (!name.empty()) names.push_back(std::move(name));
+
+			start = end + 1;
+		}
+
+		return names;
+	}
+
+	/**
+	 * @brief Convierte un parámetro al texto que se guarda en la tabla.
+	 */
+	static std::optional<std::string> toText(const DbValue& value)
+	{
+		if (std::holds_alternative<int64_t>(value)) return std::to_string(std::get<int64_t>(value));
+		if (std::holds_alternative<std::string>(value)) return std::get<std::string>(value);
+
+		if (std::holds_alternative<double>(value))
+		{
+			char buffer[32];
+			auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), std::get<double>(value));
+			return std::string(buffer, end);
+		}
+
+		return std::nullopt;
+	}
+
+	static std::optional<std::string> resolve(const MemorySql::Operand& operand, const DbParams& params)
+	{
+		return operand.isParam ? toText(params[operand.param]) : operand.literal;
+	}
+
+	static std::string now()
+	{
+		return fmt::format("{:%Y-%m-%d %H:%M:%S}", fmt::gmtime(std::time(nullptr)));
+	}
+
+	/**
+	 * @brief Clave de una fila en un índice.
+	 *
+	 * @return La clave, o std::nullopt si alguna columna del índice es NULL.
+	 */
+	static std::optional<std::string> indexKey(const Index& index, const Row& row)
+	{
+		if (index.columns.size() == 1) return row[index.columns[0]];
+
+		std::string key;
+		for (size_t column : index.columns)
+		{
+			if (!row[column]) return std::nullopt;
+
+			key += *row[column];
+			key += '\x1f';
+		}
+
+		return key;
+	}
+
+	static void addToIndex(Index& index, const Row& row, size_t slot)
+	{
+		std::optional<std::string> key = indexKey(index, row);
+		if (key) index.entries[*key].push_back(slot);
+	}
+
+	static void removeFromIndex(Index& index, const Row& row, size_t slot)
+	{
+		std::optional<std::string> key = indexKey(index, row);
+		if (!key) return;
+
+		auto it = index.entries.find(*key);
+		if (it == index.entries.end()) return;
+
+		std::vector<size_t>& slots = it->second;
+		slots.erase(std::remove(slots.begin(), slots.end(), slot), slots.end());
+		if (slots.empty()) index.entries.erase(it);
+	}
+
+	/**
+	 * @brief Comprueba que una fila no repite la clave de un índice UNIQUE en otra posición.
+	 */
+	bool checkUnique(const Table& table, const Row& row, size_t slot)
+	{
+		for (const Index& index : table.indexes)
+		{
+			if (!index.unique) continue;
+
+			std::optional<std::string> key = indexKey(index, row);
+			if (!key) continue;
+
+			auto it = index.entries.find(*key);
+			if (it == index.entries.end()) continue;
+
+			for (size_t other : it->second)
+			{
+				if (other != slot)
+				{
+					printError("restricción UNIQUE incumplida en " + table.name + "." + table.columns[index.columns[0]].name);
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool checkNotNull(const Table& table, const Row& row)
+	{
+		for (size_t i = 0; i < table.columns.size(); i++)
+		{
+			if (table.columns[i].notNull && !row[i])
+			{
+				printError("restricción NOT NULL incumplida en " + table.name + "." + table.columns[i].name);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Escribe, reemplaza o elimina la fila de una posición y actualiza los índices.
+	 *
+	 * @param table Tabla de la fila.
+	 * @param slot Posición de la fila; rows.size() añade una fila nueva.
+	 * @param row Nueva fila, o std::nullopt para eliminarla.
+	 * @return true si la fila cumple las restricciones y se guardó.
+	 */
+	bool storeRow(Table& table, size_t slot, std::optional<Row> row)
+	{
+		if (row && (!checkNotNull(table, *row) || !checkUnique(table, *row, slot))) return false;
+
+		if (slot == table.rows.size()) table.rows.emplace_back();
+
+		Undo undo;
+		undo.table = MemorySql::lower(table.name);
+		undo.slot = slot;
+		undo.previousRow = table.rows[slot];
+		undo.sequence = table.sequence;
+		undoLog.push_back(std::move(undo));
+
+		setRow(table, slot, std::move(row));
+		return true;
+	}
+
+	static void setRow(Table& table, size_t slot, std::optional<Row> row)
+	{
+		std::optional<Row>& current = table.rows[slot];
+
+		if (current)
+		{
+			for (Index& index : table.indexes) removeFromIndex(index, *current, slot);
+			table.liveRows--;
+		}
+
+		current = std::move(row);
+
+		if (current)
+		{
+			for (Index& index : table.indexes) addToIndex(index, *current, slot);
+			table.liveRows++;
+		}
+	}
+
+	/**
+	 * @brief Completa una fila nueva con los valores generados y la añade.
+	 */
+	bool insertRow(Table& table, Row row)
+	{
+		int64_t sequence = table.sequence;
+
+		for (size_t i = 0; i < table.columns.size(); i++)
+		{
+			const MemorySql::ColumnDef& column = table.columns[i];
+
+			if (column.autoIncrement)
+			{
+				if (!row[i])
+				{
+					row[i] = std::to_string(++sequence);
+				}
+				else
+				{
+					int64_t value = 0;
+					auto [end, error] = std::from_chars(row[i]->data(), row[i]->data() + row[i]->size(), value);
+					if (error == std::errc()) sequence = std::max(sequence, value);
+				}
+			}
+			else if (!row[i])
+			{
+				if (column.defaultNow) row[i] = now();
+				else if (column.defaultValue) row[i] = column.defaultValue;
+			}
+		}
+
+		if (!storeRow(table, table.rows.size(), std::move(row))) return false;
+
+		// La secuencia anterior queda en el registro de deshacer
+		table.sequence = sequence;
+		return true;
+	}
+
+	/**
+	 * @brief Busca las filas que cumplen todas las igualdades.
+	 *
+	 * Usa un índice si sus columnas están todas en las condiciones; si no,
+	 * recorre la tabla.
+	 *
+	 * @param table Tabla donde buscar.
+	 * @param conditions Pares de columna y valor; un valor NULL no coincide con ninguna fila.
+	 * @param limit Número máximo de filas, 0 para todas.
+	 * @return Posiciones de las filas encontradas.
+	 */
+	std::vector<size_t> findRows(const Table& table, const std::vector<std::pair<size_t, std::optional<std::string>>>& conditions, size_t limit)
+	{
+		std::vector<size_t> found;
+
+		for (const auto& [column, value] : conditions)
+		{
+			if (!value) return found;
+		}
+
+		auto matches = [&](size_t slot)
+		{
+			const std::optional<Row>& row = table.rows[slot];
+			if (!row) return false;
+
+			for (const auto& [column, value] : conditions)
+			{
+				if ((*row)[column] != value) return false;
+			}
+
+			return true;
+		};
+
+		for (const Index& index : table.indexes)
+		{
+			Row key(table.columns.size());
+			bool covered = true;
+
+			for (size_t column : index.columns)
+			{
+				auto it = std::find_if(conditions.begin(), conditions.end(), [column](const auto& condition) { return condition.first == column; });
+				if (it == conditions.end())
+				{
+					covered = false;
+					break;
+				}
+
+				key[column] = it->second;
+			}
+
+			if (!covered) continue;
+
+			auto entry = index.entries.find(*indexKey(index, key));
+			if (entry == index.entries.end()) return found;
+
+			for (size_t slot : entry->second)
+			{
+				if (!matches(slot)) continue;
+
+				found.push_back(slot);
+				if (found.size() == limit) break;
+			}
+
+			std::sort(found.begin(), found.end());
+			return found;
+		}
+
+		for (size_t slot = 0; slot < table.rows.size(); slot++)
+		{
+			if (!matches(slot)) continue;
+
+			found.push_back(slot);
+			if (found.size() == limit) break;
+		}
+
+		return found;
+	}
+
+	/**
+	 * @brief Busca las filas de la cláusula WHERE de una sentencia.
+	 */
+	bool matchRows(const Table& table, const MemorySql::Statement& statement, const DbParams& params, std::vector<size_t>& slots)
+	{
+		std::vector<std::pair<size_t, std::optional<std::string>>> conditions;
+		std::vector<std::pair<size_t, std::optional<std::string>>> minimums;
+
+		for (const MemorySql::Condition& condition : statement.where)
+		{
+			int column = table.column(condition.column);
+			if (column < 0)
+			{
+				printError("no existe la columna " + condition.column + " en " + table.name);
+				return false;
+			}
+
+			(condition.atLeast ? minimums : conditions).emplace_back(static_cast<size_t>(column), resolve(condition.value, params));
+		}
+
+		slots = findRows(table, conditions, minimums.empty() ? statement.limit.value_or(0) : 0);
+		if (minimums.empty()) return true;
+
+		// Como en SQL, una comparación con NULL no se cumple
+		slots.erase(std::remove_if(slots.begin(), slots.end(), [&](size_t slot)
+		{
+			for (const auto& [column, minimum] : minimums)
+			{
+				const std::optional<std::string>& value = (*table.rows[slot])[column];
+				if (!value || !minimum || std::atof(value->c_str()) < std::atof(minimum->c_str())) return true;
+			}
+
+			return false;
+		}), slots.end());
+
+		if (statement.limit && slots.size() > *statement.limit) slots.resize(*statement.limit);
+		return true;
+	}
+
+	/**
+	 * @brief Crea los índices de una tabla a partir de sus definiciones.
+	 */
+	bool addIndexes(Table& table, const std::vector<MemorySql::IndexDef>& definitions)
+	{
+		for (const MemorySql::IndexDef& definition : definitions)
+		{
+			Index index;
+			index.unique = definition.unique;
+			if (!resolveColumns(table, definition.columns, index.columns)) return false;
+
+			auto existing = std::find_if(table.indexes.begin(), table.indexes.end(), [&](const Index& other) { return other.columns == index.columns; });
+			if (existing != table.indexes.end())
+			{
+				if (!index.unique || existing->unique) continue;
+
+				// Un índice UNIQUE reemplaza a uno normal de las mismas columnas
+				table.indexes.erase(existing);
+			}
+
+			for (size_t slot = 0; slot < table.rows.size(); slot++)
+			{
+				if (!table.rows[slot]) continue;
+
+				std::optional<std::string> key = indexKey(index, *table.rows[slot]);
+				if (!key) continue;
+
+				std::vector<size_t>& slots = index.entries[*key];
+				if (index.unique && !slots.empty())
+				{
+					printError("valores repetidos al crear un índice UNIQUE en " + table.name);
+					return false;
+				}
+
+				slots.push_back(slot);
+			}
+
+			table.indexes.push_back(std::move(index));
+		}
+
+		return true;
+	}
+
+	bool createTable(const MemorySql::Statement& statement)
+	{
+		if (tables.count(MemorySql::lower(statement.table)) > 0)
+		{
+			if (statement.ifExists) return true;
+
+			printError("la tabla " + statement.table + " ya existe");
+			return false;
+		}
+
+		auto table = std::make_shared<Table>();
+		table->name = statement.table;
+
+		for (const MemorySql::ColumnDef& column : statement.definitions)
+		{
+			if (!table->columnIndexes.emplace(MemorySql::lower(column.name), table->columns.size()).second)
+			{
+				printError("columna repetida " + column.name + " en " + statement.table);
+				return false;
+			}
+
+			table->columns.push_back(column);
+		}
+
+		if (!addIndexes(*table, statement.indexes)) return false;
+
+		replaceTable(statement.table, std::move(table));
+		if (savepoints.empty()) undoLog.clear();
+		return true;
+	}
+
+	bool dropTable(const MemorySql::Statement& statement)
+	{
+		if (tables.count(MemorySql::lower(statement.table)) == 0)
+		{
+			if (statement.ifExists) return true;
+
+			printError("no existe la tabla " + statement.table);
+			return false;
+		}
+
+		replaceTable(statement.table, nullptr);
+		if (savepoints.empty()) undoLog.clear();
+		return true;
+	}
+
+	bool createIndex(const Table& table, const MemorySql::Statement& statement)
+	{
+		auto copy = std::make_shared<Table>(table);
+		if (!addIndexes(*copy, statement.indexes)) return false;
+
+		replaceTable(statement.table, std::move(copy));
+		return true;
+	}
+
+	bool alterTable(const Table& table, const MemorySql::Statement& statement)
+	{
+		auto copy = std::make_shared<Table>(table);
+
+		for (const MemorySql::ColumnDef& column : statement.definitions)
+		{
+			if (!copy->columnIndexes.emplace(MemorySql::lower(column.name), copy->columns.size()).second)
+			{
+				printError("columna repetida " + column.name + " en " + table.name);
+				return false;
+			}
+
+			copy->columns.push_back(column);
+
+			std::optional<std::string> value = column.defaultNow ? std::optional<std::string>(now()) : column.defaultValue;
+			for (std::optional<Row>& row : copy->rows)
+			{
+				if (row) row->push_back(value);
+			}
+
+			if (column.notNull && !value && copy->liveRows > 0)
+			{
+				printError("no se puede añadir la columna NOT NULL " + column.name + " sin valor por defecto");
+				return false;
+			}
+		}
+
+		if (!addIndexes(*copy, statement.indexes)) return false;
+
+		replaceTable(statement.table, std::move(copy));
+		return true;
+	}
+
+	bool insert(Table& table, const MemorySql::Statement& statement, const DbParams& params)
+	{
+		std::vector<size_t> targets;
+		if (statement.columns.empty())
+		{
+			for (size_t i = 0; i < table.columns.size(); i++) targets.push_back(i);
+		}
+		else if (!resolveColumns(table, statement.columns, targets))
+		{
+			return false;
+		}
+
+		for (const std::vector<MemorySql::Operand>& values : statement.values)
+		{
+			if (values.size() != targets.size())
+			{
+				printError(fmt::format("INSERT en {} con {} valores para {} columnas", table.name, values.size(), targets.size()));
+				return false;
+			}
+
+			Row row(table.columns.size());
+			for (size_t i = 0; i < targets.size(); i++)
+			{
+				row[targets[i]] = resolve(values[i], params);
+			}
+
+			if (!insertRow(table, std::move(row))) return false;
+		}
+
+		return true;
+	}
+
+	bool select(const Table& table, const MemorySql::Statement& statement, const DbParams& params, ResultSet* results, const RowVisitor* visitor)
+	{
+		std::vector<size_t> columns;
+		if (statement.columns.empty())
+		{
+			for (size_t i = 0; i < table.columns.size(); i++) columns.push_back(i);
+		}
+		else if (!resolveColumns(table, statement.columns, columns))
+		{
+			return false;
+		}
+
+		std::vector<size_t> slots;
+		if (!matchRows(table, statement, params, slots)) return false;
+		if (results == nullptr) return true;
+
+		std::vector<std::string> names;
+		names.reserve(columns.size());
+		for (size_t column : columns)
+		{
+			names.push_back(table.columns[column].name);
+		}
+		results->setColumns(std::move(names));
+
+		if (visitor == nullptr) results->reserve(slots.size());
+
+		for (size_t slot : slots)
+		{
+			const Row& row = *table.rows[slot];
+			for (size_t column : columns)
+			{
+				if (row[column])
+				{
+					if (!results->addValue(row[column]->data(), row[column]->size()))
+					{
+						printError("el resultado supera el tamaño máximo de un ResultSet");
+						return false;
+					}
+				}
+				else
+				{
+					results->addNull();
+				}
+			}
+
+			if (visitor != nullptr)
+			{
+				if (!(*visitor)(*results)) return true;
+				results->clearRows();
+			}
+		}
+
+		return true;
+	}
+
+	bool update(Table& table, const MemorySql::Statement& statement, const DbParams& params)
+	{
+		std::vector<size_t> columns;
+		if (!resolveColumns(table, statement.columns, columns)) return false;
+
+		std::vector<size_t> slots;
+		if (!matchRows(table, statement, params, slots)) return false;
+
+		for (size_t slot : slots)
+		{
+			Row row = *table.rows[slot];
+			for (size_t i = 0; i < columns.size(); i++)
+			{
+				if (!assign(table, *table.rows[slot], statement.values[0][i], params, row[columns[i]])) return false;
+			}
+
+			if (!storeRow(table, slot, std::move(row))) return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Calcula el valor de una columna en SET, incluida la forma "columna ± valor".
+	 *
+	 * Como en SQL, sumar a NULL da NULL y el texto no numérico cuenta como 0.
+	 *
+	 * @param table Tabla actualizada.
+	 * @param row Fila antes de la actualización.
+	 * @param operand Valor de SET.
+	 * @param params Parámetros de la sentencia.
+	 * @param value Recibe el valor nuevo.
+	 * @return false si la columna de la expresión no existe.
+	 */
+	bool assign(const Table& table, const Row& row, const MemorySql::Operand& operand, const DbParams& params, std::optional<std::string>& value)
+	{
+		value = resolve(operand, params);
+		if (!operand.column) return true;
+
+		int column = table.column(*operand.column);
+		if (column < 0)
+		{
+			printError("no existe la columna " + *operand.column + " en " + table.name);
+			return false;
+		}
+
+		const std::optional<std::string>& current = row[column] ? row[column] : operand.columnDefault;
+		if (!current || !value)
+		{
+			value = std::nullopt;
+			return true;
+		}
+
+		int64_t left = 0;
+		int64_t right = 0;
+		bool integers = std::from_chars(current->data(), current->data() + current->size(), left).ptr == current->data() + current->size()
+			&& std::from_chars(value->data(), value->data() + value->size(), right).ptr == value->data() + value->size();
+
+		if (integers)
+		{
+			value = std::to_string(operand.subtract ? left - right : left + right);
+		}
+		else
+		{
+			double result = operand.subtract ? std::atof(current->c_str()) - std::atof(value->c_str()) : std::atof(current->c_str()) + std::atof(value->c_str());
+			value = toText(DbValue(result));
+		}
+
+		return true;
+	}
+
+	bool remove(Table& table, const MemorySql::Statement& statement, const DbParams& params)
+	{
+		std::vector<size_t> slots;
+		if (!matchRows(table, statement, params, slots)) return false;
+
+		for (size_t slot : slots)
+		{
+			storeRow(table, slot, std::nullopt);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Deshace en orden inverso las entradas del registro posteriores a una marca.
+	 */
+	void undoTo(size_t mark)
+	{
+		while (undoLog.size() > mark)
+		{
+			Undo& undo = undoLog.back();
+
+			if (undo.schema)
+			{
+				if (undo.previousTable)
+				{
+					tables[undo.table] = std::move(undo.previousTable);
+				}
+				else
+				{
+					tables.erase(undo.table);
+				}
+			}
+			else
+			{
+				Table& table = *tables[undo.table];
+				setRow(table, undo.slot, std::move(undo.previousRow));
+				table.sequence = undo.sequence;
+			}
+
+			undoLog.pop_back();
+		}
+	}
+
+	/**
+	 * @brief Elimina los huecos de las filas borradas y reconstruye los índices.
+	 */
+	static void compact(Table& table)
+	{
+		std::vector<std::optional<Row>> rows;
+		rows.reserve(table.liveRows);
+
+		for (std::optional<Row>& row : table.rows)
+		{
+			if (row) rows.push_back(std::move(row));
+		}
+
+		table.rows = std::move(rows);
+
+		for (Index& index : table.indexes)
+		{
+			index.entries.clear();
+			for (size_t slot = 0; slot < table.rows.size(); slot++)
+			{
+				addToIndex(index, *table.rows[slot], slot);
+			}
+		}
+	}
+};
+
+#endif // MEMORYCONNECTOR_H
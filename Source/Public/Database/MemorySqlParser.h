@@ -0,0 +1,832 @@
+#ifndef MEMORYSQLPARSER_H
+#define MEMORYSQLPARSER_H
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace MemorySql
+ * @brief Subconjunto de SQL que entiende MemoryConnector.
+ *
+ * Cubre las sentencias que genera el plugin: CREATE TABLE, CREATE INDEX,
+ * ALTER TABLE ... ADD COLUMN, DROP TABLE, INSERT ... VALUES, SELECT con
+ * columnas o '*', UPDATE y DELETE con condiciones de igualdad o '>=' unidas
+ * por AND, LIMIT, y BEGIN, COMMIT y ROLLBACK. Los valores pueden ser
+ * marcadores '?', cadenas, números o NULL.
+ */
+namespace MemorySql
+{
+	/**
+	 * @struct Operand
+	 * @brief Valor de una sentencia: un marcador '?' o un literal.
+	 */
+	struct Operand
+	{
+		bool isParam = false;
+		size_t param = 0;
+		std::optional<std::string> literal;
+
+		// En SET de UPDATE, columna de la fila a la que se suma o resta el valor,
+		// como en Points = COALESCE(Points, 0) - ?
+		std::optional<std::string> column;
+		std::optional<std::string> columnDefault;
+		bool subtract = false;
+	};
+
+	/**
+	 * @struct Condition
+	 * @brief Comparación de una cláusula WHERE: igualdad, o '>=' numérico si atLeast.
+	 */
+	struct Condition
+	{
+		std::string column;
+		Operand value;
+		bool atLeast = false;
+	};
+
+	/**
+	 * @struct ColumnDef
+	 * @brief Columna declarada en CREATE TABLE o ALTER TABLE.
+	 */
+	struct ColumnDef
+	{
+		std::string name;
+		bool notNull = false;
+		bool primaryKey = false;
+		bool unique = false;
+		bool autoIncrement = false;
+		bool defaultNow = false;
+		std::optional<std::string> defaultValue;
+	};
+
+	/**
+	 * @struct IndexDef
+	 * @brief Índice declarado en CREATE TABLE o con CREATE INDEX.
+	 */
+	struct IndexDef
+	{
+		std::vector<std::string> columns;
+		bool unique = false;
+	};
+
+	enum class Kind
+	{
+		CreateTable,
+		CreateIndex,
+		AlterTable,
+		DropTable,
+		Insert,
+		Select,
+		Update,
+		Delete,
+		Begin,
+		Commit,
+		Rollback
+	};
+
+	/**
+	 * @struct Statement
+	 * @brief Sentencia ya analizada; se guarda en caché por su texto.
+	 */
+	struct Statement
+	{
+		Kind kind = Kind::Select;
+		std::string table;
+		bool ifExists = false;
+
+		std::vector<ColumnDef> definitions;
+		std::vector<IndexDef> indexes;
+
+		// Columnas de INSERT, SELECT (vacío para '*') o SET de UPDATE
+		std::vector<std::string> columns;
+
+		// Filas de INSERT; UPDATE usa una sola fila con los valores de SET
+		std::vector<std::vector<Operand>> values;
+
+		std::vector<Condition> where;
+		std::optional<size_t> limit;
+		size_t paramCount = 0;
+	};
+
+	/**
+	 * @brief Compara sin distinguir mayúsculas, como las palabras clave y los nombres de SQL.
+	 */
+	inline bool iequals(std::string_view a, std::string_view b)
+	{
+		if (a.size() != b.size()) return false;
+
+		for (size_t i = 0; i < a.size(); i++)
+		{
+			if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+		}
+
+		return true;
+	}
+
+	inline std::string lower(std::string_view text)
+	{
+		std::string result(text);
+		for (char& c : result)
+		{
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+
+		return result;
+	}
+
+	/**
+	 * @class Parser
+	 * @brief Analizador descendente del subconjunto de SQL.
+	 */
+	class Parser
+	{
+	public:
+		/**
+		 * @brief Analiza una sentencia.
+		 *
+		 * @param sql Texto de la sentencia.
+		 * @param statement Sentencia analizada.
+		 * @param error Motivo del fallo si la sentencia no se entiende.
+		 * @return true si la sentencia pertenece al subconjunto soportado.
+		 */
+		static bool parse(std::string_view sql, Statement& statement, std::string& error)
+		{
+			Parser parser;
+			if (!parser.tokenize(sql, error)) return false;
+
+			if (!parser.statement(statement))
+			{
+				error = parser.error;
+				return false;
+			}
+
+			return true;
+		}
+
+	private:
+		enum class TokenType
+		{
+			Word,
+			Identifier,
+			String,
+			Number,
+			Param,
+			Symbol,
+			End
+		};
+
+		struct Token
+		{
+			TokenType type;
+			std::string text;
+		};
+
+		std::vector<Token> tokens;
+		size_t position = 0;
+		size_t params = 0;
+		std::string error;
+
+		bool tokenize(std::string_view sql, std::string& failure)
+		{
+			size_t i = 0;
+			while (i < sql.size())
+			{
+				char c = sql[i];
+
+				if (std::isspace(static_cast<unsigned char>(c)))
+				{
+					i++;
+				}
+				else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+				{
+					size_t start = i;
+					while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_' || sql[i] == '$')) i++;
+					tokens.push_back({ TokenType::Word, std::string(sql.substr(start, i - start)) });
+				}
+				else if (c == '`' || c == '"' || c == '[')
+				{
+					char close = c == '[' ? ']' : c;
+					size_t end = sql.find(close, i + 1);
+					if (end == std::string_view::npos)
+					{
+						failure = "identificador sin cerrar";
+						return false;
+					}
+
+					tokens.push_back({ TokenType::Identifier, std::string(sql.substr(i + 1, end - i - 1)) });
+					i = end + 1;
+				}
+				else if (c == '\'')
+				{
+					std::string text;
+					i++;
+					while (true)
+					{
+						if (i >= sql.size())
+						{
+							failure = "cadena sin cerrar";
+							return false;
+						}
+
+						if (sql[i] == '\'')
+						{
+							if (i + 1 < sql.size() && sql[i + 1] == '\'')
+							{
+								text += '\'';
+								i += 2;
+								continue;
+							}
+
+							i++;
+							break;
+						}
+
+						text += sql[i++];
+					}
+
+					tokens.push_back({ TokenType::String, std::move(text) });
+				}
+				else if (std::isdigit(static_cast<unsigned char>(c)) || ((c == '-' || c == '+') && i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1])) && unary()))
+				{
+					size_t start = i++;
+					while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) i++;
+					tokens.push_back({ TokenType::Number, std::string(sql.substr(c == '+' ? start + 1 : start, i - (c == '+' ? start + 1 : start))) });
+				}
+				else if (c == '?')
+				{
+					tokens.push_back({ TokenType::Param, "?" });
+					i++;
+				}
+				else if (c == '(' || c == ')' || c == ',' || c == '=' || c == '>' || c == '*' || c == ';' || c == '.' || c == '+' || c == '-')
+				{
+					tokens.push_back({ TokenType::Symbol, std::string(1, c) });
+					i++;
+				}
+				else
+				{
+					failure = "carácter no soportado '" + std::string(1, c) + "'";
+					return false;
+				}
+			}
+
+			tokens.push_back({ TokenType::End, "" });
+			return true;
+		}
+
+		/**
+		 * @brief Indica si un signo en la posición actual es un signo de número y no un operador.
+		 */
+		bool unary() const
+		{
+			return tokens.empty() || tokens.back().type == TokenType::Symbol || tokens.back().type == TokenType::Word;
+		}
+
+		const Token& peek(size_t offset = 0) const
+		{
+			return tokens[std::min(position + offset, tokens.size() - 1)];
+		}
+
+		bool fail(const std::string& message)
+		{
+			if (error.empty())
+			{
+				error = message + (peek().type == TokenType::End ? " al final de la sentencia" : " cerca de '" + peek().text + "'");
+			}
+
+			return false;
+		}
+
+		bool isKeyword(std::string_view keyword, size_t offset = 0) const
+		{
+			return peek(offset).type == TokenType::Word && iequals(peek(offset).text, keyword);
+		}
+
+		bool accept(std::string_view keyword)
+		{
+			if (!isKeyword(keyword)) return false;
+
+			position++;
+			return true;
+		}
+
+		bool expect(std::string_view keyword)
+		{
+			return accept(keyword) || fail("se esperaba " + std::string(keyword));
+		}
+
+		bool acceptSymbol(char symbol)
+		{
+			if (peek().type != TokenType::Symbol || peek().text[0] != symbol) return false;
+
+			position++;
+			return true;
+		}
+
+		bool expectSymbol(char symbol)
+		{
+			return acceptSymbol(symbol) || fail("se esperaba '" + std::string(1, symbol) + "'");
+		}
+
+		bool identifier(std::string& name)
+		{
+			if (peek().type != TokenType::Word && peek().type != TokenType::Identifier) return fail("se esperaba un nombre");
+
+			name = tokens[position++].text;
+			return true;
+		}
+
+		/**
+		 * @brief Lee un nombre de tabla, descartando el prefijo de base de datos.
+		 */
+		bool tableName(std::string& name)
+		{
+			if (!identifier(name)) return false;
+
+			if (acceptSymbol('.')) return identifier(name);
+			return true;
+		}
+
+		bool operand(Operand& value)
+		{
+			const Token& token = peek();
+
+			switch (token.type)
+			{
+			case TokenType::Param:
+				value.isParam = true;
+				value.param = params++;
+				break;
+			case TokenType::String:
+			case TokenType::Number:
+				value.literal = token.text;
+				break;
+			case TokenType::Word:
+				if (iequals(token.text, "NULL")) break;
+				if (iequals(token.text, "TRUE")) { value.literal = "1"; break; }
+				if (iequals(token.text, "FALSE")) { value.literal = "0"; break; }
+				return fail("valor no soportado");
+			default:
+				return fail("se esperaba un valor");
+			}
+
+			position++;
+			return true;
+		}
+
+		/**
+		 * @brief Valor de SET: un valor, o una columna más o menos un valor.
+		 *
+		 * La columna puede ir dentro de COALESCE(columna, literal).
+		 */
+		bool assignment(Operand& value)
+		{
+			bool coalesce = isKeyword("COALESCE") && peek(1).type == TokenType::Symbol && peek(1).text[0] == '(';
+			bool column = (peek().type == TokenType::Word && !isKeyword("NULL") && !isKeyword("TRUE") && !isKeyword("FALSE")) || peek().type == TokenType::Identifier;
+			if (!coalesce && !column) return operand(value);
+
+			std::string name;
+			if (coalesce)
+			{
+				position += 2;
+
+				Operand fallback;
+				if (!identifier(name) || !expectSymbol(',') || !operand(fallback) || !expectSymbol(')')) return false;
+				if (fallback.isParam) return fail("COALESCE con un marcador no soportado");
+
+				value.columnDefault = fallback.literal;
+			}
+			else if (!identifier(name))
+			{
+				return false;
+			}
+
+			value.column = std::move(name);
+
+			// "Points - 5" llega como el número -5
+			if (peek().type == TokenType::Number)
+			{
+				std::string number = tokens[position++].text;
+				value.subtract = number[0] == '-';
+				value.literal = value.subtract ? number.substr(1) : number;
+				return true;
+			}
+
+			if (acceptSymbol('-'))
+			{
+				value.subtract = true;
+			}
+			else if (!acceptSymbol('+'))
+			{
+				return fail("se esperaba '+' o '-'");
+			}
+
+			return operand(value);
+		}
+
+		/**
+		 * @brief Lista de nombres entre paréntesis.
+		 */
+		bool nameList(std::vector<std::string>& names)
+		{
+			if (!expectSymbol('(')) return false;
+
+			do
+			{
+				std::string name;
+				if (!identifier(name)) return false;
+				names.push_back(std::move(name));
+			} while (acceptSymbol(','));
+
+			return expectSymbol(')');
+		}
+
+		bool whereClause(Statement& statement)
+		{
+			if (!accept("WHERE")) return true;
+
+			do
+			{
+				Condition condition;
+				if (!identifier(condition.column)) return false;
+
+				// Se acepta tabla.columna
+				if (acceptSymbol('.') && !identifier(condition.column)) return false;
+
+				condition.atLeast = acceptSymbol('>');
+				if (!expectSymbol('=') || !operand(condition.value)) return false;
+				statement.where.push_back(std::move(condition));
+			} while (accept("AND"));
+
+			return true;
+		}
+
+		bool limitClause(Statement& statement)
+		{
+			if (!accept("LIMIT")) return true;
+
+			if (peek().type != TokenType::Number) return fail("se esperaba un número");
+
+			statement.limit = static_cast<size_t>(std::stoull(tokens[position++].text));
+			return true;
+		}
+
+		bool statement(Statement& statement)
+		{
+			bool success;
+
+			if (accept("BEGIN") || accept("START"))
+			{
+				statement.kind = Kind::Begin;
+				while (peek().type == TokenType::Word) position++;
+				success = true;
+			}
+			else if (accept("COMMIT") || accept("END"))
+			{
+				statement.kind = Kind::Commit;
+				accept("TRANSACTION");
+				success = true;
+			}
+			else if (accept("ROLLBACK"))
+			{
+				statement.kind = Kind::Rollback;
+				accept("TRANSACTION");
+				success = true;
+			}
+			else if (accept("CREATE"))
+			{
+				success = create(statement);
+			}
+			else if (accept("ALTER"))
+			{
+				success = alter(statement);
+			}
+			else if (accept("DROP"))
+			{
+				statement.kind = Kind::DropTable;
+				success = expect("TABLE") && ifExists(statement, false) && tableName(statement.table);
+			}
+			else if (accept("INSERT"))
+			{
+				success = insert(statement);
+			}
+			else if (accept("SELECT"))
+			{
+				success = select(statement);
+			}
+			else if (accept("UPDATE"))
+			{
+				success = update(statement);
+			}
+			else if (accept("DELETE"))
+			{
+				statement.kind = Kind::Delete;
+				success = expect("FROM") && tableName(statement.table) && whereClause(statement) && limitClause(statement);
+			}
+			else
+			{
+				success = fail("sentencia no soportada");
+			}
+
+			if (!success) return false;
+
+			acceptSymbol(';');
+			if (peek().type != TokenType::End) return fail("texto inesperado");
+
+			statement.paramCount = params;
+			return true;
+		}
+
+		/**
+		 * @brief Lee IF EXISTS o IF NOT EXISTS.
+		 */
+		bool ifExists(Statement& statement, bool negated)
+		{
+			if (!accept("IF")) return true;
+			if (negated && !expect("NOT")) return false;
+			if (!expect("EXISTS")) return false;
+
+			statement.ifExists = true;
+			return true;
+		}
+
+		bool create(Statement& statement)
+		{
+			bool unique = accept("UNIQUE");
+
+			if (accept("INDEX"))
+			{
+				statement.kind = Kind::CreateIndex;
+
+				std::string indexName;
+				IndexDef index;
+				index.unique = unique;
+
+				if (!ifExists(statement, true) || !identifier(indexName) || !expect("ON") || !tableName(statement.table) || !nameList(index.columns)) return false;
+
+				statement.indexes.push_back(std::move(index));
+				return true;
+			}
+
+			if (unique) return fail("se esperaba INDEX");
+
+			statement.kind = Kind::CreateTable;
+			if (!expect("TABLE") || !ifExists(statement, true) || !tableName(statement.table) || !expectSymbol('(')) return false;
+
+			do
+			{
+				if (!definition(statement)) return false;
+			} while (acceptSymbol(','));
+
+			if (!expectSymbol(')')) return false;
+
+			// Opciones de tabla como ENGINE=InnoDB
+			while (peek().type != TokenType::End && !(peek().type == TokenType::Symbol && peek().text == ";")) position++;
+
+			return true;
+		}
+
+		bool alter(Statement& statement)
+		{
+			statement.kind = Kind::AlterTable;
+			if (!expect("TABLE") || !tableName(statement.table)) return false;
+
+			do
+			{
+				if (!expect("ADD")) return false;
+				accept("COLUMN");
+
+				if (!definition(statement)) return false;
+			} while (acceptSymbol(','));
+
+			return true;
+		}
+
+		/**
+		 * @brief Lee una columna o una restricción de tabla.
+		 */
+		bool definition(Statement& statement)
+		{
+			bool primary = isKeyword("PRIMARY");
+			bool unique = isKeyword("UNIQUE");
+
+			if (primary || unique || isKeyword("KEY") || isKeyword("INDEX"))
+			{
+				IndexDef index;
+				index.unique = primary || unique;
+
+				position++;
+				accept("KEY");
+				accept("INDEX");
+				if (peek().type != TokenType::Symbol)
+				{
+					std::string indexName;
+					if (!identifier(indexName)) return false;
+				}
+
+				if (!nameList(index.columns)) return false;
+
+				if (primary && index.columns.size() == 1)
+				{
+					for (ColumnDef& column : statement.definitions)
+					{
+						if (iequals(column.name, index.columns[0])) column.primaryKey = true;
+					}
+				}
+
+				statement.indexes.push_back(std::move(index));
+				return true;
+			}
+
+			if (isKeyword("CONSTRAINT") || isKeyword("FOREIGN") || isKeyword("CHECK"))
+			{
+				return skipDefinition();
+			}
+
+			ColumnDef column;
+			if (!identifier(column.name)) return false;
+
+			std::string type = peek().type == TokenType::Word ? peek().text : "";
+
+			while (!(peek().type == TokenType::Symbol && (peek().text == "," || peek().text == ")")) && peek().type != TokenType::End)
+			{
+				if (accept("PRIMARY"))
+				{
+					if (!expect("KEY")) return false;
+					column.primaryKey = true;
+					accept("ASC");
+					accept("DESC");
+				}
+				else if (accept("NOT"))
+				{
+					if (!expect("NULL")) return false;
+					column.notNull = true;
+				}
+				else if (accept("UNIQUE"))
+				{
+					column.unique = true;
+					accept("KEY");
+				}
+				else if (accept("AUTOINCREMENT") || accept("AUTO_INCREMENT"))
+				{
+					column.autoIncrement = true;
+				}
+				else if (accept("DEFAULT"))
+				{
+					if (accept("CURRENT_TIMESTAMP"))
+					{
+						column.defaultNow = true;
+					}
+					else if (acceptSymbol('('))
+					{
+						if (!skipParentheses()) return false;
+					}
+					else
+					{
+						Operand value;
+						if (!operand(value)) return false;
+						column.defaultValue = value.literal;
+					}
+				}
+				else if (acceptSymbol('('))
+				{
+					if (!skipParentheses()) return false;
+				}
+				else
+				{
+					position++;
+				}
+			}
+
+			// Igual que en SQLite, INTEGER PRIMARY KEY es un alias del rowid
+			if (column.primaryKey && iequals(type, "INTEGER")) column.autoIncrement = true;
+
+			if (column.primaryKey || column.unique)
+			{
+				statement.indexes.push_back({ { column.name }, true });
+			}
+
+			statement.definitions.push_back(std::move(column));
+			return true;
+		}
+
+		bool skipDefinition()
+		{
+			while (!(peek().type == TokenType::Symbol && (peek().text == "," || peek().text == ")")) && peek().type != TokenType::End)
+			{
+				if (acceptSymbol('('))
+				{
+					if (!skipParentheses()) return false;
+				}
+				else
+				{
+					position++;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * @brief Salta hasta el paréntesis que cierra el que ya se leyó.
+		 */
+		bool skipParentheses()
+		{
+			int depth = 1;
+			while (depth > 0)
+			{
+				if (peek().type == TokenType::End) return fail("paréntesis sin cerrar");
+
+				if (acceptSymbol('('))
+				{
+					depth++;
+				}
+				else if (acceptSymbol(')'))
+				{
+					depth--;
+				}
+				else
+				{
+					position++;
+				}
+			}
+
+			return true;
+		}
+
+		bool insert(Statement& statement)
+		{
+			statement.kind = Kind::Insert;
+			if (!expect("INTO") || !tableName(statement.table)) return false;
+
+			if (peek().type == TokenType::Symbol && peek().text == "(" && !nameList(statement.columns)) return false;
+
+			if (!expect("VALUES")) return false;
+
+			do
+			{
+				if (!expectSymbol('(')) return false;
+
+				std::vector<Operand> row;
+				do
+				{
+					Operand value;
+					if (!operand(value)) return false;
+					row.push_back(std::move(value));
+				} while (acceptSymbol(','));
+
+				if (!expectSymbol(')')) return false;
+				statement.values.push_back(std::move(row));
+			} while (acceptSymbol(','));
+
+			return true;
+		}
+
+		bool select(Statement& statement)
+		{
+			statement.kind = Kind::Select;
+
+			if (!acceptSymbol('*'))
+			{
+				do
+				{
+					std::string column;
+					if (!identifier(column)) return false;
+					if (acceptSymbol('.') && !identifier(column)) return false;
+					statement.columns.push_back(std::move(column));
+				} while (acceptSymbol(','));
+			}
+
+			return expect("FROM") && tableName(statement.table) && whereClause(statement) && limitClause(statement);
+		}
+
+		bool update(Statement& statement)
+		{
+			statement.kind = Kind::Update;
+			if (!tableName(statement.table) || !expect("SET")) return false;
+
+			std::vector<Operand> row;
+			do
+			{
+				std::string column;
+				Operand value;
+				if (!identifier(column) || !expectSymbol('=') || !assignment(value)) return false;
+
+				statement.columns.push_back(std::move(column));
+				row.push_back(std::move(value));
+			} while (acceptSymbol(','));
+
+			statement.values.push_back(std::move(row));
+
+			return whereClause(statement) && limitClause(statement);
+		}
+	};
+}
+
+#endif // MEMORYSQLPARSER_H
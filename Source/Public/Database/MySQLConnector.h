@@ -3,8 +3,23 @@
 
 #pragma once
 
+#include <mysql/errmsg.h>
 #include <mysql/mysql.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "CircuitBreaker.h"
 #include "IDatabaseConnector.h"
+#include "NonblockingPoller.h"
+#include "QueryBuilder.h"
+#include "QueryStats.h"
+#include "StatementCache.h"
 
 
 #pragma comment(lib,"mysqlclient.lib")
@@ -17,10 +32,33 @@
  * proporcionar funcionalidad de conexión y operaciones con
  * bases de datos MySQL. Gestiona la conexión, ejecución de
  * consultas y procesamiento de resultados.
+ * 
+ * Mantiene un pool de conexiones: cada operación toma una conexión
+ * libre y la devuelve al terminar, por lo que varias consultas de los
+ * hilos de AsyncDatabase pueden ejecutarse a la vez.
+ * 
+ * Los fallos de conexión abren un CircuitBreaker: mientras el servidor
+ * no responde las operaciones fallan de inmediato en lugar de esperar
+ * el tiempo de conexión, y los reintentos se espacian con retroceso
+ * exponencial.
+ * 
+ * startQuery() ofrece además un modo no bloqueante para el hilo del juego:
+ * la consulta avanza con las funciones *_nonblocking del cliente MySQL en
+ * cada tick del servidor y su continuación se ejecuta al terminar.
  */
-class MySQLConnector : public IDatabaseConnector
+class MySQLConnector : public IDatabaseConnector, public std::enable_shared_from_this<MySQLConnector>
 {
 public:
+	/**
+	 * @brief Continuación de una consulta no bloqueante.
+	 * 
+	 * Recibe si la consulta tuvo éxito, sus filas, vacías si no devolvió
+	 * ninguna, y las filas que cambió un INSERT, UPDATE o DELETE.
+	 */
+	using QueryCallback = std::function<void(bool success, ResultSet& results, uint64_t affectedRows)>;
+
+	class PendingQuery;
+
 	/**
 	 * @brief Constructor que inicializa la conexión a MySQL.
 	 * 
@@ -34,25 +72,34 @@ public:
 	 * @param port Puerto del servidor MySQL.
 	 * @param ssl_mode Modo SSL para la conexión.
 	 * @param tls_version Versión TLS a utilizar.
+	 * @param statementCacheSize Número máximo de sentencias preparadas a conservar por conexión.
+	 * @param poolSize Número máximo de conexiones abiertas a la vez.
+	 * @param idleValidationSeconds Segundos de inactividad tras los cuales una conexión se valida con mysql_ping antes de usarse.
+	 * @param connectTimeoutSeconds Tiempo máximo para establecer una conexión; 0 usa el del cliente MySQL.
+	 * @param breakerOptions Umbral de fallos y esperas del circuito de reconexión.
 	 */
-	MySQLConnector(const std::string& host, const std::string& user, const std::string& password, const std::string& dbname, unsigned int port, int ssl_mode, const std::string& tls_version)
+	MySQLConnector(const std::string& host, const std::string& user, const std::string& password, const std::string& dbname, unsigned int port, int ssl_mode, const std::string& tls_version, size_t statementCacheSize = 32, size_t poolSize = 4, unsigned int idleValidationSeconds = 30,
+		unsigned int connectTimeoutSeconds = 5, const CircuitBreakerOptions& breakerOptions = CircuitBreakerOptions())
+		: _host(host), _user(user), _password(password), _dbname(dbname), _port(port), _ssl_mode(ssl_mode), _tls_version(tls_version),
+		_statementCacheSize(statementCacheSize), _poolSize(poolSize > 0 ? poolSize : 1), _idleValidation(std::chrono::seconds(idleValidationSeconds)),
+		_connectTimeout(connectTimeoutSeconds), breaker(breakerOptions)
 	{
-		if (!MySQLConnect()) return;
+		// Se abre la primera conexión para detectar errores de configuración al iniciar
+		ConnectionLease connection = acquire();
 	}
 
 	/**
-	 * @brief Destructor que cierra la conexión a MySQL.
+	 * @brief Destructor que cierra las conexiones a MySQL.
 	 * 
 	 * Este destructor se asegura de cerrar adecuadamente
-	 * la conexión a la base de datos MySQL al destruir
+	 * todas las conexiones del pool al destruir
 	 * la instancia del conector.
 	 */
 	~MySQLConnector()
 	{
-		if (conn != nullptr)
-		{
-			mysql_close(conn);
-		}
+		std::lock_guard<std::mutex> lock(poolMutex);
+		idle.clear();
+		pinned.clear();
 	}
 
 	/**
@@ -67,6 +114,9 @@ public:
 	 */
 	bool createTableIfNotExist(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
 	{
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
 		std::string query = "CREATE TABLE IF NOT EXISTS " + tableName + "(";
 
 		bool first = true;
@@ -82,7 +132,7 @@ public:
 
 		query += ")";
 
-		return executeQuery(query);
+		return executeQuery(*connection, query);
 	}
 
 	/**
@@ -97,6 +147,9 @@ public:
 	 */
 	bool alterTableIfNotExists(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
 	{
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
 		std::string query = "ALTER TABLE " + tableName + " ";
 
 		bool first = true;
@@ -112,7 +165,7 @@ public:
 
 		query += ";";
 
-		return executeQuery(query);
+		return executeQuery(*connection, query);
 	}
 
 	/**
@@ -127,6 +180,9 @@ public:
 	 */
 	bool reorderColumns(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
 	{
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
 		std::string query = "ALTER TABLE " + tableName + " ";
 
 		bool first = true;
@@ -145,7 +201,7 @@ public:
 			prev_column = columnName;
 		}
 
-		return executeQuery(query);
+		return executeQuery(*connection, query);
 	}
 
 	/**
@@ -160,70 +216,61 @@ public:
 	 */
 	bool create(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data)
 	{
-		std::string query = "INSERT INTO " + tableName + " (";
-		std::string values = " VALUES (";
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		QueryBuilder query;
+		query.append("INSERT INTO ").append(tableName).append(" (");
 
 		for (size_t i = 0; i < data.size(); i++)
 		{
-			query += data[i].first;
-			values += "'" + escapeString(data[i].second) + "'";
-			if (i < data.size() - 1)
-			{
-				query += ", ";
-				values += ", ";
-			}
+			if (i > 0) query.append(", ");
+			query.append(data[i].first);
+		}
+
+		query.append(") VALUES (");
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			if (i > 0) query.append(", ");
+			appendQuoted(query, *connection, data[i].second);
 		}
 
-		query += ") " + values + ")";
+		query.append(')');
 
-		return executeQuery(query);
+		return executeQuery(*connection, query.view());
 	}
 
 	/**
 	 * @brief Lee datos de la base de datos MySQL.
 	 * 
 	 * Este método ejecuta una consulta SELECT en la base de datos MySQL
-	 * y devuelve los resultados en un vector de mapas.
+	 * y devuelve los resultados en un ResultSet.
 	 * 
 	 * @param query Consulta SQL a ejecutar.
-	 * @param results Vector donde se almacenarán los resultados.
+	 * @param results ResultSet donde se almacenarán los resultados.
 	 * @return true si la operación fue exitosa, false en caso contrario.
 	 */
-	bool read(const std::string& query, std::vector<std::map<std::string, std::string>>& results)
+	bool read(const std::string& query, ResultSet& results)
 	{
-		if (!executeQuery(query)) return false;
+		QueryTimer timer(query);
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
 
-		result = mysql_store_result(conn);
+		if (!executeQuery(*connection, query)) return false;
+
+		MYSQL_RES* result = mysql_store_result(connection->handle);
 		if (result == nullptr)
 		{
-			printError("Fallo al almacenar resultados");
+			printError(*connection, "Fallo al almacenar resultados");
 			return false;
 		}
 
-		int num_fields = mysql_num_fields(result);
-
-		MYSQL_ROW row;
-		MYSQL_FIELD* fields = mysql_fetch_fields(result);
-
-		while (true)
-		{
-			row = mysql_fetch_row(result);
-			if (!row) break;
-
-			std::map<std::string, std::string> rowData;
-
-			for (int i = 0; i < num_fields; i++)
-			{
-				std::string column_name = fields[i].name;
-				rowData[column_name] = row[i] ? row[i] : "NULL";
-			}
-
-			results.push_back(rowData);
-		}
+		bool success = fetchRows(result, results);
 
 		mysql_free_result(result);
 
-		return true;
+		return success;
 	}
 
 	/**
@@ -239,20 +286,22 @@ public:
 	 */
 	bool update(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data, const std::string& condition)
 	{
-		std::string query = "UPDATE " + tableName + " SET ";
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		QueryBuilder query;
+		query.append("UPDATE ").append(tableName).append(" SET ");
 
 		for (size_t i = 0; i < data.size(); ++i)
 		{
-			query += data[i].first + " = '" + escapeString(data[i].second) + "'";
-			if (i < data.size() - 1)
-			{
-				query += ", ";
-			}
+			if (i > 0) query.append(", ");
+			query.append(data[i].first).append(" = ");
+			appendQuoted(query, *connection, data[i].second);
 		}
 
-		query += " WHERE " + condition;
+		query.append(" WHERE ").append(condition);
 
-		return executeQuery(query);
+		return executeQuery(*connection, query.view());
 	}
 
 	/**
@@ -267,144 +316,1795 @@ public:
 	 */
 	bool deleteRow(const std::string& tableName, const std::string& condition)
 	{
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
 		std::string query = "DELETE FROM " + tableName + " WHERE " + condition;
 
-		return executeQuery(query);
+		return executeQuery(*connection, query);
 	}
 
 
 	/**
-	 * @brief Escapa una cadena para prevenir inyecciones SQL.
+	 * @brief Prepara una sentencia y la guarda en la caché del conector.
 	 * 
-	 * Este método procesa una cadena para hacerla segura
-	 * para su uso en consultas SQL de MySQL, utilizando
-	 * la función mysql_real_escape_string.
+	 * La sentencia se prepara en el servidor con mysql_stmt_prepare y se
+	 * reutiliza en las siguientes llamadas con el mismo texto SQL.
 	 * 
-	 * @param value Cadena a escapar.
-	 * @return Cadena escapada y segura para usar en consultas SQL.
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @return true si la sentencia se preparó correctamente, false en caso contrario.
 	 */
-	std::string escapeString(const std::string& value)
+	bool prepare(const std::string& query)
 	{
-		char* escaped = new char[value.length() * 2 + 1];
-		mysql_real_escape_string(conn, escaped, value.c_str(), value.length());
-		std::string escapeStr(escaped);
-		delete[] escaped;
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		MYSQL_STMT* stmt = acquireStatement(*connection, query);
+		if (stmt == nullptr) return false;
 
-		return escapeStr;
+		releaseStatement(*connection, query, stmt);
+		return true;
 	}
 
-private:
-	MYSQL* conn;
-	MYSQL_RES* result;
-	std::string _host;
-	std::string _user;
-	std::string _password;
-	std::string _dbname;
-	unsigned int _port;
-	int _ssl_mode;
-	std::string _tls_version;
+	/**
+	 * @brief Ejecuta una sentencia preparada que no devuelve filas.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool execute(const std::string& query, const DbParams& params)
+	{
+		return execute(query, params, true);
+	}
 
 	/**
-	 * @brief Configura las opciones SSL para la conexión MySQL.
+	 * @brief Ejecuta una sentencia que no devuelve filas, dentro o fuera de la caché.
 	 * 
-	 * Este método configura las opciones SSL/TLS para la conexión
-	 * a la base de datos MySQL según los parámetros especificados.
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param cache false para preparar la sentencia y cerrarla después sin guardarla.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool execute(const std::string& query, const DbParams& params, bool cache)
+	{
+		QueryTimer timer(query);
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		MYSQL_STMT* stmt = executeStatement(*connection, query, params, cache);
+		if (stmt == nullptr) return false;
+
+		releaseStatement(*connection, query, stmt);
+		return true;
+	}
+
+	/**
+	 * @brief Lee datos usando una sentencia preparada.
 	 * 
-	 * @param ssl_mode Modo SSL a configurar.
-	 * @param tls_version Versión TLS a utilizar.
+	 * Todas las columnas se reciben como texto para conservar el mismo
+	 * formato que devuelve read() con una consulta sin parámetros.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @return true si la operación fue exitosa, false en caso contrario.
 	 */
-	void configureSSL(int ssl_mode, const std::string& tls_version)
+	bool read(const std::string& query, const DbParams& params, ResultSet& results)
 	{
-		if (ssl_mode >= 0 && ssl_mode <= 4)
+		QueryTimer timer(query);
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		MYSQL_STMT* stmt = executeStatement(*connection, query, params);
+		if (stmt == nullptr) return false;
+
+		bool success = fetchStatementRows(stmt, results);
+		releaseStatement(*connection, query, stmt);
+		return success;
+	}
+
+	/**
+	 * @brief Lee datos fila por fila sin almacenar el resultado completo.
+	 * 
+	 * Sin parámetros la consulta se envía como texto y se lee con
+	 * mysql_use_result; con parámetros se usa una sentencia preparada sin
+	 * mysql_stmt_store_result. En ambos casos el cliente solo guarda la fila
+	 * actual. La conexión del pool queda ocupada hasta terminar la lectura,
+	 * por lo que con un pool de tamaño 1 el visitante no debe usar este
+	 * conector. Lo mismo ocurre dentro de una transacción: la conexión está
+	 * fijada al hilo y las operaciones del visitante con este conector
+	 * fallan con un error en lugar de mezclarse con la lectura en curso.
+	 * Si el visitante se detiene antes, las filas restantes se descartan al
+	 * liberar el resultado.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param visitor Función que recibe cada fila.
+	 * @return true si la lectura terminó o fue detenida por el visitante, false si hubo un error.
+	 */
+	bool forEachRow(const std::string& query, const DbParams& params, const RowVisitor& visitor)
+	{
+		QueryTimer timer(query);
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		ResultSet row;
+
+		if (!params.empty())
 		{
-			mysql_options(conn, MYSQL_OPT_SSL_MODE, &ssl_mode);
+			MYSQL_STMT* stmt = executeStatement(*connection, query, params);
+			if (stmt == nullptr) return false;
+
+			connection->streaming = true;
+			bool success = fetchStatementRows(stmt, row, &visitor);
+			connection->streaming = false;
+
+			releaseStatement(*connection, query, stmt);
+			return success;
 		}
-		else
+
+		if (!executeQuery(*connection, query)) return false;
+
+		MYSQL_RES* result = mysql_use_result(connection->handle);
+		if (result == nullptr)
 		{
-            // Reemplazar la línea problemática con lo siguiente:
-            int ssl_mode_disabled = SSL_MODE_DISABLED;
-            mysql_options(conn, MYSQL_OPT_SSL_MODE, &ssl_mode_disabled);
+			printError(*connection, "Fallo al leer resultados");
+			return false;
 		}
 
-		if (!tls_version.empty())
+		connection->streaming = true;
+		bool success = fetchRows(result, row, &visitor);
+		connection->streaming = false;
+
+		if (success && mysql_errno(connection->handle) != 0)
 		{
-			mysql_options(conn, MYSQL_OPT_TLS_VERSION, tls_version.c_str());
+			success = false;
+			printError(*connection, "Fallo al leer resultados");
 		}
+
+		// mysql_free_result lee las filas que quedaron para dejar la conexión lista
+		mysql_free_result(result);
+
+		return success;
 	}
-	
+
 	/**
-	 * @brief Imprime un mensaje de error en el registro.
+	 * @brief Inserta varias filas o actualiza las que ya existen con ON DUPLICATE KEY UPDATE.
 	 * 
-	 * Este método registra un mensaje de error junto con
-	 * el mensaje de error específico de MySQL.
+	 * Los lotes se dividen para que cada sentencia quede por debajo de
+	 * max_allowed_packet del servidor y del máximo de 65535 parámetros.
+	 * Cada número de filas es un texto SQL distinto, así que los lotes
+	 * intermedios se redondean a 1, 8, 64, 512 o 4096 filas y el último
+	 * solo se guarda en la caché de sentencias si tiene uno de esos tamaños.
+	 * Así los vaciados de tamaño variable no expulsan a las sentencias de
+	 * permisos y puntos.
+	 * MySQL detecta el conflicto con cualquier índice único de la tabla,
+	 * por lo que conflictKey solo se usa cuando no hay columnas a actualizar:
+	 * su primera columna se asigna a sí misma para no modificar la fila.
 	 * 
-	 * @param message Mensaje de error personalizado.
+	 * @param tableName Nombre de la tabla.
+	 * @param columns Columnas a insertar.
+	 * @param rows Valores de cada fila, en el mismo orden que las columnas.
+	 * @param conflictKey Columna o columnas, separadas por comas, de la restricción UNIQUE o PRIMARY KEY.
+	 * @param updateColumns Columnas a actualizar si la fila ya existe; si está vacío la fila existente no se modifica.
+	 * @return true si todas las filas se escribieron, false en caso contrario.
 	 */
-	void printError(const std::string& message)
+	bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns)
 	{
-		Log::GetLog()->error("{} {}", message, mysql_error(conn));
+		if (rows.empty()) return true;
+		if (columns.empty())
+		{
+			Log::GetLog()->error("upsert en {} sin columnas", tableName);
+			return false;
+		}
+
+		std::string insert = "INSERT INTO " + tableName + " (";
+		std::string placeholders = "(";
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			insert += (i > 0 ? ", " : "") + columns[i];
+			placeholders += i > 0 ? ", ?" : "?";
+		}
+		insert += ") VALUES ";
+		placeholders += ")";
+
+		std::string update = " ON DUPLICATE KEY UPDATE ";
+		if (updateColumns.empty())
+		{
+			// Con una clave de varias columnas ("A, B") basta con la primera
+			std::string key = conflictKey.substr(0, conflictKey.find(','));
+			key.erase(0, key.find_first_not_of(" \t"));
+			key.erase(key.find_last_not_of(" \t") + 1);
+
+			update += key + " = " + key;
+		}
+		else
+		{
+			for (size_t i = 0; i < updateColumns.size(); i++)
+			{
+				update += (i > 0 ? ", " : "") + updateColumns[i] + " = VALUES(" + updateColumns[i] + ")";
+			}
+		}
+
+		// Antes de acquire() para que la conexión quede fijada a la transacción
+		if (!beginTransaction()) return false;
+
+		size_t maxPacket = maxAllowedPacket();
+
+		size_t start = 0;
+		while (start < rows.size())
+		{
+			std::string query = insert;
+			DbParams params;
+			size_t packetSize = insert.size() + update.size();
+			size_t count = 0;
+
+			for (size_t i = start; i < rows.size(); i++)
+			{
+				if (rows[i].size() != columns.size())
+				{
+					Log::GetLog()->error("upsert en {}: la fila {} tiene {} valores, se esperaban {}", tableName, i, rows[i].size(), columns.size());
+					rollback();
+					return false;
+				}
+
+				size_t rowSize = placeholders.size() + 2 + estimateSize(rows[i]);
+				if (count > 0 && (packetSize + rowSize > maxPacket || (count + 1) * columns.size() > 65535)) break;
+
+				packetSize += rowSize;
+				count++;
+			}
+
+			// El último lote va completo; los demás se redondean a un tamaño fijo
+			bool last = start + count == rows.size();
+			size_t bucket = 1;
+			while (bucket * 8 <= count && bucket < 4096) bucket *= 8;
+			if (!last) count = bucket;
+
+			for (size_t i = start; i < start + count; i++)
+			{
+				query += (i > start ? ", " : "") + placeholders;
+				params.insert(params.end(), rows[i].begin(), rows[i].end());
+			}
+
+			query += update;
+
+			if (!execute(query, params, count == bucket))
+			{
+				rollback();
+				return false;
+			}
+
+			start += count;
+		}
+
+		return commit();
 	}
-	
+
 	/**
-	 * @brief Ejecuta una consulta SQL en la base de datos MySQL.
+	 * @brief Ejecuta varias sentencias en un solo viaje al servidor.
 	 * 
-	 * Este método ejecuta una consulta SQL y maneja la reconexión
-	 * automática en caso de pérdida de conexión.
+	 * El lote se envía como un único texto entre START TRANSACTION y COMMIT, o entre SAVEPOINT y RELEASE SAVEPOINT
+	 * si el hilo ya tiene una transacción. Los resultados se recorren con
+	 * mysql_next_result. El protocolo de sentencias preparadas no admite
+	 * varias sentencias, por lo que los parámetros se escriben en el texto
+	 * escapados con mysql_real_escape_string. Si una sentencia falla el
+	 * servidor no ejecuta las siguientes y el lote se revierte.
 	 * 
-	 * @param query Consulta SQL a ejecutar.
-	 * @return true si la consulta se ejecutó exitosamente, false en caso contrario.
+	 * Las conexiones se abren sin CLIENT_MULTI_STATEMENTS: el modo de varias
+	 * sentencias se activa con mysql_set_server_option solo durante el lote,
+	 * para que una inyección en cualquier otra consulta no pueda encadenar
+	 * sentencias.
+	 * 
+	 * @param statements Sentencias con marcadores '?' y sus parámetros.
+	 * @param results Recibe un ResultSet por sentencia, vacío si la sentencia no devuelve filas.
+	 * @return true si todas las sentencias se ejecutaron y se confirmaron, false en caso contrario.
 	 */
-	bool executeQuery(const std::string& query)
+	bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results)
 	{
-		if (mysql_query(conn, query.c_str()))
+		results.assign(statements.size(), ResultSet());
+		if (statements.empty()) return true;
+
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		std::string savepoint = connection->transactionDepth > 0 ? "sp_" + std::to_string(connection->transactionDepth) : "";
+
+		QueryBuilder query;
+		query.append(savepoint.empty() ? "START TRANSACTION" : "SAVEPOINT ").append(savepoint);
+
+		for (const BatchStatement& statement : statements)
 		{
-			printError("Consulta fallida. Reintentando reconexión.");
+			query.append(";\n");
+			if (!appendStatement(query, *connection, statement)) return false;
+		}
 
-			unsigned int errorCode = mysql_errno(conn);
-			if (errorCode == 2003) // Conexión perdida o no se puede conectar al servidor
-			{
-				mysql_close(conn);
+		query.append(savepoint.empty() ? ";\nCOMMIT" : ";\nRELEASE SAVEPOINT ").append(savepoint);
 
-				if (!MySQLConnect()) return false;
-			}
+		// Solo se reintenta si falla la primera sentencia, antes de aplicar nada
+		if (!executeQuery(*connection, query.view(), true))
+		{
+			disableMultiStatements(*connection);
+			return false;
+		}
+
+		// Resultado 0: apertura; 1 a n: sentencias del lote; n + 1: confirmación
+		bool success = true;
+		size_t index = 0;
+		int status;
 
-			if (mysql_query(conn, query.c_str()))
+		while (true)
+		{
+			MYSQL_RES* result = mysql_store_result(connection->handle);
+			if (result != nullptr)
 			{
-				return false;
+				if (index >= 1 && index <= statements.size() && !fetchRows(result, results[index - 1])) success = false;
+				mysql_free_result(result);
+			}
+			else if (mysql_field_count(connection->handle) != 0)
+			{
+				printError(*connection, "Fallo al almacenar resultados del lote");
+				success = false;
 			}
+
+			status = mysql_next_result(connection->handle);
+			if (status != 0) break;
+
+			index++;
+		}
+
+		if (status == -1)
+		{
+			disableMultiStatements(*connection);
+			return success;
+		}
+
+		if (index + 1 <= statements.size())
+		{
+			printError(*connection, fmt::format("Sentencia {} del lote fallida.", index + 1));
+		}
+		else
+		{
+			printError(*connection, "Confirmación del lote fallida.");
+		}
+
+		if (savepoint.empty())
+		{
+			executeQuery(*connection, "ROLLBACK");
+		}
+		else if (executeQuery(*connection, "ROLLBACK TO SAVEPOINT " + savepoint))
+		{
+			executeQuery(*connection, "RELEASE SAVEPOINT " + savepoint);
+		}
+
+		disableMultiStatements(*connection);
+		return false;
+	}
+
+	/**
+	 * @brief Inicia una transacción o un savepoint si ya hay una activa.
+	 * 
+	 * La conexión usada queda fijada al hilo que llama: las operaciones de
+	 * ese hilo la reutilizan hasta el commit o rollback correspondiente y
+	 * no vuelve al pool mientras tanto.
+	 * 
+	 * @return true si la transacción se inició, false en caso contrario.
+	 */
+	bool beginTransaction()
+	{
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		std::string query = connection->transactionDepth == 0 ? "START TRANSACTION" : "SAVEPOINT sp_" + std::to_string(connection->transactionDepth);
+
+		if (!executeQuery(*connection, query)) return false;
+
+		if (connection->transactionDepth++ == 0)
+		{
+			pin(connection);
 		}
 
 		return true;
 	}
-	
+
 	/**
-	 * @brief Establece la conexión con la base de datos MySQL.
+	 * @brief Confirma la transacción o libera el savepoint más reciente.
 	 * 
-	 * Este método inicializa la conexión con el servidor MySQL
-	 * utilizando los parámetros de configuración proporcionados.
+	 * Si el COMMIT falla la transacción se revierte.
 	 * 
-	 * @return true si la conexión se estableció exitosamente, false en caso contrario.
+	 * @return true si los cambios se confirmaron, false en caso contrario.
 	 */
-	bool MySQLConnect()
+	bool commit()
 	{
-		conn = mysql_init(nullptr);
-		if (!conn)
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		if (connection->transactionDepth == 0)
 		{
-			printError("mysql_init() falló");
+			Log::GetLog()->error("No hay ninguna transacción MySQL activa");
 			return false;
 		}
 
-		configureSSL(_ssl_mode, _tls_version);
+		bool success;
+		if (connection->transactionDepth == 1)
+		{
+			success = executeQuery(*connection, "COMMIT");
+			if (!success) executeQuery(*connection, "ROLLBACK");
+		}
+		else
+		{
+			success = executeQuery(*connection, "RELEASE SAVEPOINT sp_" + std::to_string(connection->transactionDepth - 1));
+		}
+
+		if (--connection->transactionDepth == 0)
+		{
+			unpin();
+		}
 
-		if (!mysql_real_connect(conn, _host.c_str(), _user.c_str(), _password.c_str(), _dbname.c_str(), _port, nullptr, 0))
+		return success;
+	}
+
+	/**
+	 * @brief Revierte la transacción o los cambios desde el savepoint más reciente.
+	 * 
+	 * @return true si los cambios se revirtieron, false en caso contrario.
+	 */
+	bool rollback()
+	{
+		ConnectionLease connection = acquire();
+		if (!connection) return false;
+
+		if (connection->transactionDepth == 0)
 		{
-			printError("Conexión fallida.");
+			Log::GetLog()->error("No hay ninguna transacción MySQL activa");
 			return false;
 		}
 
-		return true;
+		bool success;
+		if (connection->transactionDepth == 1)
+		{
+			success = executeQuery(*connection, "ROLLBACK");
+		}
+		else
+		{
+			std::string savepoint = "sp_" + std::to_string(connection->transactionDepth - 1);
+			success = executeQuery(*connection, "ROLLBACK TO SAVEPOINT " + savepoint) && executeQuery(*connection, "RELEASE SAVEPOINT " + savepoint);
+		}
+
+		if (--connection->transactionDepth == 0)
+		{
+			unpin();
+		}
+
+		return success;
 	}
 
-};
+	/**
+	 * @brief Escapa una cadena para prevenir inyecciones SQL.
+	 * 
+	 * Este método procesa una cadena para hacerla segura
+	 * para su uso en consultas SQL de MySQL, utilizando
+	 * la función mysql_real_escape_string.
+	 * 
+	 * @param value Cadena a escapar.
+	 * @return Cadena escapada y segura para usar en consultas SQL.
+	 */
+	std::string escapeString(const std::string& value)
+	{
+		ConnectionLease connection = acquire();
+		if (!connection) return "";
+
+		QueryBuilder escaped;
+		escaped.appendEscaped(value.length() * 2 + 1, [&](char* out)
+		{
+			return mysql_real_escape_string(connection->handle, out, value.data(), static_cast<unsigned long>(value.length()));
+		});
+
+		return escaped.str();
+	}
+
+	/**
+	 * @brief Indica la variante de SQL del conector.
+	 * 
+	 * @return SqlDialect::MySQL.
+	 */
+	SqlDialect dialect() const
+	{
+		return SqlDialect::MySQL;
+	}
+
+	/**
+	 * @brief Inicia una consulta que avanza en el tick del servidor sin bloquear.
+	 * 
+	 * La consulta se registra en NonblockingPoller: cada poll() toma una
+	 * conexión libre, la abre o envía la consulta y recoge el resultado en
+	 * la medida en que el servidor responde, sin esperar en la red. La
+	 * continuación se ejecuta en el hilo del juego al terminar. Si el pool
+	 * está ocupado la consulta espera al siguiente tick en lugar de bloquear.
+	 * 
+	 * El cliente MySQL no tiene versión no bloqueante de las sentencias
+	 * preparadas, por lo que los parámetros se escriben escapados en el
+	 * texto, como en executeBatch. La consulta no participa en las
+	 * transacciones abiertas con beginTransaction.
+	 * 
+	 * Debe llamarse desde el hilo del juego y el conector debe estar en un
+	 * std::shared_ptr, como los que crea DatabaseFactory.
+	 * 
+	 * @param statement Consulta con marcadores '?' y sus parámetros.
+	 * @param then Continuación a ejecutar con el resultado.
+	 * @return Consulta pendiente, que permite cancelar la continuación.
+	 */
+	std::shared_ptr<PendingQuery> startQuery(BatchStatement statement, QueryCallback then);
+
+private:
+	/**
+	 * @struct Connection
+	 * @brief Conexión del pool junto con sus sentencias preparadas.
+	 * 
+	 * Las sentencias preparadas pertenecen a una conexión concreta, por lo
+	 * que cada conexión tiene su propia caché.
+	 */
+	struct Connection
+	{
+		MYSQL* handle = nullptr;
+		StatementCache<MYSQL_STMT*> statements;
+		std::chrono::steady_clock::time_point lastUsed = std::chrono::steady_clock::now();
+		int transactionDepth = 0;
+
+		// forEachRow está leyendo un resultado sin almacenar en esta conexión
+		bool streaming = false;
+
+		Connection(size_t statementCacheSize)
+			: statements(statementCacheSize, [](MYSQL_STMT* stmt) { mysql_stmt_close(stmt); })
+		{
+		}
+
+		~Connection()
+		{
+			close();
+		}
+
+		/**
+		 * @brief Cierra las sentencias y la conexión.
+		 */
+		void close()
+		{
+			// Las sentencias deben cerrarse antes que la conexión
+			statements.clear();
+
+			if (handle != nullptr)
+			{
+				mysql_close(handle);
+				handle = nullptr;
+			}
+		}
+	};
+
+	/**
+	 * @class ConnectionLease
+	 * @brief Préstamo RAII de una conexión del pool.
+	 * 
+	 * Devuelve la conexión al pool al salir de ámbito. Si la conexión está
+	 * fijada al hilo por una transacción, el préstamo solo la referencia y
+	 * no la devuelve.
+	 */
+	class ConnectionLease
+	{
+	public:
+		ConnectionLease(MySQLConnector* owner, std::unique_ptr<Connection> connection)
+			: _owner(owner), _connection(std::move(connection)), _pinned(nullptr)
+		{
+		}
+
+		explicit ConnectionLease(Connection* pinned)
+			: _owner(nullptr), _pinned(pinned)
+		{
+		}
+
+		ConnectionLease(ConnectionLease&& other) noexcept
+			: _owner(other._owner), _connection(std::move(other._connection)), _pinned(other._pinned)
+		{
+			other._pinned = nullptr;
+		}
+
+		ConnectionLease(const ConnectionLease&) = delete;
+		ConnectionLease& operator=(const ConnectionLease&) = delete;
+		ConnectionLease& operator=(ConnectionLease&&) = delete;
+
+		~ConnectionLease()
+		{
+			if (_connection != nullptr)
+			{
+				_owner->release(std::move(_connection));
+			}
+		}
+
+		explicit operator bool() const { return get() != nullptr; }
+		Connection& operator*() const { return *get(); }
+		Connection* operator->() const { return get(); }
+
+		/**
+		 * @brief Entrega la conexión prestada sin devolverla al pool.
+		 * 
+		 * @return La conexión, o nullptr si el préstamo no la posee.
+		 */
+		std::unique_ptr<Connection> detach()
+		{
+			return std::move(_connection);
+		}
+
+	private:
+		MySQLConnector* _owner;
+		std::unique_ptr<Connection> _connection;
+		Connection* _pinned;
+
+		Connection* get() const { return _pinned != nullptr ? _pinned : _connection.get(); }
+	};
+
+	/**
+	 * @struct ThreadGuard
+	 * @brief Inicializa y libera los datos por hilo de libmysql.
+	 */
+	struct ThreadGuard
+	{
+		ThreadGuard() { mysql_thread_init(); }
+		~ThreadGuard() { mysql_thread_end(); }
+	};
+
+	std::string _host;
+	std::string _user;
+	std::string _password;
+	std::string _dbname;
+	unsigned int _port;
+	int _ssl_mode;
+	std::string _tls_version;
+	size_t _statementCacheSize;
+	size_t _poolSize;
+	std::chrono::steady_clock::duration _idleValidation;
+	unsigned int _connectTimeout;
+	CircuitBreaker breaker;
+
+	std::mutex poolMutex;
+	std::condition_variable available;
+	std::vector<std::unique_ptr<Connection>> idle;
+	std::unordered_map<std::thread::id, std::unique_ptr<Connection>> pinned;
+	size_t openConnections = 0;
+	std::atomic<size_t> _maxAllowedPacket{ 0 };
+
+	/**
+	 * @brief Toma una conexión libre del pool.
+	 * 
+	 * Reutiliza la conexión usada más recientemente, abre una nueva si
+	 * aún no se alcanzó el tamaño del pool o espera a que otra operación
+	 * devuelva la suya. Las conexiones que llevan tiempo inactivas se
+	 * validan con mysql_ping y se reconectan si el servidor las cerró.
+	 * Si el hilo tiene una transacción activa devuelve su conexión fijada,
+	 * salvo que forEachRow la esté usando para leer.
+	 * Con el circuito abierto devuelve un préstamo vacío sin esperar.
+	 * 
+	 * @return Préstamo de la conexión, vacío si no se pudo conectar.
+	 */
+	ConnectionLease acquire()
+	{
+		static thread_local ThreadGuard threadGuard;
+
+		std::unique_ptr<Connection> connection;
+		{
+			std::unique_lock<std::mutex> lock(poolMutex);
+
+			auto it = pinned.find(std::this_thread::get_id());
+			if (it != pinned.end())
+			{
+				// Otra consulta en medio de la lectura daría "Commands out of sync"
+				if (it->second->streaming)
+				{
+					Log::GetLog()->error("La conexión MySQL de la transacción está ocupada por forEachRow; el visitante no puede usar el conector");
+					return ConnectionLease(this, nullptr);
+				}
+
+				return ConnectionLease(it->second.get());
+			}
+
+			if (!breaker.allow())
+			{
+				return ConnectionLease(this, nullptr);
+			}
+
+			available.wait(lock, [this]() { return !idle.empty() || openConnections < _poolSize; });
+
+			if (!idle.empty())
+			{
+				connection = std::move(idle.back());
+				idle.pop_back();
+			}
+			else
+			{
+				openConnections++;
+			}
+		}
+
+		if (connection == nullptr)
+		{
+			connection = std::make_unique<Connection>(_statementCacheSize);
+			MySQLConnect(*connection);
+		}
+		else if (std::chrono::steady_clock::now() - connection->lastUsed > _idleValidation && mysql_ping(connection->handle) != 0)
+		{
+			printError(*connection, "Conexión inactiva perdida. Reconectando.");
+			connection->close();
+			MySQLConnect(*connection);
+		}
+
+		if (connection->handle == nullptr)
+		{
+			discard();
+			return ConnectionLease(this, nullptr);
+		}
+
+		return ConnectionLease(this, std::move(connection));
+	}
+
+	/**
+	 * @enum Availability
+	 * @brief Resultado de tryAcquire().
+	 */
+	enum class Availability
+	{
+		Ready,
+		Busy,
+		Unavailable
+	};
+
+	/**
+	 * @brief Toma una conexión libre del pool sin esperar.
+	 * 
+	 * A diferencia de acquire() no valida las conexiones inactivas con
+	 * mysql_ping, que bloquearía: una conexión que el servidor cerró falla
+	 * al enviar la consulta y se reconecta entonces. Si hay hueco en el pool
+	 * se reserva y la conexión se entrega sin abrir.
+	 * 
+	 * @param connection Recibe la conexión si el resultado es Ready.
+	 * @return Ready si se obtuvo una conexión, Busy si el pool está ocupado o Unavailable si el circuito está abierto.
+	 */
+	Availability tryAcquire(std::unique_ptr<Connection>& connection)
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+
+		if (!breaker.allow()) return Availability::Unavailable;
+
+		if (!idle.empty())
+		{
+			connection = std::move(idle.back());
+			idle.pop_back();
+			return Availability::Ready;
+		}
+
+		if (openConnections >= _poolSize) return Availability::Busy;
+
+		openConnections++;
+		connection = std::make_unique<Connection>(_statementCacheSize);
+		return Availability::Ready;
+	}
+
+	/**
+	 * @brief Devuelve una conexión al pool.
+	 * 
+	 * Si la conexión quedó cerrada tras un fallo de reconexión se descarta
+	 * para que la siguiente operación abra una nueva.
+	 * 
+	 * @param connection Conexión a devolver.
+	 */
+	void release(std::unique_ptr<Connection> connection)
+	{
+		if (connection->handle == nullptr)
+		{
+			connection.reset();
+			discard();
+			return;
+		}
+
+		connection->lastUsed = std::chrono::steady_clock::now();
+		{
+			std::lock_guard<std::mutex> lock(poolMutex);
+			idle.push_back(std::move(connection));
+		}
+		available.notify_one();
+	}
+
+	/**
+	 * @brief Libera el hueco de una conexión que se cerró.
+	 */
+	void discard()
+	{
+		{
+			std::lock_guard<std::mutex> lock(poolMutex);
+			openConnections--;
+		}
+		available.notify_one();
+	}
+
+	/**
+	 * @brief Fija la conexión de un préstamo al hilo actual.
+	 * 
+	 * @param lease Préstamo que posee la conexión.
+	 */
+	void pin(ConnectionLease& lease)
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		pinned[std::this_thread::get_id()] = lease.detach();
+	}
+
+	/**
+	 * @brief Devuelve al pool la conexión fijada al hilo actual.
+	 */
+	void unpin()
+	{
+		std::unique_ptr<Connection> connection;
+		{
+			std::lock_guard<std::mutex> lock(poolMutex);
+			auto it = pinned.find(std::this_thread::get_id());
+			if (it == pinned.end()) return;
+
+			connection = std::move(it->second);
+			pinned.erase(it);
+		}
+
+		release(std::move(connection));
+	}
+
+	/**
+	 * @brief Añade un valor entre comillas escapándolo directamente en la consulta.
+	 * 
+	 * Usa el juego de caracteres de la conexión, igual que escapeString(),
+	 * pero sin crear una cadena intermedia.
+	 * 
+	 * @param query Consulta en construcción.
+	 * @param connection Conexión a utilizar.
+	 * @param value Cadena a escapar.
+	 */
+	void appendQuoted(QueryBuilder& query, Connection& connection, const std::string& value)
+	{
+		query.appendQuoted(value.length() * 2 + 1, [&](char* out)
+		{
+			return mysql_real_escape_string(connection.handle, out, value.data(), static_cast<unsigned long>(value.length()));
+		});
+	}
+
+	/**
+	 * @brief Añade una sentencia del lote con sus parámetros escritos en el texto.
+	 * 
+	 * Los '?' dentro de literales o identificadores entre comillas no se
+	 * consideran marcadores.
+	 * 
+	 * @param query Lote en construcción.
+	 * @param connection Conexión a utilizar para escapar las cadenas.
+	 * @param statement Sentencia y parámetros a añadir.
+	 * @return true si el número de marcadores coincide con el de parámetros.
+	 */
+	bool appendStatement(QueryBuilder& query, Connection& connection, const BatchStatement& statement)
+	{
+		std::string_view text = statement.query;
+		while (!text.empty() && (text.back() == ';' || std::isspace(static_cast<unsigned char>(text.back())))) text.remove_suffix(1);
+
+		size_t start = 0;
+		size_t placeholders = 0;
+		char quote = 0;
+
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			char c = text[i];
+
+			if (quote != 0)
+			{
+				if (c == '\\' && quote != '`') i++;
+				else if (c == quote) quote = 0;
+			}
+			else if (c == '\'' || c == '"' || c == '`')
+			{
+				quote = c;
+			}
+			else if (c == '?')
+			{
+				if (placeholders < statement.params.size())
+				{
+					query.append(text.substr(start, i - start));
+					appendValue(query, connection, statement.params[placeholders]);
+					start = i + 1;
+				}
+
+				placeholders++;
+			}
+		}
+
+		if (placeholders != statement.params.size())
+		{
+			Log::GetLog()->error("La sentencia del lote tiene {} marcadores y recibió {} parámetros: {}", placeholders, statement.params.size(), statement.query);
+			return false;
+		}
+
+		query.append(text.substr(start));
+		return true;
+	}
+
+	/**
+	 * @brief Añade un parámetro como literal SQL.
+	 * 
+	 * @param query Consulta en construcción.
+	 * @param connection Conexión a utilizar para escapar las cadenas.
+	 * @param value Valor a añadir.
+	 */
+	void appendValue(QueryBuilder& query, Connection& connection, const DbValue& value)
+	{
+		if (std::holds_alternative<int64_t>(value))
+		{
+			fmt::format_int number(std::get<int64_t>(value));
+			query.append(std::string_view(number.data(), number.size()));
+		}
+		else if (std::holds_alternative<double>(value))
+		{
+			query.append(fmt::format("{}", std::get<double>(value)));
+		}
+		else if (std::holds_alternative<std::string>(value))
+		{
+			appendQuoted(query, connection, std::get<std::string>(value));
+		}
+		else
+		{
+			query.append("NULL");
+		}
+	}
+
+	/**
+	 * @brief Obtiene una sentencia preparada de la caché o la prepara.
+	 * 
+	 * La sentencia queda en uso hasta releaseStatement(), por lo que una
+	 * consulta anidada en la misma conexión no la expulsa ni la reutiliza a
+	 * mitad de lectura. Si la misma consulta ya está en uso se prepara una
+	 * copia que no se guarda en la caché.
+	 * 
+	 * @param connection Conexión a la que pertenece la sentencia.
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param cache false para preparar una copia que no se guarda en la caché.
+	 * @return La sentencia lista para enlazar parámetros, o nullptr si falló.
+	 */
+	MYSQL_STMT* acquireStatement(Connection& connection, const std::string& query, bool cache = true)
+	{
+		MYSQL_STMT* stmt = cache ? connection.statements.checkout(query) : nullptr;
+		if (stmt != nullptr) return stmt;
+
+		stmt = mysql_stmt_init(connection.handle);
+		if (stmt == nullptr)
+		{
+			printError(connection, "mysql_stmt_init() falló");
+			return nullptr;
+		}
+
+		if (mysql_stmt_prepare(stmt, query.c_str(), static_cast<unsigned long>(query.size())))
+		{
+			printStatementError(stmt, "Fallo al preparar la sentencia.");
+			mysql_stmt_close(stmt);
+			return nullptr;
+		}
+
+		if (cache) connection.statements.insert(query, stmt, true);
+		return stmt;
+	}
+
+	/**
+	 * @brief Libera el resultado de una sentencia y la devuelve a la caché.
+	 * 
+	 * Las copias que no quedaron en la caché se cierran.
+	 * 
+	 * @param connection Conexión a la que pertenece la sentencia.
+	 * @param query Consulta SQL de la sentencia.
+	 * @param stmt Sentencia obtenida con acquireStatement().
+	 */
+	void releaseStatement(Connection& connection, const std::string& query, MYSQL_STMT* stmt)
+	{
+		mysql_stmt_free_result(stmt);
+		if (!connection.statements.checkin(query, stmt)) mysql_stmt_close(stmt);
+	}
+
+	/**
+	 * @brief Enlaza los parámetros y ejecuta una sentencia preparada.
+	 * 
+	 * Si la conexión se perdió, reconecta y vuelve a intentarlo una vez,
+	 * igual que executeQuery().
+	 * 
+	 * @param connection Conexión a utilizar.
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param cache false para no guardar la sentencia en la caché de la conexión.
+	 * @return La sentencia ejecutada, o nullptr si falló.
+	 */
+	MYSQL_STMT* executeStatement(Connection& connection, const std::string& query, const DbParams& params, bool cache = true)
+	{
+		for (int attempt = 0; attempt < 2; attempt++)
+		{
+			unsigned int errorCode;
+
+			MYSQL_STMT* stmt = acquireStatement(connection, query, cache);
+			if (stmt == nullptr)
+			{
+				errorCode = mysql_errno(connection.handle);
+			}
+			else
+			{
+				if (bindAndExecute(stmt, params))
+				{
+					connectionSucceeded();
+					return stmt;
+				}
+
+				errorCode = mysql_stmt_errno(stmt);
+				printStatementError(stmt, "Sentencia fallida.");
+
+				// La sentencia fallida no se reutiliza
+				if (connection.statements.checkin(query, stmt)) connection.statements.erase(query);
+				else mysql_stmt_close(stmt);
+			}
+
+			if (!reconnectAfter(connection, errorCode)) break;
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief Enlaza los parámetros a los marcadores de una sentencia y la ejecuta.
+	 * 
+	 * @param stmt Sentencia preparada.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @return true si la sentencia se ejecutó, false en caso contrario.
+	 */
+	bool bindAndExecute(MYSQL_STMT* stmt, const DbParams& params)
+	{
+		if (params.size() != mysql_stmt_param_count(stmt))
+		{
+			Log::GetLog()->error("La sentencia MySQL espera {} parámetros, recibió {}", mysql_stmt_param_count(stmt), params.size());
+			return false;
+		}
+
+		std::vector<MYSQL_BIND> binds(params.size());
+
+		for (size_t i = 0; i < params.size(); i++)
+		{
+			const DbValue& value = params[i];
+
+			if (std::holds_alternative<int64_t>(value))
+			{
+				binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+				binds[i].buffer = const_cast<int64_t*>(&std::get<int64_t>(value));
+			}
+			else if (std::holds_alternative<double>(value))
+			{
+				binds[i].buffer_type = MYSQL_TYPE_DOUBLE;
+				binds[i].buffer = const_cast<double*>(&std::get<double>(value));
+			}
+			else if (std::holds_alternative<std::string>(value))
+			{
+				const std::string& text = std::get<std::string>(value);
+				binds[i].buffer_type = MYSQL_TYPE_STRING;
+				binds[i].buffer = const_cast<char*>(text.data());
+				binds[i].buffer_length = static_cast<unsigned long>(text.size());
+			}
+			else
+			{
+				binds[i].buffer_type = MYSQL_TYPE_NULL;
+			}
+		}
+
+		if (!binds.empty() && mysql_stmt_bind_param(stmt, binds.data())) return false;
+
+		return mysql_stmt_execute(stmt) == 0;
+	}
+
+	/**
+	 * @brief Obtiene el max_allowed_packet del servidor.
+	 * 
+	 * Se consulta una sola vez y se guarda para las siguientes llamadas.
+	 * Se deja un margen del 10% para las cabeceras del protocolo.
+	 * 
+	 * @return Tamaño máximo en bytes a usar por sentencia.
+	 */
+	size_t maxAllowedPacket()
+	{
+		size_t cached = _maxAllowedPacket.load();
+		if (cached != 0) return cached;
+
+		size_t size = 4 * 1024 * 1024; // valor por defecto de MySQL 8
+
+		ResultSet results;
+		if (read("SELECT @@max_allowed_packet AS size", results) && !results.empty())
+		{
+			size = static_cast<size_t>(results.getInt64(0, "size").value_or(static_cast<int64_t>(size)));
+		}
+
+		size -= size / 10;
+		_maxAllowedPacket.store(size);
+
+		return size;
+	}
+
+	/**
+	 * @brief Estima los bytes que ocupan los valores de una fila al enviarse.
+	 * 
+	 * @param row Valores de la fila.
+	 * @return Tamaño aproximado en bytes.
+	 */
+	static size_t estimateSize(const DbParams& row)
+	{
+		size_t size = 0;
+		for (const DbValue& value : row)
+		{
+			size += 2; // tipo del parámetro
+			if (std::holds_alternative<std::string>(value))
+			{
+				size += std::get<std::string>(value).size() + 9; // longitud codificada
+			}
+			else if (!std::holds_alternative<std::nullptr_t>(value))
+			{
+				size += 8;
+			}
+		}
+
+		return size;
+	}
+
+	/**
+	 * @brief Copia las filas de un resultado de texto al ResultSet.
+	 * 
+	 * Sin visitante se acumulan todas las filas. Con visitante el ResultSet
+	 * contiene solo la fila actual y se reutiliza en cada paso.
+	 * 
+	 * @param result Resultado de mysql_store_result o mysql_use_result.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @param visitor Función que recibe cada fila, o nullptr para acumularlas.
+	 * @return false si el resultado no cabe en el ResultSet.
+	 */
+	bool fetchRows(MYSQL_RES* result, ResultSet& results, const RowVisitor* visitor = nullptr)
+	{
+		unsigned int num_fields = mysql_num_fields(result);
+		setColumns(results, result);
+		if (visitor == nullptr) results.reserve(mysql_num_rows(result));
+
+		MYSQL_ROW row;
+
+		while (true)
+		{
+			row = mysql_fetch_row(result);
+			if (!row) break;
+
+			unsigned long* lengths = mysql_fetch_lengths(result);
+
+			for (unsigned int i = 0; i < num_fields; i++)
+			{
+				if (row[i] == nullptr)
+				{
+					results.addNull();
+				}
+				else if (!results.addValue(row[i], lengths[i]))
+				{
+					Log::GetLog()->error("El resultado de MySQL supera el tamaño máximo de un ResultSet");
+					return false;
+				}
+			}
+
+			if (visitor != nullptr)
+			{
+				if (!(*visitor)(results)) break;
+				results.clearRows();
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Copia las filas de una sentencia ejecutada al ResultSet y libera su resultado.
+	 * 
+	 * Todas las columnas se reciben como texto. Sin visitante el resultado
+	 * se almacena con mysql_stmt_store_result; con visitante las filas se
+	 * leen del servidor una a una.
+	 * 
+	 * @param stmt Sentencia ya ejecutada.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @param visitor Función que recibe cada fila, o nullptr para acumularlas.
+	 * @return true si se leyeron las filas, false en caso contrario.
+	 */
+	bool fetchStatementRows(MYSQL_STMT* stmt, ResultSet& results, const RowVisitor* visitor = nullptr)
+	{
+		MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt);
+		if (metadata == nullptr)
+		{
+			printStatementError(stmt, "La sentencia no devuelve resultados");
+			mysql_stmt_free_result(stmt);
+			return false;
+		}
+
+		unsigned int num_fields = mysql_num_fields(metadata);
+		setColumns(results, metadata);
+
+		std::vector<MYSQL_BIND> binds(num_fields);
+		std::vector<std::string> buffers(num_fields, std::string(256, '\0'));
+		std::vector<unsigned long> lengths(num_fields);
+		std::unique_ptr<bool[]> nulls(new bool[num_fields]());
+
+		for (unsigned int i = 0; i < num_fields; i++)
+		{
+			binds[i].buffer_type = MYSQL_TYPE_STRING;
+			binds[i].buffer = buffers[i].data();
+			binds[i].buffer_length = static_cast<unsigned long>(buffers[i].size());
+			binds[i].length = &lengths[i];
+			binds[i].is_null = &nulls[i];
+		}
+
+		bool success = mysql_stmt_bind_result(stmt, binds.data()) == 0;
+		if (success && visitor == nullptr)
+		{
+			success = mysql_stmt_store_result(stmt) == 0;
+			if (success) results.reserve(mysql_stmt_num_rows(stmt));
+		}
+
+		std::string truncated;
+
+		while (success)
+		{
+			int rc = mysql_stmt_fetch(stmt);
+			if (rc == MYSQL_NO_DATA) break;
+			if (rc == 1)
+			{
+				success = false;
+				break;
+			}
+
+			for (unsigned int i = 0; i < num_fields; i++)
+			{
+				if (nulls[i])
+				{
+					results.addNull();
+				}
+				else if (lengths[i] > buffers[i].size())
+				{
+					// Columna truncada: se vuelve a leer con el tamaño real
+					truncated.assign(lengths[i], '\0');
+
+					MYSQL_BIND column{};
+					column.buffer_type = MYSQL_TYPE_STRING;
+					column.buffer = truncated.data();
+					column.buffer_length = lengths[i];
+					mysql_stmt_fetch_column(stmt, &column, i, 0);
+
+					success = results.addValue(truncated.data(), truncated.size());
+				}
+				else
+				{
+					success = results.addValue(buffers[i].data(), lengths[i]);
+				}
+
+				if (!success) break;
+			}
+
+			if (!success)
+			{
+				Log::GetLog()->error("El resultado de MySQL supera el tamaño máximo de un ResultSet");
+				break;
+			}
+
+			if (visitor != nullptr)
+			{
+				if (!(*visitor)(results)) break;
+				results.clearRows();
+			}
+		}
+
+		if (!success)
+		{
+			printStatementError(stmt, "Fallo al leer resultados");
+		}
+
+		mysql_free_result(metadata);
+		mysql_stmt_free_result(stmt);
+
+		return success;
+	}
+
+	/**
+	 * @brief Copia los nombres de las columnas de un resultado al ResultSet.
+	 *
+	 * @param results ResultSet que recibirá las columnas.
+	 * @param metadata Resultado o metadatos de la consulta.
+	 */
+	void setColumns(ResultSet& results, MYSQL_RES* metadata)
+	{
+		unsigned int num_fields = mysql_num_fields(metadata);
+		MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+		std::vector<std::string> columns;
+		columns.reserve(num_fields);
+		for (unsigned int i = 0; i < num_fields; i++)
+		{
+			columns.emplace_back(fields[i].name);
+		}
+
+		results.setColumns(std::move(columns));
+	}
+
+	/**
+	 * @brief Imprime un mensaje de error de una sentencia preparada.
+	 * 
+	 * @param stmt Sentencia que produjo el error.
+	 * @param message Mensaje de error personalizado.
+	 */
+	void printStatementError(MYSQL_STMT* stmt, const std::string& message)
+	{
+		Log::GetLog()->error("{} {}", message, mysql_stmt_error(stmt));
+	}
+
+	/**
+	 * @brief Configura las opciones SSL para la conexión MySQL.
+	 * 
+	 * Este método configura las opciones SSL/TLS para la conexión
+	 * a la base de datos MySQL según los parámetros especificados.
+	 * 
+	 * @param connection Conexión a configurar.
+	 * @param ssl_mode Modo SSL a configurar.
+	 * @param tls_version Versión TLS a utilizar.
+	 */
+	void configureSSL(Connection& connection, int ssl_mode, const std::string& tls_version)
+	{
+		if (ssl_mode >= 0 && ssl_mode <= 4)
+		{
+			mysql_options(connection.handle, MYSQL_OPT_SSL_MODE, &ssl_mode);
+		}
+		else
+		{
+            // Reemplazar la línea problemática con lo siguiente:
+            int ssl_mode_disabled = SSL_MODE_DISABLED;
+            mysql_options(connection.handle, MYSQL_OPT_SSL_MODE, &ssl_mode_disabled);
+		}
+
+		if (!tls_version.empty())
+		{
+			mysql_options(connection.handle, MYSQL_OPT_TLS_VERSION, tls_version.c_str());
+		}
+	}
+	
+	/**
+	 * @brief Imprime un mensaje de error en el registro.
+	 * 
+	 * Este método registra un mensaje de error junto con
+	 * el mensaje de error específico de MySQL.
+	 * 
+	 * @param connection Conexión que produjo el error.
+	 * @param message Mensaje de error personalizado.
+	 */
+	void printError(Connection& connection, const std::string& message)
+	{
+		Log::GetLog()->error("{} {}", message, connection.handle != nullptr ? mysql_error(connection.handle) : "");
+	}
+	
+	/**
+	 * @brief Ejecuta una consulta SQL en la base de datos MySQL.
+	 * 
+	 * Este método ejecuta una consulta SQL y maneja la reconexión
+	 * automática en caso de pérdida de conexión.
+	 * 
+	 * @param connection Conexión a utilizar.
+	 * @param query Consulta SQL a ejecutar.
+	 * @param multiStatements Activa antes de cada intento el modo de varias sentencias, que una reconexión pierde.
+	 * @return true si la consulta se ejecutó exitosamente, false en caso contrario.
+	 */
+	bool executeQuery(Connection& connection, std::string_view query, bool multiStatements = false)
+	{
+		QueryTimer timer(query);
+
+		for (int attempt = 0; attempt < 2; attempt++)
+		{
+			unsigned int errorCode;
+			if (multiStatements && mysql_set_server_option(connection.handle, MYSQL_OPTION_MULTI_STATEMENTS_ON) != 0)
+			{
+				errorCode = mysql_errno(connection.handle);
+				printError(connection, "No se pudo activar el modo de varias sentencias.");
+			}
+			else if (mysql_real_query(connection.handle, query.data(), static_cast<unsigned long>(query.size())) == 0)
+			{
+				connectionSucceeded();
+				return true;
+			}
+			else
+			{
+				errorCode = mysql_errno(connection.handle);
+				printError(connection, "Consulta fallida.");
+			}
+
+			if (!reconnectAfter(connection, errorCode)) break;
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Desactiva el modo de varias sentencias tras un lote.
+	 * 
+	 * Si el servidor no responde la conexión se cierra, para que no vuelva
+	 * al pool con el modo activo.
+	 * 
+	 * @param connection Conexión usada por el lote.
+	 */
+	void disableMultiStatements(Connection& connection)
+	{
+		if (connection.handle == nullptr) return;
+		if (mysql_set_server_option(connection.handle, MYSQL_OPTION_MULTI_STATEMENTS_OFF) == 0) return;
+
+		printError(connection, "No se pudo desactivar el modo de varias sentencias.");
+		connection.close();
+	}
+
+	/**
+	 * @brief Indica si un código de error del cliente corresponde a una conexión perdida.
+	 * 
+	 * @param errorCode Valor de mysql_errno o mysql_stmt_errno.
+	 * @return true si el servidor no es accesible o cerró la conexión.
+	 */
+	static bool isConnectionError(unsigned int errorCode)
+	{
+		return errorCode == CR_CONNECTION_ERROR || errorCode == CR_CONN_HOST_ERROR || errorCode == CR_SERVER_GONE_ERROR
+			|| errorCode == CR_SERVER_LOST || errorCode == CR_SERVER_LOST_EXTENDED;
+	}
+
+	/**
+	 * @brief Reconecta tras un error si la operación puede reintentarse.
+	 * 
+	 * Los errores de la consulta no se reintentan y cuentan como respuesta
+	 * del servidor. Una conexión perdida cuenta como fallo del circuito y
+	 * solo se reconecta de inmediato mientras el circuito siga cerrado.
+	 * 
+	 * @param connection Conexión que produjo el error.
+	 * @param errorCode Código de error del cliente MySQL.
+	 * @return true si la conexión se restableció y la operación debe repetirse.
+	 */
+	bool reconnectAfter(Connection& connection, unsigned int errorCode)
+	{
+		if (!isConnectionError(errorCode))
+		{
+			connectionSucceeded();
+			return false;
+		}
+
+		connectionFailed();
+
+		// Reintentar o reconectar en medio de una transacción la perdería sin avisar
+		if (connection.transactionDepth > 0) return false;
+
+		connection.close();
+
+		return breaker.allow() && MySQLConnect(connection);
+	}
+
+	/**
+	 * @brief Registra en el circuito que el servidor respondió.
+	 */
+	void connectionSucceeded()
+	{
+		if (breaker.success())
+		{
+			Log::GetLog()->info("Conexión MySQL con {} restablecida.", _host);
+		}
+	}
+
+	/**
+	 * @brief Registra en el circuito un fallo de conexión.
+	 */
+	void connectionFailed()
+	{
+		std::chrono::milliseconds delay = breaker.failure();
+		if (delay.count() > 0)
+		{
+			Log::GetLog()->error("Servidor MySQL {} no disponible. Las operaciones fallarán durante {} ms antes de reintentar.", _host, delay.count());
+		}
+	}
+	
+	/**
+	 * @brief Crea el manejador de una conexión y aplica sus opciones, sin conectar.
+	 * 
+	 * @param connection Conexión del pool a inicializar.
+	 * @return true si el manejador se creó, false en caso contrario.
+	 */
+	bool initHandle(Connection& connection)
+	{
+		connection.handle = mysql_init(nullptr);
+		if (!connection.handle)
+		{
+			printError(connection, "mysql_init() falló");
+			return false;
+		}
+
+		configureSSL(connection, _ssl_mode, _tls_version);
+
+		if (_connectTimeout > 0)
+		{
+			mysql_options(connection.handle, MYSQL_OPT_CONNECT_TIMEOUT, &_connectTimeout);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Establece la conexión con la base de datos MySQL.
+	 * 
+	 * Este método inicializa una conexión con el servidor MySQL
+	 * utilizando los parámetros de configuración proporcionados.
+	 * 
+	 * @param connection Conexión del pool a inicializar.
+	 * @return true si la conexión se estableció exitosamente, false en caso contrario.
+	 */
+	bool MySQLConnect(Connection& connection)
+	{
+		if (!initHandle(connection)) return false;
+
+		if (!mysql_real_connect(connection.handle, _host.c_str(), _user.c_str(), _password.c_str(), _dbname.c_str(), _port, nullptr, 0))
+		{
+			printError(connection, "Conexión fallida.");
+			connection.close();
+			connectionFailed();
+			return false;
+		}
+
+		connectionSucceeded();
+		return true;
+	}
+
+};
+
+/**
+ * @class MySQLConnector::PendingQuery
+ * @brief Consulta no bloqueante en curso, iniciada con startQuery().
+ * 
+ * Cada paso avanza la consulta por sus etapas (esperar una conexión
+ * libre, conectar, enviar y recoger el resultado) mientras el cliente
+ * MySQL no tenga que esperar a la red. Solo se usa desde el hilo del juego.
+ */
+class MySQLConnector::PendingQuery : public NonblockingTask
+{
+public:
+	PendingQuery(std::shared_ptr<MySQLConnector> owner, BatchStatement statement, QueryCallback then)
+		: owner(std::move(owner)), statement(std::move(statement)), then(std::move(then))
+	{
+	}
+
+	~PendingQuery()
+	{
+		// Una consulta abandonada a medias deja la conexión en un estado inservible
+		if (connection != nullptr)
+		{
+			connection->close();
+			owner->release(std::move(connection));
+		}
+	}
+
+	/**
+	 * @brief Indica si la consulta terminó.
+	 */
+	bool done() const
+	{
+		return stage == Stage::Done;
+	}
+
+	/**
+	 * @brief Evita que se ejecute la continuación.
+	 * 
+	 * Una consulta que aún no obtuvo conexión ya no se envía; una que ya
+	 * se envió termina igualmente para devolver la conexión al pool.
+	 */
+	void cancel()
+	{
+		cancelled = true;
+	}
+
+	bool step()
+	{
+		static thread_local ThreadGuard threadGuard;
+
+		while (stage != Stage::Done)
+		{
+			if (!advance()) return false;
+		}
+
+		return true;
+	}
+
+private:
+	enum class Stage
+	{
+		Waiting,
+		Connecting,
+		Querying,
+		Storing,
+		Done
+	};
+
+	std::shared_ptr<MySQLConnector> owner;
+	BatchStatement statement;
+	QueryCallback then;
+	std::chrono::steady_clock::time_point start;
+
+	Stage stage = Stage::Waiting;
+	std::unique_ptr<Connection> connection;
+	std::string text;
+	ResultSet results;
+	uint64_t affectedRows = 0;
+	bool retried = false;
+	bool cancelled = false;
+
+	/**
+	 * @brief Avanza la etapa actual.
+	 * 
+	 * @return true si la consulta cambió de etapa, false si espera al servidor o a una conexión libre.
+	 */
+	bool advance()
+	{
+		switch (stage)
+		{
+		case Stage::Waiting:
+			return acquire();
+		case Stage::Connecting:
+			return connect();
+		case Stage::Querying:
+			return query();
+		case Stage::Storing:
+			return store();
+		default:
+			return false;
+		}
+	}
+
+	bool acquire()
+	{
+		if (cancelled) return finish(false);
+
+		switch (owner->tryAcquire(connection))
+		{
+		case Availability::Busy:
+			return false;
+		case Availability::Unavailable:
+			return finish(false);
+		default:
+			break;
+		}
+
+		return connection->handle != nullptr ? send() : reconnect();
+	}
+
+	/**
+	 * @brief Prepara el manejador de la conexión para conectar en los siguientes pasos.
+	 */
+	bool reconnect()
+	{
+		if (!owner->initHandle(*connection)) return finish(false);
+
+		stage = Stage::Connecting;
+		return true;
+	}
+
+	bool connect()
+	{
+		net_async_status status = mysql_real_connect_nonblocking(connection->handle, owner->_host.c_str(), owner->_user.c_str(), owner->_password.c_str(),
+			owner->_dbname.c_str(), owner->_port, nullptr, 0);
+		if (status == NET_ASYNC_NOT_READY) return false;
+
+		if (status == NET_ASYNC_ERROR)
+		{
+			owner->printError(*connection, "Conexión fallida.");
+			connection->close();
+			owner->connectionFailed();
+			return finish(false);
+		}
+
+		owner->connectionSucceeded();
+		return send();
+	}
+
+	/**
+	 * @brief Construye el texto de la consulta con la conexión obtenida.
+	 */
+	bool send()
+	{
+		if (text.empty())
+		{
+			QueryBuilder builder;
+			if (!owner->appendStatement(builder, *connection, statement)) return finish(false);
+			text = builder.str();
+			start = std::chrono::steady_clock::now();
+		}
+
+		stage = Stage::Querying;
+		return true;
+	}
+
+	bool query()
+	{
+		net_async_status status = mysql_real_query_nonblocking(connection->handle, text.data(), static_cast<unsigned long>(text.size()));
+		if (status == NET_ASYNC_NOT_READY) return false;
+
+		if (status == NET_ASYNC_ERROR)
+		{
+			unsigned int errorCode = mysql_errno(connection->handle);
+			owner->printError(*connection, "Consulta fallida.");
+
+			if (!isConnectionError(errorCode))
+			{
+				owner->connectionSucceeded();
+				return finish(false);
+			}
+
+			// Igual que executeQuery, se reintenta una vez con una conexión nueva
+			owner->connectionFailed();
+			connection->close();
+
+			if (retried || !owner->breaker.allow()) return finish(false);
+
+			retried = true;
+			return reconnect();
+		}
+
+		owner->connectionSucceeded();
+		stage = Stage::Storing;
+		return true;
+	}
+
+	bool store()
+	{
+		MYSQL_RES* result = nullptr;
+		if (mysql_store_result_nonblocking(connection->handle, &result) == NET_ASYNC_NOT_READY) return false;
+
+		if (result != nullptr)
+		{
+			bool success = owner->fetchRows(result, results);
+			mysql_free_result(result);
+			return finish(success);
+		}
+
+		if (mysql_field_count(connection->handle) != 0)
+		{
+			owner->printError(*connection, "Fallo al almacenar resultados.");
+			return finish(false);
+		}
+
+		affectedRows = mysql_affected_rows(connection->handle);
+		return finish(true);
+	}
+
+	/**
+	 * @brief Devuelve la conexión, registra la duración y ejecuta la continuación.
+	 */
+	bool finish(bool success)
+	{
+		stage = Stage::Done;
+
+		if (connection != nullptr) owner->release(std::move(connection));
+
+		if (!text.empty())
+		{
+			auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			QueryStats::Get().record(text, static_cast<uint64_t>(elapsed.count()));
+		}
+
+		// Se suelta la continuación para liberar lo que capture aunque la consulta se conserve
+		QueryCallback callback = std::move(then);
+		then = nullptr;
+		if (!cancelled && callback) callback(success, results, affectedRows);
+
+		return true;
+	}
+};
+
+inline std::shared_ptr<MySQLConnector::PendingQuery> MySQLConnector::startQuery(BatchStatement statement, QueryCallback then)
+{
+	auto pending = std::make_shared<PendingQuery>(shared_from_this(), std::move(statement), std::move(then));
+	NonblockingPoller::Get().add(pending);
+	return pending;
+}
 
-#endif
\ No newline at end of file
+#endif
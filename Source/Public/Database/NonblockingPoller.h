@@ -0,0 +1,138 @@
+#ifndef NONBLOCKINGPOLLER_H
+#define NONBLOCKINGPOLLER_H
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <API/ARK/Ark.h> // requerido en GetLog y Log
+
+/**
+ * @class NonblockingTask
+ * @brief Operación que avanza por pasos sin bloquear el hilo que la ejecuta.
+ */
+class NonblockingTask
+{
+public:
+	virtual ~NonblockingTask() = default;
+
+	/**
+	 * @brief Avanza la operación todo lo posible sin esperar.
+	 *
+	 * @return true si la operación terminó y puede descartarse.
+	 */
+	virtual bool step() = 0;
+};
+
+/**
+ * @class NonblockingPoller
+ * @brief Avanza en el hilo del juego las operaciones no bloqueantes pendientes.
+ *
+ * Las operaciones se agregan desde cualquier hilo y poll(), llamado desde
+ * el tick del servidor, da un paso a cada una. Las continuaciones de las
+ * operaciones se ejecutan dentro de step(), por lo que corren en el hilo
+ * del juego igual que las de AsyncDatabase.
+ */
+class NonblockingPoller
+{
+public:
+	/**
+	 * @brief Obtiene la instancia única del planificador.
+	 *
+	 * @return Referencia al planificador de operaciones no bloqueantes del plugin.
+	 */
+	static NonblockingPoller& Get()
+	{
+		static NonblockingPoller instance;
+		return instance;
+	}
+
+	NonblockingPoller(const NonblockingPoller&) = delete;
+	NonblockingPoller& operator=(const NonblockingPoller&) = delete;
+
+	/**
+	 * @brief Agrega una operación, que dará su primer paso en el siguiente poll().
+	 *
+	 * @param task Operación a avanzar.
+	 */
+	void add(std::shared_ptr<NonblockingTask> task)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		incoming.push_back(std::move(task));
+	}
+
+	/**
+	 * @brief Da un paso a cada operación pendiente y descarta las terminadas.
+	 *
+	 * Debe llamarse desde el tick del servidor. Las operaciones agregadas
+	 * durante el paso, por ejemplo desde una continuación, esperan al
+	 * siguiente poll().
+	 */
+	void poll()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (incoming.empty() && tasks.empty()) return;
+
+			for (auto& task : incoming) tasks.push_back(std::move(task));
+			incoming.clear();
+		}
+
+		size_t kept = 0;
+		for (size_t i = 0; i < tasks.size(); i++)
+		{
+			bool finished = true;
+
+			try
+			{
+				finished = tasks[i]->step();
+			}
+			catch (const std::exception& error)
+			{
+				Log::GetLog()->error("Error en operación no bloqueante de base de datos: {}", error.what());
+			}
+
+			if (!finished) tasks[kept++] = std::move(tasks[i]);
+		}
+
+		tasks.resize(kept);
+	}
+
+	/**
+	 * @brief Descarta las operaciones pendientes sin ejecutar sus continuaciones.
+	 *
+	 * Se llama al descargar el plugin, antes de cerrar las conexiones.
+	 */
+	void clear()
+	{
+		std::vector<std::shared_ptr<NonblockingTask>> discarded;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			discarded.swap(incoming);
+		}
+
+		tasks.clear();
+	}
+
+	/**
+	 * @brief Número de operaciones pendientes, incluidas las que aún no dieron su primer paso.
+	 */
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return tasks.size() + incoming.size();
+	}
+
+private:
+	NonblockingPoller() = default;
+
+	std::mutex mutex;
+	std::vector<std::shared_ptr<NonblockingTask>> incoming;
+
+	// Solo se usa desde el hilo del juego
+	std::vector<std::shared_ptr<NonblockingTask>> tasks;
+};
+
+#endif // NONBLOCKINGPOLLER_H
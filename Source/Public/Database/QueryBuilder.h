@@ -0,0 +1,166 @@
+#ifndef QUERYBUILDER_H
+#define QUERYBUILDER_H
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+/**
+ * @class QueryBuilder
+ * @brief Construye el texto de una consulta en un búfer reutilizable del hilo.
+ *
+ * Cada hilo conserva sus búferes entre consultas, por lo que construir
+ * una consulta no reserva memoria una vez que el búfer alcanzó el tamaño
+ * de las consultas habituales. Los valores se escapan directamente en el
+ * búfer, sin cadenas intermedias. Los constructores pueden anidarse en el
+ * mismo hilo: cada nivel usa su propio búfer.
+ *
+ * El texto solo es válido mientras el objeto existe.
+ */
+class QueryBuilder
+{
+public:
+	QueryBuilder()
+		: level(depth()++)
+	{
+		std::vector<std::unique_ptr<fmt::memory_buffer>>& buffers = pool();
+		if (buffers.size() <= level) buffers.resize(level + 1);
+		if (!buffers[level]) buffers[level] = std::make_unique<fmt::memory_buffer>();
+
+		buffer = buffers[level].get();
+		buffer->clear();
+	}
+
+	QueryBuilder(const QueryBuilder&) = delete;
+	QueryBuilder& operator=(const QueryBuilder&) = delete;
+
+	~QueryBuilder()
+	{
+		// Un búfer que creció por una consulta excepcional se libera para no retenerlo
+		if (buffer->capacity() > MAX_RETAINED_CAPACITY) pool()[level].reset();
+		depth()--;
+	}
+
+	/**
+	 * @brief Añade texto sin escapar, como palabras clave o nombres de columnas.
+	 */
+	QueryBuilder& append(std::string_view text)
+	{
+		buffer->append(text.data(), text.data() + text.size());
+		return *this;
+	}
+
+	QueryBuilder& append(char c)
+	{
+		buffer->push_back(c);
+		return *this;
+	}
+
+	/**
+	 * @brief Añade un valor escapado para SQLite, duplicando las comillas simples.
+	 *
+	 * Los tramos sin comillas se copian de una sola vez.
+	 */
+	QueryBuilder& appendEscaped(std::string_view value)
+	{
+		size_t start = 0;
+		for (size_t quote = value.find('\''); quote != std::string_view::npos; quote = value.find('\'', start))
+		{
+			append(value.substr(start, quote + 1 - start));
+			buffer->push_back('\'');
+			start = quote + 1;
+		}
+
+		return append(value.substr(start));
+	}
+
+	/**
+	 * @brief Añade un valor escapado por una función externa, como mysql_real_escape_string.
+	 *
+	 * @param maxLength Longitud máxima que puede escribir la función, incluido un terminador.
+	 * @param escape Función que recibe el destino y devuelve la longitud escrita.
+	 */
+	template <typename Escape>
+	QueryBuilder& appendEscaped(size_t maxLength, Escape&& escape)
+	{
+		size_t start = buffer->size();
+		buffer->resize(start + maxLength);
+		buffer->resize(start + static_cast<size_t>(escape(buffer->data() + start)));
+		return *this;
+	}
+
+	/**
+	 * @brief Añade un valor escapado para SQLite entre comillas simples.
+	 */
+	QueryBuilder& appendQuoted(std::string_view value)
+	{
+		buffer->push_back('\'');
+		appendEscaped(value);
+		buffer->push_back('\'');
+		return *this;
+	}
+
+	template <typename Escape>
+	QueryBuilder& appendQuoted(size_t maxLength, Escape&& escape)
+	{
+		buffer->push_back('\'');
+		appendEscaped(maxLength, std::forward<Escape>(escape));
+		buffer->push_back('\'');
+		return *this;
+	}
+
+	/**
+	 * @brief Texto de la consulta terminado en nulo, para las API de C.
+	 */
+	const char* c_str()
+	{
+		buffer->push_back('\0');
+		buffer->resize(buffer->size() - 1);
+		return buffer->data();
+	}
+
+	std::string_view view() const
+	{
+		return std::string_view(buffer->data(), buffer->size());
+	}
+
+	/**
+	 * @brief Copia el texto a una cadena propia, que sobrevive al constructor.
+	 */
+	std::string str() const
+	{
+		return std::string(buffer->data(), buffer->size());
+	}
+
+	size_t size() const
+	{
+		return buffer->size();
+	}
+
+private:
+	static constexpr size_t MAX_RETAINED_CAPACITY = 64 * 1024;
+
+	fmt::memory_buffer* buffer;
+	size_t level;
+
+	static std::vector<std::unique_ptr<fmt::memory_buffer>>& pool()
+	{
+		static thread_local std::vector<std::unique_ptr<fmt::memory_buffer>> buffers;
+		return buffers;
+	}
+
+	static size_t& depth()
+	{
+		static thread_local size_t value = 0;
+		return value;
+	}
+};
+
+#endif // QUERYBUILDER_H
@@ -0,0 +1,396 @@
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+#include <API/ARK/Ark.h> // requerido en GetLog y Log
+
+/**
+ * @class LatencyHistogram
+ * @brief Histograma de latencias con precisión relativa constante.
+ *
+ * Igual que un histograma HDR, cada potencia de dos se divide en 16
+ * sub-intervalos, de modo que el error de un percentil es menor al 7%
+ * desde 1 µs hasta más de un día. Los contadores son atómicos y record()
+ * no reserva memoria ni toma bloqueos.
+ */
+class LatencyHistogram
+{
+public:
+	/**
+	 * @brief Registra una medición.
+	 *
+	 * @param micros Duración en microsegundos.
+	 */
+	void record(uint64_t micros)
+	{
+		buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+		count.fetch_add(1, std::memory_order_relaxed);
+
+		uint64_t previous = max.load(std::memory_order_relaxed);
+		while (micros > previous && !max.compare_exchange_weak(previous, micros, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	/**
+	 * @brief Calcula un percentil.
+	 *
+	 * @param percentile Percentil entre 0 y 1.
+	 * @return Límite superior del intervalo que contiene el percentil, en microsegundos.
+	 */
+	uint64_t percentile(double percentile) const
+	{
+		uint64_t total = count.load(std::memory_order_relaxed);
+		if (total == 0) return 0;
+
+		uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * total + 0.5));
+		uint64_t seen = 0;
+		for (size_t i = 0; i < BUCKETS; i++)
+		{
+			seen += buckets[i].load(std::memory_order_relaxed);
+			if (seen >= target) return std::min(bucketUpperBound(i), maxValue());
+		}
+
+		return maxValue();
+	}
+
+	uint64_t total() const { return count.load(std::memory_order_relaxed); }
+
+	uint64_t maxValue() const { return max.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Pone todos los contadores a cero.
+	 */
+	void reset()
+	{
+		for (auto& bucket : buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		count.store(0, std::memory_order_relaxed);
+		max.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr int SUB_BITS = 4;
+	static constexpr uint64_t SUB_COUNT = 1 << SUB_BITS;
+	static constexpr int MAX_EXPONENT = 40;
+	static constexpr size_t BUCKETS = SUB_COUNT + (MAX_EXPONENT - SUB_BITS + 1) * SUB_COUNT;
+
+	std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+	std::atomic<uint64_t> count{ 0 };
+	std::atomic<uint64_t> max{ 0 };
+
+	static int highestBit(uint64_t value)
+	{
+		int bit = 0;
+		while (value >>= 1) bit++;
+		return bit;
+	}
+
+	static size_t bucketIndex(uint64_t value)
+	{
+		if (value < SUB_COUNT) return static_cast<size_t>(value);
+
+		int exponent = std::min(highestBit(value), MAX_EXPONENT);
+		uint64_t sub = (value >> (exponent - SUB_BITS)) & (SUB_COUNT - 1);
+
+		return static_cast<size_t>(SUB_COUNT + (exponent - SUB_BITS) * SUB_COUNT + sub);
+	}
+
+	static uint64_t bucketUpperBound(size_t index)
+	{
+		if (index < SUB_COUNT) return index;
+
+		int exponent = static_cast<int>((index - SUB_COUNT) / SUB_COUNT) + SUB_BITS;
+		uint64_t sub = (index - SUB_COUNT) % SUB_COUNT;
+
+		return ((SUB_COUNT + sub + 1) << (exponent - SUB_BITS)) - 1;
+	}
+};
+
+/**
+ * @class QueryStats
+ * @brief Latencias de las consultas por operación y por tabla, y registro de consultas lentas.
+ *
+ * Los conectores miden cada sentencia con QueryTimer. La operación es la
+ * primera palabra de la consulta (SELECT, INSERT...) y la tabla la que
+ * sigue a FROM, INTO, UPDATE o TABLE. Las consultas que superan el umbral
+ * se registran con los literales reemplazados por '?'.
+ */
+class QueryStats
+{
+public:
+	/**
+	 * @brief Obtiene la instancia única de las estadísticas.
+	 *
+	 * @return Referencia a las estadísticas de consultas del plugin.
+	 */
+	static QueryStats& Get()
+	{
+		static QueryStats instance;
+		return instance;
+	}
+
+	/**
+	 * @brief Define el umbral del registro de consultas lentas.
+	 *
+	 * @param slowQueryMs Milisegundos a partir de los cuales se registra una consulta; 0 lo desactiva.
+	 */
+	void configure(unsigned int slowQueryMs)
+	{
+		slowQueryMicros.store(static_cast<uint64_t>(slowQueryMs) * 1000, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Registra la duración de una consulta.
+	 *
+	 * @param query Texto SQL de la consulta.
+	 * @param micros Duración en microsegundos.
+	 */
+	void record(std::string_view query, uint64_t micros)
+	{
+		std::string operation;
+		std::string table;
+		classify(query, operation, table);
+
+		histogram(operations, operation).record(micros);
+		if (!table.empty()) histogram(tables, table).record(micros);
+
+		uint64_t threshold = slowQueryMicros.load(std::memory_order_relaxed);
+		if (threshold > 0 && micros >= threshold)
+		{
+			Log::GetLog()->warn("Consulta lenta ({} ms): {}", micros / 1000.0, normalize(query));
+		}
+	}
+
+	/**
+	 * @brief Genera un resumen con los percentiles de cada operación y tabla.
+	 *
+	 * @return Texto con una línea por operación y por tabla.
+	 */
+	std::string report()
+	{
+		std::string text;
+
+		auto append = [&text](const char* title, const std::map<std::string, std::unique_ptr<LatencyHistogram>>& histograms)
+		{
+			for (const auto& [name, histogram] : histograms)
+			{
+				if (histogram->total() == 0) continue;
+
+				text += fmt::format("{} {}: n={} p50={:.2f}ms p95={:.2f}ms p99={:.2f}ms max={:.2f}ms\n", title, name, histogram->total(),
+					histogram->percentile(0.50) / 1000.0, histogram->percentile(0.95) / 1000.0, histogram->percentile(0.99) / 1000.0, histogram->maxValue() / 1000.0);
+			}
+		};
+
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		append("op", operations);
+		append("tabla", tables);
+
+		if (text.empty()) text = "Sin consultas registradas.\n";
+
+		return text;
+	}
+
+	/**
+	 * @brief Pone a cero todos los histogramas.
+	 */
+	void reset()
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		for (auto& [name, histogram] : operations) histogram->reset();
+		for (auto& [name, histogram] : tables) histogram->reset();
+	}
+
+	/**
+	 * @brief Reemplaza los literales de una consulta por '?' y compacta los espacios.
+	 *
+	 * Agrupa en el registro las consultas que solo difieren en sus valores
+	 * y evita escribir datos de los jugadores en el log.
+	 *
+	 * @param query Texto SQL de la consulta.
+	 * @return Consulta normalizada.
+	 */
+	static std::string normalize(std::string_view query)
+	{
+		std::string result;
+		result.reserve(query.size());
+
+		for (size_t i = 0; i < query.size(); i++)
+		{
+			char c = query[i];
+
+			if (c == '\'' || c == '"')
+			{
+				// Literal de texto, con comillas duplicadas o escapadas
+				size_t j = i + 1;
+				while (j < query.size())
+				{
+					if (query[j] == '\\') j++;
+					else if (query[j] == c)
+					{
+						if (j + 1 < query.size() && query[j + 1] == c) j++;
+						else break;
+					}
+					j++;
+				}
+				result += '?';
+				i = j;
+			}
+			else if (std::isdigit(static_cast<unsigned char>(c)) && (result.empty() || !isIdentifier(result.back())))
+			{
+				while (i + 1 < query.size() && (std::isalnum(static_cast<unsigned char>(query[i + 1])) || query[i + 1] == '.')) i++;
+				result += '?';
+			}
+			else if (std::isspace(static_cast<unsigned char>(c)))
+			{
+				if (!result.empty() && result.back() != ' ') result += ' ';
+			}
+			else
+			{
+				result += c;
+			}
+		}
+
+		while (!result.empty() && result.back() == ' ') result.pop_back();
+
+		return result;
+	}
+
+	/**
+	 * @brief Obtiene la operación y la tabla de una consulta.
+	 *
+	 * @param query Texto SQL de la consulta.
+	 * @param operation Primera palabra en mayúsculas, como SELECT o INSERT, o "?" si no hay ninguna.
+	 * @param table Palabra que sigue a FROM, INTO, UPDATE o TABLE, o vacío si no hay ninguna.
+	 */
+	static void classify(std::string_view query, std::string& operation, std::string& table)
+	{
+		std::string previous;
+		size_t i = 0;
+
+		while (i < query.size())
+		{
+			while (i < query.size() && !isIdentifier(query[i]) && query[i] != '`') i++;
+
+			std::string word;
+			while (i < query.size() && (isIdentifier(query[i]) || query[i] == '`' || query[i] == '.'))
+			{
+				if (query[i] != '`') word += query[i];
+				i++;
+			}
+
+			if (word.empty()) continue;
+
+			if (operation.empty())
+			{
+				operation = upper(word);
+			}
+			else if (previous == "FROM" || previous == "INTO" || previous == "UPDATE" || previous == "TABLE")
+			{
+				table = word;
+				return;
+			}
+
+			previous = upper(word);
+		}
+
+		if (operation.empty()) operation = "?";
+	}
+
+private:
+	QueryStats() = default;
+
+	std::shared_mutex mutex;
+	std::map<std::string, std::unique_ptr<LatencyHistogram>> operations;
+	std::map<std::string, std::unique_ptr<LatencyHistogram>> tables;
+	std::atomic<uint64_t> slowQueryMicros{ 0 };
+
+	static bool isIdentifier(char c)
+	{
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+	}
+
+	/**
+	 * @brief Obtiene o crea el histograma de una clave.
+	 *
+	 * Los histogramas nunca se eliminan, por lo que la referencia sigue
+	 * siendo válida después de soltar el bloqueo.
+	 */
+	LatencyHistogram& histogram(std::map<std::string, std::unique_ptr<LatencyHistogram>>& histograms, const std::string& key)
+	{
+		{
+			std::shared_lock<std::shared_mutex> lock(mutex);
+			auto it = histograms.find(key);
+			if (it != histograms.end()) return *it->second;
+		}
+
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		auto& histogram = histograms[key];
+		if (histogram == nullptr) histogram = std::make_unique<LatencyHistogram>();
+
+		return *histogram;
+	}
+
+	static std::string upper(std::string value)
+	{
+		std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+		return value;
+	}
+};
+
+/**
+ * @class QueryTimer
+ * @brief Mide una consulta desde su construcción hasta su destrucción.
+ *
+ * Solo registra el temporizador más externo de cada hilo, de modo que una
+ * operación que llama a otra del mismo conector se cuenta una sola vez.
+ */
+class QueryTimer
+{
+public:
+	explicit QueryTimer(std::string_view query)
+		: query(query), start(std::chrono::steady_clock::now()), outermost(depth()++ == 0)
+	{
+	}
+
+	QueryTimer(const QueryTimer&) = delete;
+	QueryTimer& operator=(const QueryTimer&) = delete;
+
+	~QueryTimer()
+	{
+		depth()--;
+		if (!outermost) return;
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		QueryStats::Get().record(query, static_cast<uint64_t>(elapsed.count()));
+	}
+
+private:
+	std::string_view query;
+	std::chrono::steady_clock::time_point start;
+	bool outermost;
+
+	static int& depth()
+	{
+		static thread_local int value = 0;
+		return value;
+	}
+};
+
+#endif // QUERYSTATS_H
@@ -0,0 +1,296 @@
+#ifndef RESULTSET_H
+#define RESULTSET_H
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ResultSet
+ * @brief Resultado de una consulta con almacenamiento compacto.
+ *
+ * Los nombres de columna se guardan una sola vez junto con una tabla
+ * nombre → índice. Los valores de todas las filas se copian de forma
+ * contigua en un único búfer y cada celda solo guarda su posición y
+ * longitud, por lo que leer una tabla grande no reserva memoria por fila.
+ * Los valores se obtienen como string_view o con conversiones tipadas
+ * que devuelven std::nullopt cuando la celda es NULL o no es convertible.
+ *
+ * Las vistas devueltas son válidas mientras el ResultSet no se modifique.
+ */
+class ResultSet
+{
+public:
+	/**
+	 * @brief Define las columnas del resultado y elimina las filas anteriores.
+	 *
+	 * @param names Nombres de las columnas en el orden de la consulta.
+	 */
+	void setColumns(std::vector<std::string> names)
+	{
+		clear();
+
+		columns = std::move(names);
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			columnIndexes.emplace(columns[i], i);
+		}
+	}
+
+	/**
+	 * @brief Reserva espacio para un número estimado de filas.
+	 *
+	 * @param rows Número de filas esperado.
+	 */
+	void reserve(size_t rows)
+	{
+		cells.reserve(rows * columns.size());
+	}
+
+	/**
+	 * @brief Agrega el valor de la siguiente celda de la fila actual.
+	 *
+	 * Las posiciones se guardan en 32 bits, por lo que un resultado de más
+	 * de 4 GiB no cabe: el valor se rechaza en lugar de leerse mal después.
+	 *
+	 * @param data Puntero al valor en texto.
+	 * @param length Longitud del valor en bytes.
+	 * @return false si el valor no cabe en el ResultSet.
+	 */
+	bool addValue(const char* data, size_t length)
+	{
+		// NULL_CELL queda reservado para las celdas NULL
+		if (length >= NULL_CELL || arena.size() > NULL_CELL - 1 - length) return false;
+
+		cells.push_back({ static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(length) });
+		arena.append(data, length);
+		return true;
+	}
+
+	/**
+	 * @brief Agrega una celda NULL a la fila actual.
+	 */
+	void addNull()
+	{
+		cells.push_back({ 0, NULL_CELL });
+	}
+
+	/**
+	 * @brief Elimina las filas y conserva las columnas y la memoria reservada.
+	 *
+	 * Permite reutilizar el mismo ResultSet para cada fila de una lectura
+	 * por streaming sin volver a reservar memoria.
+	 */
+	void clearRows()
+	{
+		cells.clear();
+		arena.clear();
+	}
+
+	/**
+	 * @brief Elimina filas y columnas.
+	 */
+	void clear()
+	{
+		columns.clear();
+		columnIndexes.clear();
+		cells.clear();
+		arena.clear();
+	}
+
+	bool empty() const { return rowCount() == 0; }
+
+	size_t rowCount() const { return columns.empty() ? 0 : cells.size() / columns.size(); }
+
+	size_t columnCount() const { return columns.size(); }
+
+	const std::string& columnName(size_t column) const { return columns[column]; }
+
+	/**
+	 * @brief Busca el índice de una columna por su nombre.
+	 *
+	 * @param name Nombre de la columna.
+	 * @return Índice de la columna, o -1 si no existe.
+	 */
+	int columnIndex(std::string_view name) const
+	{
+		auto it = columnIndexes.find(name);
+		return it == columnIndexes.end() ? -1 : static_cast<int>(it->second);
+	}
+
+	/**
+	 * @brief Indica si una celda es NULL.
+	 *
+	 * @param row Índice de la fila.
+	 * @param column Índice de la columna.
+	 * @return true si la celda es NULL.
+	 */
+	bool isNull(size_t row, size_t column) const
+	{
+		return cell(row, column).length == NULL_CELL;
+	}
+
+	bool isNull(size_t row, std::string_view column) const
+	{
+		int index = columnIndex(column);
+		return index < 0 || isNull(row, static_cast<size_t>(index));
+	}
+
+	/**
+	 * @brief Obtiene el texto de una celda.
+	 *
+	 * @param row Índice de la fila.
+	 * @param column Índice de la columna.
+	 * @return Vista del valor, vacía si la celda es NULL.
+	 */
+	std::string_view getString(size_t row, size_t column) const
+	{
+		const Cell& value = cell(row, column);
+		if (value.length == NULL_CELL) return {};
+
+		return std::string_view(arena.data() + value.offset, value.length);
+	}
+
+	std::string_view getString(size_t row, std::string_view column) const
+	{
+		int index = columnIndex(column);
+		return index < 0 ? std::string_view{} : getString(row, static_cast<size_t>(index));
+	}
+
+	/**
+	 * @brief Obtiene una celda como entero de 64 bits.
+	 *
+	 * @param row Índice de la fila.
+	 * @param column Índice de la columna.
+	 * @return El valor, o std::nullopt si es NULL o no es un entero.
+	 */
+	std::optional<int64_t> getInt64(size_t row, size_t column) const
+	{
+		if (isNull(row, column)) return std::nullopt;
+
+		std::string_view text = getString(row, column);
+		int64_t value = 0;
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc() || end == text.data()) return std::nullopt;
+
+		return value;
+	}
+
+	std::optional<int64_t> getInt64(size_t row, std::string_view column) const
+	{
+		int index = columnIndex(column);
+		return index < 0 ? std::nullopt : getInt64(row, static_cast<size_t>(index));
+	}
+
+	/**
+	 * @brief Obtiene una celda como número de punto flotante.
+	 *
+	 * @param row Índice de la fila.
+	 * @param column Índice de la columna.
+	 * @return El valor, o std::nullopt si es NULL o no es un número.
+	 */
+	std::optional<double> getDouble(size_t row, size_t column) const
+	{
+		if (isNull(row, column)) return std::nullopt;
+
+		std::string_view text = getString(row, column);
+		double value = 0;
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc() || end == text.data()) return std::nullopt;
+
+		return value;
+	}
+
+	std::optional<double> getDouble(size_t row, std::string_view column) const
+	{
+		int index = columnIndex(column);
+		return index < 0 ? std::nullopt : getDouble(row, static_cast<size_t>(index));
+	}
+
+	/**
+	 * @brief Obtiene una celda como booleano.
+	 *
+	 * Acepta valores numéricos (0 es falso) y "true"/"false".
+	 *
+	 * @param row Índice de la fila.
+	 * @param column Índice de la columna.
+	 * @return El valor, o std::nullopt si es NULL o no es convertible.
+	 */
+	std::optional<bool> getBool(size_t row, size_t column) const
+	{
+		if (isNull(row, column)) return std::nullopt;
+
+		std::optional<int64_t> number = getInt64(row, column);
+		if (number) return *number != 0;
+
+		std::string_view text = getString(row, column);
+		auto equals = [text](std::string_view word)
+		{
+			return std::equal(text.begin(), text.end(), word.begin(), word.end(), [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+		};
+
+		if (equals("true")) return true;
+		if (equals("false")) return false;
+
+		return std::nullopt;
+	}
+
+	std::optional<bool> getBool(size_t row, std::string_view column) const
+	{
+		int index = columnIndex(column);
+		return index < 0 ? std::nullopt : getBool(row, static_cast<size_t>(index));
+	}
+
+private:
+	/**
+	 * @struct Cell
+	 * @brief Posición de un valor dentro del búfer contiguo.
+	 */
+	struct Cell
+	{
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	/**
+	 * @struct NameHash
+	 * @brief Hash transparente para buscar columnas con string_view sin copiar.
+	 */
+	struct NameHash
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+	};
+
+	static constexpr uint32_t NULL_CELL = (std::numeric_limits<uint32_t>::max)();
+
+	std::vector<std::string> columns;
+	std::unordered_map<std::string, size_t, NameHash, std::equal_to<>> columnIndexes;
+	std::vector<Cell> cells;
+	std::string arena;
+
+	const Cell& cell(size_t row, size_t column) const
+	{
+		return cells[row * columns.size() + column];
+	}
+};
+
+/**
+ * @brief Función que recibe cada fila de una lectura por streaming.
+ *
+ * El ResultSet contiene solo la fila actual (índice 0) y se reutiliza en la
+ * siguiente llamada. Devolver false detiene la lectura.
+ */
+using RowVisitor = std::function<bool(const ResultSet& row)>;
+
+#endif // RESULTSET_H
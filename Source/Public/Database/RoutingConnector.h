@@ -0,0 +1,370 @@
+#ifndef ROUTINGCONNECTOR_H
+#define ROUTINGCONNECTOR_H
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ForwardingConnector.h"
+
+/**
+ * @class ReadAffinity
+ * @brief Asocia las consultas del hilo actual a una clave, normalmente el EosId del jugador.
+ *
+ * Mientras el objeto existe, RoutingConnector recuerda las escrituras de
+ * la clave y envía sus lecturas al servidor principal durante la ventana
+ * configurada, para que el jugador vea sus propios cambios aunque la
+ * réplica vaya atrasada. Los ámbitos pueden anidarse.
+ */
+class ReadAffinity
+{
+public:
+	explicit ReadAffinity(std::string key)
+		: previous(std::move(current()))
+	{
+		current() = std::move(key);
+	}
+
+	ReadAffinity(const ReadAffinity&) = delete;
+	ReadAffinity& operator=(const ReadAffinity&) = delete;
+
+	~ReadAffinity()
+	{
+		current() = std::move(previous);
+	}
+
+	/**
+	 * @brief Clave del ámbito activo en el hilo actual.
+	 *
+	 * @return La clave, o una cadena vacía si no hay ámbito.
+	 */
+	static std::string& current()
+	{
+		static thread_local std::string key;
+		return key;
+	}
+
+private:
+	std::string previous;
+};
+
+/**
+ * @class PrimaryRead
+ * @brief Envía al servidor principal todas las lecturas del hilo actual.
+ *
+ * Se usa en las lecturas que no pueden ver datos atrasados, como la
+ * versión del esquema antes de aplicar migraciones. Los ámbitos pueden
+ * anidarse.
+ */
+class PrimaryRead
+{
+public:
+	PrimaryRead()
+	{
+		depth()++;
+	}
+
+	PrimaryRead(const PrimaryRead&) = delete;
+	PrimaryRead& operator=(const PrimaryRead&) = delete;
+
+	~PrimaryRead()
+	{
+		depth()--;
+	}
+
+	/**
+	 * @brief Indica si hay algún ámbito activo en el hilo actual.
+	 */
+	static bool active()
+	{
+		return depth() > 0;
+	}
+
+private:
+	static int& depth()
+	{
+		static thread_local int value = 0;
+		return value;
+	}
+};
+
+/**
+ * @class RoutingConnector
+ * @brief Envía las lecturas a réplicas y las escrituras al servidor principal.
+ *
+ * Cada lectura va a la réplica sana con menos consultas en curso. Una
+ * réplica que falla se marca como no disponible durante unos segundos y
+ * la lectura se repite en el principal. Las lecturas dentro de una
+ * transacción, dentro de un ámbito PrimaryRead, o de una clave de
+ * ReadAffinity escrita hace menos de la ventana de lectura de las propias
+ * escrituras, van siempre al principal.
+ */
+class RoutingConnector : public ForwardingConnector
+{
+public:
+	/**
+	 * @brief Constructor con el servidor principal y sus réplicas.
+	 *
+	 * @param primary Conector del servidor principal, recibe todas las escrituras.
+	 * @param replicas Conectores de las réplicas de solo lectura.
+	 * @param stickiness Tiempo tras una escritura durante el que las lecturas de la misma clave van al principal.
+	 * @param retryDelay Tiempo que una réplica que falló queda fuera de la rotación.
+	 */
+	RoutingConnector(std::shared_ptr<IDatabaseConnector> primary, std::vector<std::shared_ptr<IDatabaseConnector>> replicas,
+		std::chrono::milliseconds stickiness, std::chrono::milliseconds retryDelay = std::chrono::seconds(10))
+		: ForwardingConnector(std::move(primary)), stickiness(stickiness), retryDelay(retryDelay)
+	{
+		for (auto& replica : replicas)
+		{
+			this->replicas.push_back(std::make_unique<Replica>(std::move(replica)));
+		}
+	}
+
+	bool create(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data)
+	{
+		return written(inner->create(tableName, data));
+	}
+
+	bool read(const std::string& query, ResultSet& results)
+	{
+		return routeRead([&](IDatabaseConnector& connector)
+		{
+			results.clear();
+			return connector.read(query, results);
+		});
+	}
+
+	bool update(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data, const std::string& condition)
+	{
+		return written(inner->update(tableName, data, condition));
+	}
+
+	bool deleteRow(const std::string& tableName, const std::string& condition)
+	{
+		return written(inner->deleteRow(tableName, condition));
+	}
+
+	bool prepare(const std::string& query)
+	{
+		for (auto& replica : replicas)
+		{
+			replica->connector->prepare(query);
+		}
+
+		return inner->prepare(query);
+	}
+
+	bool execute(const std::string& query, const DbParams& params)
+	{
+		return written(inner->execute(query, params));
+	}
+
+	bool read(const std::string& query, const DbParams& params, ResultSet& results)
+	{
+		return routeRead([&](IDatabaseConnector& connector)
+		{
+			results.clear();
+			return connector.read(query, params, results);
+		});
+	}
+
+	/**
+	 * @brief Lee fila por fila desde una réplica.
+	 *
+	 * Si la réplica falla después de entregar filas al visitante la lectura
+	 * no se repite en el principal, para no entregar filas duplicadas.
+	 */
+	bool forEachRow(const std::string& query, const DbParams& params, const RowVisitor& visitor)
+	{
+		size_t delivered = 0;
+		RowVisitor counting = [&](const ResultSet& row)
+		{
+			delivered++;
+			return visitor(row);
+		};
+
+		return routeRead([&](IDatabaseConnector& connector)
+		{
+			return connector.forEachRow(query, params, counting);
+		}, [&]() { return delivered == 0; });
+	}
+
+	bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns)
+	{
+		return written(inner->upsert(tableName, columns, rows, conflictKey, updateColumns));
+	}
+
+	bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results)
+	{
+		return written(inner->executeBatch(statements, results));
+	}
+
+	bool beginTransaction()
+	{
+		if (!inner->beginTransaction()) return false;
+
+		transactionDepth()++;
+		return true;
+	}
+
+	bool commit()
+	{
+		if (transactionDepth() > 0) transactionDepth()--;
+		return written(inner->commit());
+	}
+
+	bool rollback()
+	{
+		if (transactionDepth() > 0) transactionDepth()--;
+		return inner->rollback();
+	}
+
+private:
+	/**
+	 * @struct Replica
+	 * @brief Conector de una réplica con su carga y su estado.
+	 */
+	struct Replica
+	{
+		std::shared_ptr<IDatabaseConnector> connector;
+		std::atomic<int> inFlight{ 0 };
+		std::atomic<std::chrono::steady_clock::rep> unavailableUntil{ 0 };
+
+		explicit Replica(std::shared_ptr<IDatabaseConnector> connector)
+			: connector(std::move(connector))
+		{
+		}
+	};
+
+	std::vector<std::unique_ptr<Replica>> replicas;
+	std::chrono::steady_clock::duration stickiness;
+	std::chrono::steady_clock::duration retryDelay;
+	std::atomic<size_t> nextReplica{ 0 };
+
+	std::mutex writesMutex;
+	std::unordered_map<std::string, std::chrono::steady_clock::time_point> lastWrites;
+
+	/**
+	 * @brief Profundidad de las transacciones abiertas por el hilo actual.
+	 *
+	 * Es común a todos los RoutingConnector, por lo que una transacción en
+	 * una base de datos también envía al principal las lecturas de las
+	 * demás desde el mismo hilo.
+	 */
+	static int& transactionDepth()
+	{
+		static thread_local int depth = 0;
+		return depth;
+	}
+
+	/**
+	 * @brief Registra una escritura exitosa de la clave del ámbito actual.
+	 *
+	 * @param success Resultado de la escritura.
+	 * @return El mismo resultado.
+	 */
+	bool written(bool success)
+	{
+		const std::string& key = ReadAffinity::current();
+		if (!success || key.empty() || stickiness == std::chrono::steady_clock::duration::zero()) return success;
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(writesMutex);
+
+		// Las claves cuya ventana ya venció se eliminan cuando el mapa crece
+		if (lastWrites.size() >= 1024)
+		{
+			for (auto it = lastWrites.begin(); it != lastWrites.end();)
+			{
+				it = now - it->second >= stickiness ? lastWrites.erase(it) : std::next(it);
+			}
+		}
+
+		lastWrites[key] = now;
+		return success;
+	}
+
+	/**
+	 * @brief Indica si la lectura actual debe ir al servidor principal.
+	 */
+	bool readFromPrimary()
+	{
+		if (replicas.empty() || transactionDepth() > 0 || PrimaryRead::active()) return true;
+
+		const std::string& key = ReadAffinity::current();
+		if (key.empty()) return false;
+
+		std::lock_guard<std::mutex> lock(writesMutex);
+
+		auto it = lastWrites.find(key);
+		return it != lastWrites.end() && std::chrono::steady_clock::now() - it->second < stickiness;
+	}
+
+	/**
+	 * @brief Elige la réplica disponible con menos consultas en curso.
+	 *
+	 * La búsqueda empieza en una réplica distinta cada vez para repartir
+	 * las lecturas entre réplicas con la misma carga.
+	 *
+	 * @return La réplica elegida, o nullptr si ninguna está disponible.
+	 */
+	Replica* pickReplica()
+	{
+		std::chrono::steady_clock::rep now = std::chrono::steady_clock::now().time_since_epoch().count();
+		size_t start = nextReplica.fetch_add(1, std::memory_order_relaxed);
+
+		Replica* best = nullptr;
+		for (size_t i = 0; i < replicas.size(); i++)
+		{
+			Replica* replica = replicas[(start + i) % replicas.size()].get();
+			if (replica->unavailableUntil.load(std::memory_order_relaxed) > now) continue;
+
+			if (best == nullptr || replica->inFlight.load(std::memory_order_relaxed) < best->inFlight.load(std::memory_order_relaxed))
+			{
+				best = replica;
+			}
+		}
+
+		return best;
+	}
+
+	/**
+	 * @brief Ejecuta una lectura en una réplica o en el principal.
+	 *
+	 * @param operation Lectura a ejecutar sobre el conector elegido.
+	 * @param canRetry Indica si la lectura puede repetirse en el principal tras un fallo.
+	 * @return Resultado de la lectura.
+	 */
+	template <typename Operation, typename CanRetry>
+	bool routeRead(Operation&& operation, CanRetry&& canRetry)
+	{
+		Replica* replica = readFromPrimary() ? nullptr : pickReplica();
+		if (replica == nullptr) return operation(*inner);
+
+		replica->inFlight.fetch_add(1, std::memory_order_relaxed);
+		bool success = operation(*replica->connector);
+		replica->inFlight.fetch_sub(1, std::memory_order_relaxed);
+
+		if (success) return true;
+
+		replica->unavailableUntil.store((std::chrono::steady_clock::now() + retryDelay).time_since_epoch().count(), std::memory_order_relaxed);
+		Log::GetLog()->warn("Lectura fallida en una réplica. Se usará el servidor principal durante {} s.", std::chrono::duration_cast<std::chrono::seconds>(retryDelay).count());
+
+		return canRetry() && operation(*inner);
+	}
+
+	template <typename Operation>
+	bool routeRead(Operation&& operation)
+	{
+		return routeRead(std::forward<Operation>(operation), []() { return true; });
+	}
+};
+
+#endif // ROUTINGCONNECTOR_H
@@ -3,7 +3,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include "IDatabaseConnector.h"
+#include "QueryBuilder.h"
+#include "QueryStats.h"
+#include "SQLiteTuning.h"
+#include "StatementCache.h"
 #include "sqlite3/sqlite3.h"
 
 /**
@@ -14,6 +24,15 @@
  * proporcionar funcionalidad de conexión y operaciones con
  * bases de datos SQLite. Gestiona la conexión, ejecución de
  * consultas y procesamiento de resultados.
+ * 
+ * Cada operación pública se serializa con un mutex, por lo que el
+ * conector puede usarse desde los hilos de AsyncDatabase.
+ * 
+ * Opcionalmente abre, además de la conexión de escritura, un pool de
+ * conexiones de solo lectura sobre el mismo archivo en modo WAL. Las
+ * consultas que no modifican datos se ejecutan en ellas sin tomar el
+ * mutex, en paralelo entre sí y con las escrituras, y ven los datos de
+ * la última transacción confirmada.
  */
 class SQLiteConnector : public IDatabaseConnector
 {
@@ -25,13 +44,39 @@ public:
 	 * y trata de abrir la conexión con la base de datos.
 	 * 
 	 * @param dbName Ruta al archivo de la base de datos SQLite.
+	 * @param statementCacheSize Número máximo de sentencias preparadas a conservar.
+	 * @param tuning Opciones de rendimiento que se aplican al abrir la base de datos.
+	 * @param readConnections Número de conexiones de solo lectura; 0 ejecuta también las lecturas en la conexión de escritura.
 	 */
-	SQLiteConnector(const std::string& dbName)
+	SQLiteConnector(const std::string& dbName, size_t statementCacheSize = 32, const SQLiteTuning& tuning = SQLiteTuning(), size_t readConnections = 0)
+		: statements(statementCacheSize, [](sqlite3_stmt* stmt) { sqlite3_finalize(stmt); })
 	{
-		if (sqlite3_open(dbName.c_str(), &db) != SQLITE_OK)
+		// Con lectores la conexión de escritura ya se serializa con el mutex del conector
+		int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | (readConnections > 0 ? SQLITE_OPEN_NOMUTEX : 0);
+
+		if (sqlite3_open_v2(dbName.c_str(), &db, flags, nullptr) != SQLITE_OK)
 		{
 			printError("Fallo al abrir la base de datos SQLite");
 			db = nullptr;
+			return;
+		}
+
+		std::vector<std::string> errors;
+		tuning.apply(db, errors);
+		for (const std::string& error : errors)
+		{
+			Log::GetLog()->warn("Ajuste de SQLite no aplicado. {}", error);
+		}
+
+		if (tuning.walCheckpointSeconds > 0)
+		{
+			checkpointInterval = std::chrono::seconds(tuning.walCheckpointSeconds);
+			lastCheckpoint = std::chrono::steady_clock::now();
+		}
+
+		if (readConnections > 0)
+		{
+			openReaders(dbName, readConnections, statementCacheSize, tuning);
 		}
 	}
 	
@@ -44,6 +89,11 @@ public:
 	 */
 	~SQLiteConnector()
 	{
+		idleReaders.clear();
+
+		// Las sentencias deben finalizarse antes de cerrar la conexión
+		statements.clear();
+
 		if (db != nullptr)
 		{
 			sqlite3_close(db);
@@ -63,6 +113,8 @@ public:
 	 */
 	bool createTableIfNotExist(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
 	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
 		std::string query = "CREATE TABLE IF NOT EXISTS " + tableName + " (";
 
 		bool first = true;
@@ -93,6 +145,8 @@ public:
 	 */
 	bool alterTableIfNotExists(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
 	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
 		std::string query = "ALTER TABLE " + tableName + " ";
 
 		bool first = true;
@@ -122,8 +176,10 @@ public:
 	 * @param tableDefinition Definición de tabla (no utilizada).
 	 * @return Siempre retorna false ya que la operación no está soportada.
 	 */
-	bool reorderColumns(const std::string& tableName, const nlohmann::ordered_json& tableDefinition)
+	bool reorderColumns(const std::string& /*tableName*/, const nlohmann::ordered_json& /*tableDefinition*/)
 	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
 		return false;
 	}
 
@@ -139,37 +195,49 @@ public:
 	 */
 	bool create(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data)
 	{
-		std::string query = "INSERT INTO " + tableName + " (";
-		std::string values = " VALUES (";
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		QueryBuilder query;
+		query.append("INSERT INTO ").append(tableName).append(" (");
 
 		for (size_t i = 0; i < data.size(); i++)
 		{
-			query += data[i].first;
-			values += "'" + escapeString(data[i].second) + "'";
-			if (i < data.size() - 1)
-			{
-				query += ", ";
-				values += ", ";
-			}
+			if (i > 0) query.append(", ");
+			query.append(data[i].first);
 		}
 
-		query += ") " + values + ")";
+		query.append(") VALUES (");
 
-		return executeQuery(query);
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			if (i > 0) query.append(", ");
+			query.appendQuoted(data[i].second);
+		}
+
+		query.append(')');
+
+		return executeQuery(query.c_str());
 	}
 
 	/**
 	 * @brief Lee datos de la base de datos SQLite.
 	 * 
 	 * Este método ejecuta una consulta SELECT en la base de datos SQLite
-	 * y devuelve los resultados en un vector de mapas.
+	 * y devuelve los resultados en un ResultSet.
 	 * 
 	 * @param query Consulta SQL a ejecutar.
-	 * @param results Vector donde se almacenarán los resultados.
+	 * @param results ResultSet donde se almacenarán los resultados.
 	 * @return true si la operación fue exitosa, false en caso contrario.
 	 */
-	bool read(const std::string& query, std::vector<std::map<std::string, std::string>>& results)
+	bool read(const std::string& query, ResultSet& results)
 	{
+		QueryTimer timer(query);
+
+		bool success = false;
+		if (readOnReader(query, false, success, [&](sqlite3_stmt* stmt) { return readRows(stmt, results); })) return success;
+
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
 		sqlite3_stmt* stmt;
 
 		if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
@@ -178,22 +246,10 @@ public:
 			return false;
 		}
 
-		int numCols = sqlite3_column_count(stmt);
-		while (sqlite3_step(stmt) == SQLITE_ROW)
-		{
-			std::map<std::string, std::string> rowData;
-
-			for (int i = 0; i < numCols; i++)
-			{
-				const char* columnName = sqlite3_column_name(stmt, i);
-				const char* val = (const char*)sqlite3_column_text(stmt, i);
-				rowData[columnName] = val ? val : "NULL";
-			}
-			results.push_back(rowData);
-		}
+		success = readRows(stmt, results);
 
 		sqlite3_finalize(stmt);
-		return true;
+		return success;
 	}
 
 	/**
@@ -209,20 +265,20 @@ public:
 	 */
 	bool update(const std::string& tableName, const std::vector<std::pair<std::string, std::string>>& data, const std::string& condition)
 	{
-		std::string query = "UPDATE " + tableName + " SET ";
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		QueryBuilder query;
+		query.append("UPDATE ").append(tableName).append(" SET ");
 
 		for (size_t i = 0; i < data.size(); ++i)
 		{
-			query += data[i].first + " = '" + escapeString(data[i].second) + "'";
-			if (i < data.size() - 1)
-			{
-				query += ", ";
-			}
+			if (i > 0) query.append(", ");
+			query.append(data[i].first).append(" = ").appendQuoted(data[i].second);
 		}
 
-		query += " WHERE " + condition;
+		query.append(" WHERE ").append(condition);
 
-		return executeQuery(query);
+		return executeQuery(query.c_str());
 	}
 
 	/**
@@ -237,11 +293,346 @@ public:
 	 */
 	bool deleteRow(const std::string& tableName, const std::string& condition)
 	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
 		std::string query = "DELETE FROM " + tableName + " WHERE " + condition;
 
 		return executeQuery(query);
 	}
 
+	/**
+	 * @brief Prepara una sentencia y la guarda en la caché del conector.
+	 * 
+	 * La sentencia se compila con SQLITE_PREPARE_PERSISTENT y se reutiliza
+	 * en las siguientes llamadas con el mismo texto SQL.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @return true si la sentencia se preparó correctamente, false en caso contrario.
+	 */
+	bool prepare(const std::string& query)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		sqlite3_stmt* stmt = acquireStatement(query);
+		if (stmt == nullptr) return false;
+
+		releaseStatement(statements, query, stmt);
+		return true;
+	}
+
+	/**
+	 * @brief Ejecuta una sentencia preparada que no devuelve filas.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool execute(const std::string& query, const DbParams& params)
+	{
+		QueryTimer timer(query);
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		sqlite3_stmt* stmt = acquireStatement(query);
+		if (stmt == nullptr) return false;
+
+		if (!bindParams(stmt, params))
+		{
+			releaseStatement(statements, query, stmt);
+			return false;
+		}
+
+		int rc = sqlite3_step(stmt);
+		while (rc == SQLITE_ROW)
+		{
+			rc = sqlite3_step(stmt);
+		}
+
+		if (rc != SQLITE_DONE)
+		{
+			printError("Error en sentencia SQLite:");
+		}
+
+		releaseStatement(statements, query, stmt);
+
+		if (rc != SQLITE_DONE) return false;
+
+		checkpointIfDue();
+		return true;
+	}
+
+	/**
+	 * @brief Lee datos usando una sentencia preparada.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @return true si la operación fue exitosa, false en caso contrario.
+	 */
+	bool read(const std::string& query, const DbParams& params, ResultSet& results)
+	{
+		QueryTimer timer(query);
+
+		bool success = false;
+		if (readOnReader(query, true, success, [&](sqlite3_stmt* stmt) { return bindParams(stmt, params) && readRows(stmt, results); })) return success;
+
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		sqlite3_stmt* stmt = acquireStatement(query);
+		if (stmt == nullptr) return false;
+
+		success = bindParams(stmt, params) && readRows(stmt, results);
+
+		releaseStatement(statements, query, stmt);
+		return success;
+	}
+
+	/**
+	 * @brief Lee datos fila por fila con sqlite3_step.
+	 * 
+	 * La conexión queda bloqueada para otros hilos mientras dure la lectura.
+	 * La sentencia queda en uso durante la lectura, por lo que el visitante
+	 * puede ejecutar otras consultas, incluso la misma. Con conexiones de
+	 * solo lectura solo se ocupa el lector usado, y las lecturas del
+	 * visitante esperan a otro libre.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @param visitor Función que recibe cada fila.
+	 * @return true si la lectura terminó o fue detenida por el visitante, false si hubo un error.
+	 */
+	bool forEachRow(const std::string& query, const DbParams& params, const RowVisitor& visitor)
+	{
+		QueryTimer timer(query);
+		ResultSet row;
+
+		bool success = false;
+		if (readOnReader(query, true, success, [&](sqlite3_stmt* stmt) { return bindParams(stmt, params) && readRows(stmt, row, &visitor); })) return success;
+
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		sqlite3_stmt* stmt = acquireStatement(query);
+		if (stmt == nullptr) return false;
+
+		success = bindParams(stmt, params) && readRows(stmt, row, &visitor);
+
+		releaseStatement(statements, query, stmt);
+		return success;
+	}
+
+	/**
+	 * @brief Inserta varias filas o actualiza las que ya existen con ON CONFLICT DO UPDATE.
+	 * 
+	 * Cada lote tiene como máximo tantas filas como permite el límite de
+	 * parámetros de SQLite (SQLITE_LIMIT_VARIABLE_NUMBER).
+	 * 
+	 * @param tableName Nombre de la tabla.
+	 * @param columns Columnas a insertar.
+	 * @param rows Valores de cada fila, en el mismo orden que las columnas.
+	 * @param conflictKey Columna o columnas de la restricción UNIQUE o PRIMARY KEY.
+	 * @param updateColumns Columnas a actualizar si la fila ya existe; si está vacío se usa DO NOTHING.
+	 * @return true si todas las filas se escribieron, false en caso contrario.
+	 */
+	bool upsert(const std::string& tableName, const std::vector<std::string>& columns, const std::vector<DbParams>& rows, const std::string& conflictKey, const std::vector<std::string>& updateColumns)
+	{
+		if (rows.empty()) return true;
+		if (columns.empty())
+		{
+			Log::GetLog()->error("upsert en {} sin columnas", tableName);
+			return false;
+		}
+
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		std::string insert = "INSERT INTO " + tableName + " (";
+		std::string placeholders = "(";
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			insert += (i > 0 ? ", " : "") + columns[i];
+			placeholders += i > 0 ? ", ?" : "?";
+		}
+		insert += ") VALUES ";
+		placeholders += ")";
+
+		std::string conflict = " ON CONFLICT(" + conflictKey + ") DO ";
+		if (updateColumns.empty())
+		{
+			conflict += "NOTHING";
+		}
+		else
+		{
+			conflict += "UPDATE SET ";
+			for (size_t i = 0; i < updateColumns.size(); i++)
+			{
+				conflict += (i > 0 ? ", " : "") + updateColumns[i] + " = excluded." + updateColumns[i];
+			}
+		}
+
+		size_t maxVariables = static_cast<size_t>(sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+		size_t rowsPerChunk = std::max<size_t>(1, maxVariables / columns.size());
+
+		if (!beginTransaction()) return false;
+
+		for (size_t start = 0; start < rows.size(); start += rowsPerChunk)
+		{
+			size_t count = std::min(rowsPerChunk, rows.size() - start);
+
+			std::string query = insert;
+			DbParams params;
+			params.reserve(count * columns.size());
+
+			for (size_t i = start; i < start + count; i++)
+			{
+				if (rows[i].size() != columns.size())
+				{
+					Log::GetLog()->error("upsert en {}: la fila {} tiene {} valores, se esperaban {}", tableName, i, rows[i].size(), columns.size());
+					rollback();
+					return false;
+				}
+
+				query += (i > start ? ", " : "") + placeholders;
+				params.insert(params.end(), rows[i].begin(), rows[i].end());
+			}
+
+			query += conflict;
+
+			if (!execute(query, params))
+			{
+				rollback();
+				return false;
+			}
+		}
+
+		return commit();
+	}
+
+	/**
+	 * @brief Ejecuta varias sentencias en una transacción.
+	 * 
+	 * SQLite no tiene viajes de red que ahorrar: las sentencias se ejecutan
+	 * una a una con la caché de sentencias preparadas y se confirman
+	 * juntas, con el mismo resultado que el lote de MySQLConnector.
+	 * 
+	 * @param statements Sentencias con marcadores '?' y sus parámetros.
+	 * @param results Recibe un ResultSet por sentencia, vacío si la sentencia no devuelve filas.
+	 * @return true si todas las sentencias se ejecutaron y se confirmaron, false en caso contrario.
+	 */
+	bool executeBatch(const std::vector<BatchStatement>& statements, std::vector<ResultSet>& results)
+	{
+		results.assign(statements.size(), ResultSet());
+		if (!beginTransaction()) return false;
+
+		for (size_t i = 0; i < statements.size(); i++)
+		{
+			// read() también ejecuta las sentencias que no devuelven filas
+			if (!read(statements[i].query, statements[i].params, results[i]))
+			{
+				rollback();
+				return false;
+			}
+		}
+
+		return commit();
+	}
+
+	/**
+	 * @brief Inicia una transacción o un savepoint si ya hay una activa.
+	 * 
+	 * La conexión queda bloqueada para el hilo que llama hasta el commit o
+	 * rollback correspondiente, por lo que las operaciones de otros hilos
+	 * no se mezclan con la transacción. commit() y rollback() deben
+	 * llamarse desde el mismo hilo.
+	 * 
+	 * Se usa BEGIN IMMEDIATE para tomar el bloqueo de escritura al inicio:
+	 * así busy_timeout espera a otras conexiones en lugar de fallar con
+	 * SQLITE_BUSY al pasar de lectura a escritura dentro de la transacción.
+	 * Las lecturas del hilo que abrió la transacción usan la conexión de
+	 * escritura; las de otros hilos siguen en las conexiones de solo lectura.
+	 * 
+	 * @return true si la transacción se inició, false en caso contrario.
+	 */
+	bool beginTransaction()
+	{
+		mutex.lock();
+
+		std::string query = transactionDepth == 0 ? "BEGIN IMMEDIATE" : "SAVEPOINT sp_" + std::to_string(transactionDepth);
+
+		if (!executeQuery(query))
+		{
+			mutex.unlock();
+			return false;
+		}
+
+		// Las lecturas de este hilo deben ver sus propios cambios sin confirmar
+		if (transactionDepth++ == 0) transactionOwner.store(std::this_thread::get_id());
+		return true;
+	}
+
+	/**
+	 * @brief Confirma la transacción o libera el savepoint más reciente.
+	 * 
+	 * Si el COMMIT falla la transacción se revierte.
+	 * 
+	 * @return true si los cambios se confirmaron, false en caso contrario.
+	 */
+	bool commit()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		if (transactionDepth == 0)
+		{
+			Log::GetLog()->error("No hay ninguna transacción SQLite activa");
+			return false;
+		}
+
+		bool success;
+		if (transactionDepth == 1)
+		{
+			success = executeQuery("COMMIT");
+			if (!success) executeQuery("ROLLBACK");
+		}
+		else
+		{
+			success = executeQuery("RELEASE SAVEPOINT sp_" + std::to_string(transactionDepth - 1));
+		}
+
+		if (--transactionDepth == 0) transactionOwner.store(std::thread::id());
+		mutex.unlock(); // bloqueo tomado en beginTransaction
+
+		return success;
+	}
+
+	/**
+	 * @brief Revierte la transacción o los cambios desde el savepoint más reciente.
+	 * 
+	 * @return true si los cambios se revirtieron, false en caso contrario.
+	 */
+	bool rollback()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+
+		if (transactionDepth == 0)
+		{
+			Log::GetLog()->error("No hay ninguna transacción SQLite activa");
+			return false;
+		}
+
+		bool success;
+		if (transactionDepth == 1)
+		{
+			success = executeQuery("ROLLBACK");
+		}
+		else
+		{
+			std::string savepoint = "sp_" + std::to_string(transactionDepth - 1);
+			success = executeQuery("ROLLBACK TO SAVEPOINT " + savepoint) && executeQuery("RELEASE SAVEPOINT " + savepoint);
+		}
+
+		if (--transactionDepth == 0) transactionOwner.store(std::thread::id());
+		mutex.unlock(); // bloqueo tomado en beginTransaction
+
+		return success;
+	}
+
 	/**
 	 * @brief Escapa una cadena para prevenir inyecciones SQL.
 	 * 
@@ -254,34 +645,359 @@ public:
 	 */
 	std::string escapeString(const std::string& value)
 	{
-		std::string escaped;
-		escaped.reserve(value.length());
+		QueryBuilder escaped;
+		escaped.appendEscaped(value);
 
-		for (char c : value)
+		return escaped.str();
+	}
+
+	/**
+	 * @brief Indica la variante de SQL del conector.
+	 * 
+	 * @return SqlDialect::SQLite.
+	 */
+	SqlDialect dialect() const
+	{
+		return SqlDialect::SQLite;
+	}
+
+private:
+	sqlite3* db;
+	char* errorMessage;
+	StatementCache<sqlite3_stmt*> statements;
+	std::recursive_mutex mutex;
+	int transactionDepth = 0;
+	std::atomic<std::thread::id> transactionOwner;
+	std::chrono::steady_clock::duration checkpointInterval = std::chrono::steady_clock::duration::zero();
+	std::chrono::steady_clock::time_point lastCheckpoint;
+
+	/**
+	 * @struct Reader
+	 * @brief Conexión de solo lectura junto con sus sentencias preparadas.
+	 */
+	struct Reader
+	{
+		sqlite3* db = nullptr;
+		StatementCache<sqlite3_stmt*> statements;
+
+		Reader(size_t statementCacheSize)
+			: statements(statementCacheSize, [](sqlite3_stmt* stmt) { sqlite3_finalize(stmt); })
 		{
-			switch (c)
+		}
+
+		~Reader()
+		{
+			statements.clear();
+			if (db != nullptr) sqlite3_close(db);
+		}
+	};
+
+	std::mutex readerMutex;
+	std::vector<std::unique_ptr<Reader>> idleReaders;
+	size_t readerCount = 0;
+
+	// Conector cuyo lector usa el hilo actual, para que una lectura anidada no tome otro
+	static inline thread_local const SQLiteConnector* readingOn = nullptr;
+
+	/**
+	 * @brief Abre las conexiones de solo lectura.
+	 * 
+	 * Solo se abren si la base de datos quedó en modo WAL: en los demás
+	 * modos una escritura bloquea a los lectores y no se gana nada. Las
+	 * conexiones reciben los ajustes del perfil que afectan a cada
+	 * conexión; journal_mode y synchronous son de la conexión de escritura.
+	 * 
+	 * @param dbName Ruta al archivo de la base de datos SQLite.
+	 * @param count Número de conexiones a abrir.
+	 * @param statementCacheSize Número máximo de sentencias preparadas por conexión.
+	 * @param tuning Opciones de rendimiento de la conexión de escritura.
+	 */
+	void openReaders(const std::string& dbName, size_t count, size_t statementCacheSize, const SQLiteTuning& tuning)
+	{
+		if (!isWal())
+		{
+			Log::GetLog()->warn("Las conexiones de solo lectura de SQLite requieren JournalMode WAL. Las lecturas usarán la conexión de escritura.");
+			return;
+		}
+
+		SQLiteTuning readerTuning = tuning;
+		readerTuning.journalMode.clear();
+		readerTuning.synchronous.clear();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			auto reader = std::make_unique<Reader>(statementCacheSize);
+
+			if (sqlite3_open_v2(dbName.c_str(), &reader->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK)
 			{
-			case '\'':
-				escaped += "''";
-				break;
-			case '\"':
-				escaped += "\"";
-				break;
-			case '\\':
-				escaped += "\\";
-				break;
-			default:
-				escaped += c;
+				printError(reader->db, "Fallo al abrir la conexión de solo lectura de SQLite");
 				break;
 			}
+
+			std::vector<std::string> errors;
+			readerTuning.apply(reader->db, errors);
+			for (const std::string& error : errors)
+			{
+				Log::GetLog()->warn("Ajuste de SQLite no aplicado en una conexión de solo lectura. {}", error);
+			}
+
+			idleReaders.push_back(std::move(reader));
+			readerCount++;
 		}
+	}
+
+	/**
+	 * @brief Indica si la conexión de escritura está en modo WAL.
+	 */
+	bool isWal()
+	{
+		sqlite3_stmt* stmt;
+		if (sqlite3_prepare_v2(db, "PRAGMA journal_mode", -1, &stmt, nullptr) != SQLITE_OK) return false;
 
-		return escaped;
+		bool wal = false;
+		if (sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			const char* mode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+			wal = mode != nullptr && std::string_view(mode) == "wal";
+		}
+
+		sqlite3_finalize(stmt);
+		return wal;
 	}
 
-private:
-	sqlite3* db;
-	char* errorMessage;
+	/**
+	 * @brief Indica si una consulta empieza por SELECT o WITH.
+	 * 
+	 * Es un filtro rápido para no compilar en un lector las escrituras;
+	 * sqlite3_stmt_readonly decide después con la sentencia compilada.
+	 */
+	static bool isSelect(std::string_view query)
+	{
+		size_t start = 0;
+		while (start < query.size() && std::isspace(static_cast<unsigned char>(query[start]))) start++;
+
+		auto startsWith = [&](std::string_view keyword)
+		{
+			if (query.size() - start < keyword.size()) return false;
+			for (size_t i = 0; i < keyword.size(); i++)
+			{
+				if (std::toupper(static_cast<unsigned char>(query[start + i])) != keyword[i]) return false;
+			}
+			return true;
+		};
+
+		return startsWith("SELECT") || startsWith("WITH");
+	}
+
+	/**
+	 * @brief Ejecuta una lectura en una conexión de solo lectura si es posible.
+	 * 
+	 * No se usan si no hay lectores, si la consulta modifica datos o si el
+	 * hilo tiene una transacción abierta. Tampoco si todos los lectores están
+	 * ocupados o si el hilo ya usa uno, por ejemplo en una lectura desde el
+	 * visitante de forEachRow: esperar a un lector libre podría no terminar
+	 * nunca, y la conexión de escritura siempre puede leer.
+	 * 
+	 * @param query Consulta SQL a ejecutar.
+	 * @param persistent true para conservar la sentencia en la caché del lector.
+	 * @param success Recibe el resultado de la lectura si se ejecutó.
+	 * @param read Función que ejecuta la sentencia compilada.
+	 * @return true si la consulta se ejecutó en un lector, false si debe ejecutarse en la conexión de escritura.
+	 */
+	template <typename Read>
+	bool readOnReader(const std::string& query, bool persistent, bool& success, Read&& read)
+	{
+		if (readerCount == 0 || readingOn == this || transactionOwner.load() == std::this_thread::get_id() || !isSelect(query)) return false;
+
+		std::unique_ptr<Reader> reader;
+		{
+			std::lock_guard<std::mutex> lock(readerMutex);
+			if (idleReaders.empty()) return false;
+
+			reader = std::move(idleReaders.back());
+			idleReaders.pop_back();
+		}
+
+		sqlite3_stmt* stmt = persistent ? reader->statements.checkout(query) : nullptr;
+		if (stmt == nullptr)
+		{
+			unsigned int flags = persistent ? SQLITE_PREPARE_PERSISTENT : 0;
+			if (sqlite3_prepare_v3(reader->db, query.c_str(), static_cast<int>(query.size()), flags, &stmt, nullptr) != SQLITE_OK || !sqlite3_stmt_readonly(stmt))
+			{
+				// La conexión de escritura repite la compilación e informa del error
+				sqlite3_finalize(stmt);
+				stmt = nullptr;
+			}
+			else if (persistent)
+			{
+				reader->statements.insert(query, stmt, true);
+			}
+		}
+
+		if (stmt != nullptr)
+		{
+			const SQLiteConnector* previous = readingOn;
+			readingOn = this;
+			success = read(stmt);
+			readingOn = previous;
+
+			if (persistent) releaseStatement(reader->statements, query, stmt);
+			else sqlite3_finalize(stmt);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(readerMutex);
+			idleReaders.push_back(std::move(reader));
+		}
+
+		return stmt != nullptr;
+	}
+
+	/**
+	 * @brief Obtiene una sentencia preparada de la caché o la compila.
+	 * 
+	 * La sentencia queda en uso hasta releaseStatement. Si la misma
+	 * consulta ya está en uso, por ejemplo desde el visitante de
+	 * forEachRow, se compila una copia que no se guarda en la caché.
+	 * 
+	 * @param query Consulta SQL con marcadores '?' para los parámetros.
+	 * @return La sentencia lista para enlazar parámetros, o nullptr si falló.
+	 */
+	sqlite3_stmt* acquireStatement(const std::string& query)
+	{
+		sqlite3_stmt* stmt = statements.checkout(query);
+		if (stmt != nullptr) return stmt;
+
+		if (sqlite3_prepare_v3(db, query.c_str(), static_cast<int>(query.size()), SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK)
+		{
+			printError("Fallo al preparar la sentencia SQLite");
+			return nullptr;
+		}
+
+		statements.insert(query, stmt, true);
+		return stmt;
+	}
+
+	/**
+	 * @brief Deja una sentencia de la caché lista para el siguiente uso.
+	 * 
+	 * Las copias que no quedaron en la caché se liberan.
+	 * 
+	 * @param cache Caché de la conexión que compiló la sentencia.
+	 * @param query Consulta SQL de la sentencia.
+	 * @param stmt Sentencia a reiniciar.
+	 */
+	static void releaseStatement(StatementCache<sqlite3_stmt*>& cache, const std::string& query, sqlite3_stmt* stmt)
+	{
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+
+		if (!cache.checkin(query, stmt)) sqlite3_finalize(stmt);
+	}
+
+	/**
+	 * @brief Lee las filas de una sentencia en un ResultSet.
+	 * 
+	 * Sin visitante se acumulan todas las filas. Con visitante el ResultSet
+	 * contiene solo la fila actual y se reutiliza en cada paso.
+	 * 
+	 * @param stmt Sentencia lista para ejecutarse.
+	 * @param results ResultSet donde se almacenarán los resultados.
+	 * @param visitor Función que recibe cada fila, o nullptr para acumularlas.
+	 * @return true si se leyeron las filas, false en caso contrario.
+	 */
+	bool readRows(sqlite3_stmt* stmt, ResultSet& results, const RowVisitor* visitor = nullptr)
+	{
+		int numCols = sqlite3_column_count(stmt);
+
+		std::vector<std::string> columns;
+		columns.reserve(numCols);
+		for (int i = 0; i < numCols; i++)
+		{
+			columns.emplace_back(sqlite3_column_name(stmt, i));
+		}
+		results.setColumns(std::move(columns));
+
+		int rc;
+		while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+		{
+			for (int i = 0; i < numCols; i++)
+			{
+				const char* val = (const char*)sqlite3_column_text(stmt, i);
+				if (val == nullptr)
+				{
+					results.addNull();
+				}
+				else if (!results.addValue(val, sqlite3_column_bytes(stmt, i)))
+				{
+					Log::GetLog()->error("El resultado de la sentencia SQLite supera el tamaño máximo de un ResultSet");
+					return false;
+				}
+			}
+
+			if (visitor != nullptr)
+			{
+				if (!(*visitor)(results)) return true;
+				results.clearRows();
+			}
+		}
+
+		if (rc != SQLITE_DONE)
+		{
+			printError(sqlite3_db_handle(stmt), "Error al leer la sentencia SQLite:");
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Enlaza los parámetros a los marcadores de una sentencia.
+	 * 
+	 * @param stmt Sentencia preparada.
+	 * @param params Valores a enlazar, en el mismo orden que los marcadores.
+	 * @return true si todos los parámetros se enlazaron, false en caso contrario.
+	 */
+	bool bindParams(sqlite3_stmt* stmt, const DbParams& params)
+	{
+		if (static_cast<int>(params.size()) != sqlite3_bind_parameter_count(stmt))
+		{
+			Log::GetLog()->error("La sentencia SQLite espera {} parámetros, recibió {}", sqlite3_bind_parameter_count(stmt), params.size());
+			return false;
+		}
+
+		for (int i = 0; i < static_cast<int>(params.size()); i++)
+		{
+			const DbValue& value = params[i];
+			int rc = SQLITE_OK;
+
+			if (std::holds_alternative<int64_t>(value))
+			{
+				rc = sqlite3_bind_int64(stmt, i + 1, std::get<int64_t>(value));
+			}
+			else if (std::holds_alternative<double>(value))
+			{
+				rc = sqlite3_bind_double(stmt, i + 1, std::get<double>(value));
+			}
+			else if (std::holds_alternative<std::string>(value))
+			{
+				const std::string& text = std::get<std::string>(value);
+				rc = sqlite3_bind_text(stmt, i + 1, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+			}
+			else
+			{
+				rc = sqlite3_bind_null(stmt, i + 1);
+			}
+
+			if (rc != SQLITE_OK)
+			{
+				printError(sqlite3_db_handle(stmt), "Fallo al enlazar parámetro SQLite");
+				return false;
+			}
+		}
+
+		return true;
+	}
 
 	/**
 	 * @brief Imprime un mensaje de error en el registro.
@@ -293,7 +1009,18 @@ private:
 	 */
 	void printError(const std::string& message)
 	{
-		Log::GetLog()->error("{} {}", message, sqlite3_errmsg(db));
+		printError(db, message);
+	}
+
+	/**
+	 * @brief Imprime un mensaje de error con el error de una conexión concreta.
+	 * 
+	 * @param connection Conexión que produjo el error.
+	 * @param message Mensaje de error personalizado.
+	 */
+	void printError(sqlite3* connection, const std::string& message)
+	{
+		Log::GetLog()->error("{} {}", message, sqlite3_errmsg(connection));
 	}
 	
 	/**
@@ -307,7 +1034,13 @@ private:
 	 */
 	bool executeQuery(const std::string& query)
 	{
-		int rc = sqlite3_exec(db, query.c_str(), 0, 0, &errorMessage);
+		return executeQuery(query.c_str());
+	}
+
+	bool executeQuery(const char* query)
+	{
+		QueryTimer timer(query);
+		int rc = sqlite3_exec(db, query, 0, 0, &errorMessage);
 		if (rc != SQLITE_OK)
 		{
 			printError(std::string("Error en consulta SQLite: ") + errorMessage);
@@ -316,9 +1049,33 @@ private:
 			return false;
 		}
 
+		checkpointIfDue();
 		return true;
 	}
 
+	/**
+	 * @brief Ejecuta wal_checkpoint(PASSIVE) si pasó el intervalo configurado.
+	 * 
+	 * El checkpoint pasivo copia al archivo principal las páginas del WAL
+	 * que ningún lector necesita, sin esperar bloqueos, para que el WAL no
+	 * crezca entre los checkpoints automáticos. No se ejecuta dentro de
+	 * una transacción.
+	 */
+	void checkpointIfDue()
+	{
+		if (checkpointInterval == std::chrono::steady_clock::duration::zero() || transactionDepth > 0) return;
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now - lastCheckpoint < checkpointInterval) return;
+
+		lastCheckpoint = now;
+
+		if (sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr) != SQLITE_OK)
+		{
+			printError("Fallo en wal_checkpoint de SQLite:");
+		}
+	}
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef SQLITETUNING_H
+#define SQLITETUNING_H
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "sqlite3/sqlite3.h"
+
+/**
+ * @struct SQLiteTuning
+ * @brief Opciones de rendimiento que se aplican al abrir una base de datos SQLite.
+ *
+ * Los valores por defecto forman el perfil recomendado para el servidor:
+ * WAL permite leer mientras otro hilo escribe, synchronous=NORMAL evita
+ * un fsync por cada commit y busy_timeout espera al bloqueo en lugar de
+ * fallar con SQLITE_BUSY. Un valor vacío o negativo deja el valor por
+ * defecto de SQLite.
+ *
+ * No depende del API del servidor, por lo que también lo usan las
+ * herramientas de benchmark.
+ */
+struct SQLiteTuning
+{
+	std::string journalMode = "WAL";
+	std::string synchronous = "NORMAL";
+	int64_t mmapSizeBytes = 256LL * 1024 * 1024;
+	int64_t cacheSizeKiB = 16 * 1024;
+	std::string tempStore = "MEMORY";
+	int busyTimeoutMs = 5000;
+	int walCheckpointSeconds = 60;
+
+	/**
+	 * @brief Perfil con los valores por defecto de SQLite.
+	 *
+	 * @return Opciones que no modifican ningún PRAGMA.
+	 */
+	static SQLiteTuning defaults()
+	{
+		return { "", "", -1, -1, "", -1, 0 };
+	}
+
+	/**
+	 * @brief Genera las sentencias PRAGMA del perfil.
+	 *
+	 * Los valores de texto se validan contra los admitidos por SQLite para
+	 * que la configuración no pueda inyectar otras sentencias.
+	 *
+	 * @param errors Recibe un mensaje por cada valor no válido, que se omite.
+	 * @return Sentencias PRAGMA a ejecutar en orden.
+	 */
+	std::vector<std::string> pragmas(std::vector<std::string>& errors) const
+	{
+		std::vector<std::string> result;
+
+		// busy_timeout primero para que el cambio de journal_mode espere bloqueos
+		if (busyTimeoutMs >= 0) result.push_back("PRAGMA busy_timeout=" + std::to_string(busyTimeoutMs));
+
+		addKeyword(result, errors, "journal_mode", journalMode, { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF" });
+		addKeyword(result, errors, "synchronous", synchronous, { "OFF", "NORMAL", "FULL", "EXTRA" });
+		addKeyword(result, errors, "temp_store", tempStore, { "DEFAULT", "FILE", "MEMORY" });
+
+		if (mmapSizeBytes >= 0) result.push_back("PRAGMA mmap_size=" + std::to_string(mmapSizeBytes));
+		// Un valor negativo en cache_size indica KiB en lugar de páginas
+		if (cacheSizeKiB > 0) result.push_back("PRAGMA cache_size=-" + std::to_string(cacheSizeKiB));
+
+		return result;
+	}
+
+	/**
+	 * @brief Aplica el perfil a una conexión abierta.
+	 *
+	 * @param db Conexión SQLite.
+	 * @param errors Recibe un mensaje por cada PRAGMA que falló o se omitió.
+	 * @return true si todos los PRAGMA se aplicaron, false en caso contrario.
+	 */
+	bool apply(sqlite3* db, std::vector<std::string>& errors) const
+	{
+		size_t previousErrors = errors.size();
+
+		for (const std::string& pragma : pragmas(errors))
+		{
+			char* errorMessage = nullptr;
+			if (sqlite3_exec(db, pragma.c_str(), nullptr, nullptr, &errorMessage) != SQLITE_OK)
+			{
+				errors.push_back(pragma + ": " + (errorMessage ? errorMessage : sqlite3_errmsg(db)));
+				sqlite3_free(errorMessage);
+			}
+		}
+
+		return errors.size() == previousErrors;
+	}
+
+private:
+	static void addKeyword(std::vector<std::string>& result, std::vector<std::string>& errors, const std::string& pragma, std::string value, std::initializer_list<const char*> allowed)
+	{
+		if (value.empty()) return;
+
+		std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+		if (std::find_if(allowed.begin(), allowed.end(), [&value](const char* option) { return value == option; }) == allowed.end())
+		{
+			errors.push_back("Valor no válido para " + pragma + ": " + value);
+			return;
+		}
+
+		result.push_back("PRAGMA " + pragma + "=" + value);
+	}
+};
+
+#endif // SQLITETUNING_H
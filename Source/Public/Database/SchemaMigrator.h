@@ -0,0 +1,184 @@
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "IDatabaseConnector.h"
+#include "RoutingConnector.h"
+#include "Transaction.h"
+
+/**
+ * @struct Migration
+ * @brief Cambio de esquema numerado con sus sentencias para cada dialecto.
+ */
+struct Migration
+{
+	int version;
+	std::string description;
+	std::vector<std::string> mysql;
+	std::vector<std::string> sqlite;
+
+	/**
+	 * @brief Sentencias de la migración para un dialecto.
+	 *
+	 * @param dialect Dialecto del conector.
+	 * @return Sentencias a ejecutar en orden.
+	 */
+	const std::vector<std::string>& statements(SqlDialect dialect) const
+	{
+		return dialect == SqlDialect::MySQL ? mysql : sqlite;
+	}
+};
+
+/**
+ * @class SchemaMigrator
+ * @brief Aplica en orden las migraciones pendientes de un componente.
+ *
+ * La versión de cada componente (normalmente una tabla) se guarda en la
+ * tabla schema_version. Si el esquema está al día basta con dos lecturas,
+ * sin DDL. Cada migración se ejecuta en su propia transacción junto con
+ * el cambio de versión; en SQLite la DDL es transaccional, mientras que
+ * en MySQL CREATE y ALTER confirman la transacción de forma implícita,
+ * por lo que las sentencias de una migración deben poder repetirse
+ * (IF NOT EXISTS) si falla a mitad.
+ */
+class SchemaMigrator
+{
+public:
+	/**
+	 * @brief Constructor con el conector donde se aplican las migraciones.
+	 *
+	 * @param connector Conector de la base de datos.
+	 * @param component Nombre con el que se registra la versión en schema_version.
+	 */
+	SchemaMigrator(IDatabaseConnector& connector, std::string component)
+		: connector(connector), component(std::move(component))
+	{
+	}
+
+	/**
+	 * @brief Aplica las migraciones con versión mayor que la registrada.
+	 *
+	 * @param migrations Migraciones del componente, en cualquier orden.
+	 * @return true si el esquema quedó en la última versión, false si una migración falló.
+	 */
+	bool migrate(std::vector<Migration> migrations)
+	{
+		std::sort(migrations.begin(), migrations.end(), [](const Migration& a, const Migration& b) { return a.version < b.version; });
+
+		int current = currentVersion();
+		if (current < 0) return false;
+
+		if (migrations.empty() || migrations.back().version <= current) return true;
+
+		for (const Migration& migration : migrations)
+		{
+			if (migration.version <= current) continue;
+
+			if (!apply(migration))
+			{
+				Log::GetLog()->error("Fallo la migración {} de {}: {}", migration.version, component, migration.description);
+				return false;
+			}
+
+			Log::GetLog()->info("Migración {} de {} aplicada: {}", migration.version, component, migration.description);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Lee la versión registrada del componente.
+	 *
+	 * Primero consulta el catálogo (information_schema.tables en MySQL,
+	 * sqlite_master en SQLite) para saber si schema_version existe, así la
+	 * lectura de una base de datos nueva no falla ni registra errores. La
+	 * tabla solo se crea si no existe; con el esquema al día no se ejecuta
+	 * DDL. Con réplicas ambas lecturas van al servidor principal
+	 * (PrimaryRead), para no decidir las migraciones con una réplica atrasada.
+	 *
+	 * @return La versión, 0 si el componente no tiene migraciones aplicadas o -1 si hubo un error.
+	 */
+	int currentVersion()
+	{
+		PrimaryRead primary;
+
+		ResultSet results;
+		if (!connector.read(findVersionTable(), { std::string("schema_version") }, results))
+		{
+			Log::GetLog()->error("No se pudo leer la versión del esquema de {}", component);
+			return -1;
+		}
+
+		if (results.empty())
+		{
+			if (!connector.execute(createVersionTable(), {}))
+			{
+				Log::GetLog()->error("No se pudo crear la tabla schema_version para {}", component);
+				return -1;
+			}
+
+			return 0;
+		}
+
+		if (!connector.read("SELECT Version FROM schema_version WHERE Component = ?", { component }, results))
+		{
+			Log::GetLog()->error("No se pudo leer la versión del esquema de {}", component);
+			return -1;
+		}
+
+		if (results.empty()) return 0;
+
+		return static_cast<int>(results.getInt64(0, "Version").value_or(0));
+	}
+
+private:
+	IDatabaseConnector& connector;
+	std::string component;
+
+	std::string findVersionTable() const
+	{
+		if (connector.dialect() == SqlDialect::MySQL)
+		{
+			return "SELECT TABLE_NAME FROM information_schema.tables WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?";
+		}
+
+		return "SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?";
+	}
+
+	std::string createVersionTable() const
+	{
+		if (connector.dialect() == SqlDialect::MySQL)
+		{
+			return "CREATE TABLE IF NOT EXISTS schema_version (Component VARCHAR(100) NOT NULL PRIMARY KEY, Version INT NOT NULL, AppliedAt DATETIME DEFAULT CURRENT_TIMESTAMP)";
+		}
+
+		return "CREATE TABLE IF NOT EXISTS schema_version (Component TEXT NOT NULL PRIMARY KEY, Version INTEGER NOT NULL, AppliedAt TIMESTAMP DEFAULT CURRENT_TIMESTAMP)";
+	}
+
+	/**
+	 * @brief Ejecuta una migración y registra su versión en una transacción.
+	 */
+	bool apply(const Migration& migration)
+	{
+		Transaction transaction(connector);
+		if (!transaction) return false;
+
+		for (const std::string& statement : migration.statements(connector.dialect()))
+		{
+			if (!connector.execute(statement, {})) return false;
+		}
+
+		if (!connector.upsert("schema_version", { "Component", "Version" }, { { component, int64_t{ migration.version } } }, "Component", { "Version" }))
+		{
+			return false;
+		}
+
+		return transaction.commit();
+	}
+};
+
+#endif // SCHEMAMIGRATOR_H
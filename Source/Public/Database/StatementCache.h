@@ -0,0 +1,189 @@
+#ifndef STATEMENTCACHE_H
+#define STATEMENTCACHE_H
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @class StatementCache
+ * @brief Caché LRU de sentencias preparadas indexada por el texto SQL.
+ *
+ * Guarda los manejadores nativos (sqlite3_stmt*, MYSQL_STMT*) para que
+ * una misma consulta solo se analice una vez. Cuando se alcanza la
+ * capacidad máxima se libera la sentencia usada hace más tiempo.
+ *
+ * Una sentencia tomada con checkout() queda en uso hasta checkin(): no se
+ * expulsa ni se reemplaza mientras tanto, por lo que una consulta anidada
+ * en la misma conexión no la libera ni la reinicia a mitad de lectura.
+ *
+ * @tparam Handle Tipo del manejador nativo de la sentencia.
+ */
+template <typename Handle>
+class StatementCache
+{
+public:
+	using Finalizer = std::function<void(Handle)>;
+
+	/**
+	 * @brief Constructor de la caché.
+	 *
+	 * @param capacity Número máximo de sentencias a conservar (mínimo 1).
+	 * @param finalizer Función que libera un manejador expulsado de la caché.
+	 */
+	StatementCache(size_t capacity, Finalizer finalizer)
+		: _capacity(capacity > 0 ? capacity : 1), _finalizer(std::move(finalizer))
+	{
+	}
+
+	StatementCache(const StatementCache&) = delete;
+	StatementCache& operator=(const StatementCache&) = delete;
+
+	~StatementCache()
+	{
+		clear();
+	}
+
+	/**
+	 * @brief Busca una sentencia y la marca como usada recientemente.
+	 *
+	 * @param sql Texto SQL de la sentencia.
+	 * @return El manejador guardado o un manejador vacío si no existe.
+	 */
+	Handle find(const std::string& sql)
+	{
+		auto it = _index.find(sql);
+		if (it == _index.end()) return Handle{};
+
+		_entries.splice(_entries.begin(), _entries, it->second);
+		return it->second->handle;
+	}
+
+	/**
+	 * @brief Busca una sentencia libre y la marca en uso hasta checkin().
+	 *
+	 * @param sql Texto SQL de la sentencia.
+	 * @return El manejador guardado, o un manejador vacío si no existe o ya está en uso.
+	 */
+	Handle checkout(const std::string& sql)
+	{
+		auto it = _index.find(sql);
+		if (it == _index.end() || it->second->inUse) return Handle{};
+
+		_entries.splice(_entries.begin(), _entries, it->second);
+		it->second->inUse = true;
+		return it->second->handle;
+	}
+
+	/**
+	 * @brief Marca como libre una sentencia tomada con checkout() o insert().
+	 *
+	 * @param sql Texto SQL de la sentencia.
+	 * @param handle Manejador usado.
+	 * @return true si el manejador pertenece a la caché, false si quien lo usó debe liberarlo.
+	 */
+	bool checkin(const std::string& sql, Handle handle)
+	{
+		auto it = _index.find(sql);
+		if (it == _index.end() || it->second->handle != handle) return false;
+
+		it->second->inUse = false;
+		evict();
+		return true;
+	}
+
+	/**
+	 * @brief Guarda una sentencia nueva, expulsando la menos usada si es necesario.
+	 *
+	 * Si ya hay una sentencia en uso con el mismo texto no se reemplaza y
+	 * el manejador nuevo no se guarda.
+	 *
+	 * @param sql Texto SQL de la sentencia.
+	 * @param handle Manejador nativo ya preparado.
+	 * @param inUse true para guardarla ya tomada, como si se hubiera llamado a checkout().
+	 * @return true si la sentencia quedó en la caché, false en caso contrario.
+	 */
+	bool insert(const std::string& sql, Handle handle, bool inUse = false)
+	{
+		auto it = _index.find(sql);
+		if (it != _index.end() && it->second->inUse) return false;
+
+		erase(sql);
+
+		_entries.push_front({ sql, handle, inUse });
+		_index[_entries.front().sql] = _entries.begin();
+
+		evict();
+		return true;
+	}
+
+	/**
+	 * @brief Libera y elimina una sentencia concreta de la caché.
+	 *
+	 * @param sql Texto SQL de la sentencia.
+	 */
+	void erase(const std::string& sql)
+	{
+		auto it = _index.find(sql);
+		if (it == _index.end()) return;
+
+		_finalizer(it->second->handle);
+		_entries.erase(it->second);
+		_index.erase(it);
+	}
+
+	/**
+	 * @brief Libera todas las sentencias guardadas.
+	 */
+	void clear()
+	{
+		for (auto& entry : _entries)
+		{
+			_finalizer(entry.handle);
+		}
+
+		_entries.clear();
+		_index.clear();
+	}
+
+	size_t size() const { return _entries.size(); }
+
+private:
+	struct Entry
+	{
+		std::string sql;
+		Handle handle;
+		bool inUse;
+	};
+
+	size_t _capacity;
+	Finalizer _finalizer;
+	std::list<Entry> _entries;
+	std::unordered_map<std::string, typename std::list<Entry>::iterator> _index;
+
+	/**
+	 * @brief Expulsa las sentencias libres menos usadas hasta volver a la capacidad.
+	 *
+	 * Las sentencias en uso se saltan, por lo que la caché puede superar la
+	 * capacidad mientras haya lecturas anidadas en curso.
+	 */
+	void evict()
+	{
+		auto it = _entries.end();
+		while (_entries.size() > _capacity && it != _entries.begin())
+		{
+			--it;
+			if (it->inUse) continue;
+
+			_finalizer(it->handle);
+			_index.erase(it->sql);
+			it = _entries.erase(it);
+		}
+	}
+};
+
+#endif // STATEMENTCACHE_H
@@ -0,0 +1,448 @@
+#ifndef TABLESCHEMA_H
+#define TABLESCHEMA_H
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "DatabaseTypes.h"
+#include "ResultSet.h"
+
+/**
+ * @struct FixedString
+ * @brief Cadena literal que puede usarse como argumento de plantilla.
+ */
+template <size_t N>
+struct FixedString
+{
+	char value[N]{};
+
+	constexpr FixedString(const char (&text)[N])
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			value[i] = text[i];
+		}
+	}
+
+	constexpr std::string_view view() const
+	{
+		return std::string_view(value, N - 1);
+	}
+};
+
+/**
+ * @brief Tipos de columna con su nombre en cada dialecto y su tipo en C++.
+ */
+struct Integer
+{
+	using value_type = int64_t;
+	static std::string sql(SqlDialect dialect) { return dialect == SqlDialect::MySQL ? "INT" : "INTEGER"; }
+};
+
+struct BigInt
+{
+	using value_type = int64_t;
+	static std::string sql(SqlDialect dialect) { return dialect == SqlDialect::MySQL ? "BIGINT" : "INTEGER"; }
+};
+
+struct Real
+{
+	using value_type = double;
+	static std::string sql(SqlDialect dialect) { return dialect == SqlDialect::MySQL ? "DOUBLE" : "REAL"; }
+};
+
+template <size_t Length>
+struct Varchar
+{
+	using value_type = std::string;
+	static std::string sql(SqlDialect dialect) { return dialect == SqlDialect::MySQL ? "VARCHAR(" + std::to_string(Length) + ")" : "TEXT"; }
+};
+
+struct Text
+{
+	using value_type = std::string;
+	static std::string sql(SqlDialect) { return "TEXT"; }
+};
+
+struct DateTime
+{
+	using value_type = std::string;
+	static std::string sql(SqlDialect dialect) { return dialect == SqlDialect::MySQL ? "DATETIME" : "TIMESTAMP"; }
+};
+
+/**
+ * @enum ColumnFlags
+ * @brief Restricciones de una columna, combinables con '|'.
+ *
+ * Las columnas AutoIncrement y DefaultNow las rellena la base de datos,
+ * por lo que no forman parte de los INSERT ni de los UPDATE generados.
+ */
+enum ColumnFlags : unsigned
+{
+	NotNull = 1,
+	PrimaryKey = 2,
+	AutoIncrement = 4,
+	Unique = 8,
+	DefaultNow = 16
+};
+
+/**
+ * @struct Col
+ * @brief Columna de una tabla: nombre, tipo y restricciones.
+ */
+template <FixedString Name, typename Type, unsigned Flags = 0>
+struct Col
+{
+	using type = Type;
+	static constexpr std::string_view name = Name.view();
+	static constexpr unsigned flags = Flags;
+	static constexpr bool generated = (Flags & (AutoIncrement | DefaultNow)) != 0;
+
+	/**
+	 * @brief Definición de la columna dentro de CREATE TABLE.
+	 *
+	 * En MySQL la clave primaria y los índices únicos se declaran al final
+	 * de la tabla; en SQLite van en la propia columna.
+	 */
+	static std::string definition(SqlDialect dialect)
+	{
+		std::string sql = std::string(name) + " " + Type::sql(dialect);
+
+		if (Flags & NotNull) sql += " NOT NULL";
+
+		if (dialect == SqlDialect::MySQL)
+		{
+			if (Flags & AutoIncrement) sql += " AUTO_INCREMENT";
+		}
+		else
+		{
+			if (Flags & PrimaryKey) sql += " PRIMARY KEY";
+			if (Flags & AutoIncrement) sql += " AUTOINCREMENT";
+			if (Flags & Unique) sql += " UNIQUE";
+		}
+
+		if (Flags & DefaultNow) sql += " DEFAULT CURRENT_TIMESTAMP";
+
+		return sql;
+	}
+};
+
+/**
+ * @struct Table
+ * @brief Descripción de una tabla en tiempo de compilación.
+ *
+ * A partir de una sola descripción genera la DDL de cada dialecto y las
+ * sentencias INSERT, SELECT, UPDATE y DELETE con marcadores '?'. El nombre
+ * de la tabla puede reemplazarse en cada sentencia para admitir el
+ * TableName de la configuración.
+ *
+ * Ejemplo:
+ * @code
+ * using Players = Table<"Players", Col<"Id", Integer, PrimaryKey | AutoIncrement>, Col<"EosId", Varchar<50>, NotNull | Unique>>;
+ * std::string query = Players::selectBy<"EosId">();
+ * @endcode
+ */
+template <FixedString Name, typename... Columns>
+struct Table
+{
+	static constexpr std::string_view name = Name.view();
+	static constexpr size_t columnCount = sizeof...(Columns);
+	static constexpr std::array<std::string_view, sizeof...(Columns)> columnNames = { Columns::name... };
+	static constexpr std::array<bool, sizeof...(Columns)> generatedColumns = { Columns::generated... };
+
+	/**
+	 * @brief Posición de una columna en la tabla.
+	 *
+	 * Un nombre que no pertenece a la tabla es un error de compilación.
+	 */
+	template <FixedString Column>
+	static constexpr size_t indexOf()
+	{
+		constexpr size_t index = find(Column.view());
+		static_assert(index < sizeof...(Columns), "La columna no pertenece a la tabla");
+		return index;
+	}
+
+	/**
+	 * @brief Sentencia CREATE TABLE IF NOT EXISTS para un dialecto.
+	 *
+	 * @param dialect Dialecto del conector.
+	 * @param table Nombre de la tabla; por defecto el de la descripción.
+	 * @return Sentencia DDL.
+	 */
+	static std::string createTable(SqlDialect dialect, std::string_view table = name)
+	{
+		std::string sql = "CREATE TABLE IF NOT EXISTS " + std::string(table) + " (";
+
+		bool first = true;
+		([&]()
+		{
+			sql += first ? "" : ", ";
+			sql += Columns::definition(dialect);
+			first = false;
+		}(), ...);
+
+		if (dialect == SqlDialect::MySQL)
+		{
+			([&]()
+			{
+				if constexpr ((Columns::flags & PrimaryKey) != 0) sql += ", PRIMARY KEY(" + std::string(Columns::name) + ")";
+			}(), ...);
+
+			([&]()
+			{
+				if constexpr ((Columns::flags & Unique) != 0) sql += ", UNIQUE INDEX " + std::string(Columns::name) + "_UNIQUE (" + std::string(Columns::name) + ")";
+			}(), ...);
+		}
+
+		return sql + ")";
+	}
+
+	/**
+	 * @brief Columnas que se escriben en un INSERT, sin las generadas por la base de datos.
+	 */
+	static std::vector<std::string> insertColumns()
+	{
+		std::vector<std::string> columns;
+		for (size_t i = 0; i < columnCount; i++)
+		{
+			if (!generatedColumns[i]) columns.emplace_back(columnNames[i]);
+		}
+		return columns;
+	}
+
+	/**
+	 * @brief Sentencia INSERT con un marcador por cada columna de insertColumns().
+	 */
+	static std::string insert(std::string_view table = name)
+	{
+		std::vector<std::string> columns = insertColumns();
+
+		std::string sql = "INSERT INTO " + std::string(table) + " (" + join(columns, ", ", "") + ") VALUES (";
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			sql += i == 0 ? "?" : ", ?";
+		}
+
+		return sql + ")";
+	}
+
+	/**
+	 * @brief Sentencia SELECT de todas las columnas en el orden de la descripción.
+	 */
+	static std::string select(std::string_view table = name)
+	{
+		std::vector<std::string> columns(columnNames.begin(), columnNames.end());
+		return "SELECT " + join(columns, ", ", "") + " FROM " + std::string(table);
+	}
+
+	/**
+	 * @brief Sentencia SELECT filtrada por una columna.
+	 */
+	template <FixedString Key>
+	static std::string selectBy(std::string_view table = name)
+	{
+		return select(table) + " WHERE " + std::string(columnNames[indexOf<Key>()]) + " = ?";
+	}
+
+	/**
+	 * @brief Sentencia UPDATE filtrada por una columna.
+	 *
+	 * Sin columnas explícitas actualiza todas las que no son la clave ni
+	 * generadas. Los parámetros van en el orden de las columnas y la clave
+	 * al final.
+	 */
+	template <FixedString Key, FixedString... Set>
+	static std::string updateBy(std::string_view table = name)
+	{
+		std::vector<std::string> columns;
+		if constexpr (sizeof...(Set) > 0)
+		{
+			(columns.emplace_back(columnNames[indexOf<Set>()]), ...);
+		}
+		else
+		{
+			for (size_t i = 0; i < columnCount; i++)
+			{
+				if (!generatedColumns[i] && i != indexOf<Key>()) columns.emplace_back(columnNames[i]);
+			}
+		}
+
+		return "UPDATE " + std::string(table) + " SET " + join(columns, ", ", " = ?") + " WHERE " + std::string(columnNames[indexOf<Key>()]) + " = ?";
+	}
+
+	/**
+	 * @brief Sentencia DELETE filtrada por una columna.
+	 */
+	template <FixedString Key>
+	static std::string deleteBy(std::string_view table = name)
+	{
+		return "DELETE FROM " + std::string(table) + " WHERE " + std::string(columnNames[indexOf<Key>()]) + " = ?";
+	}
+
+private:
+	static constexpr size_t find(std::string_view column)
+	{
+		for (size_t i = 0; i < sizeof...(Columns); i++)
+		{
+			if (columnNames[i] == column) return i;
+		}
+		return sizeof...(Columns);
+	}
+
+	static std::string join(const std::vector<std::string>& columns, const char* separator, const char* suffix)
+	{
+		std::string result;
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			if (i > 0) result += separator;
+			result += columns[i];
+			result += suffix;
+		}
+		return result;
+	}
+};
+
+/**
+ * @struct RowMapping
+ * @brief Enlace entre las columnas de una Table y los miembros de una estructura.
+ *
+ * Los miembros se indican en el mismo orden que las columnas. Los valores
+ * se convierten directamente entre la estructura y DbParams o ResultSet,
+ * sin mapas de texto por fila. Los miembros std::optional admiten NULL.
+ */
+template <typename TableType, auto... Members>
+struct RowMapping
+{
+	static_assert(sizeof...(Members) == TableType::columnCount, "Debe indicarse un miembro por cada columna");
+
+	/**
+	 * @brief Parámetros de Table::insert() para una fila.
+	 */
+	template <typename Record>
+	static DbParams insertParams(const Record& record)
+	{
+		DbParams params;
+		params.reserve(TableType::columnCount);
+
+		size_t column = 0;
+		([&]()
+		{
+			if (!TableType::generatedColumns[column++]) params.push_back(toValue(record.*Members));
+		}(), ...);
+
+		return params;
+	}
+
+	/**
+	 * @brief Parámetros con los valores de las columnas indicadas, en ese orden.
+	 *
+	 * Sirve para Table::updateBy(), agregando la clave como última columna.
+	 */
+	template <FixedString... Columns, typename Record>
+	static DbParams params(const Record& record)
+	{
+		return { value<TableType::template indexOf<Columns>()>(record)... };
+	}
+
+	/**
+	 * @brief Copia una fila de un ResultSet de Table::select() a la estructura.
+	 *
+	 * Las columnas se leen por posición, en el orden de la descripción.
+	 *
+	 * @param results Resultado de una consulta generada por la tabla.
+	 * @param row Índice de la fila.
+	 * @param record Estructura que recibe los valores.
+	 */
+	template <typename Record>
+	static void read(const ResultSet& results, size_t row, Record& record)
+	{
+		size_t column = 0;
+		(fromCell(results, row, column++, record.*Members), ...);
+	}
+
+	/**
+	 * @brief Copia todas las filas de un ResultSet de Table::select().
+	 */
+	template <typename Record>
+	static std::vector<Record> readAll(const ResultSet& results)
+	{
+		std::vector<Record> records(results.rowCount());
+		for (size_t row = 0; row < records.size(); row++)
+		{
+			read(results, row, records[row]);
+		}
+		return records;
+	}
+
+private:
+	template <size_t Index, typename Record>
+	static DbValue value(const Record& record)
+	{
+		return toValue(record.*std::get<Index>(std::make_tuple(Members...)));
+	}
+
+	template <typename T>
+	static DbValue toValue(const T& value)
+	{
+		if constexpr (std::is_same_v<T, std::string>)
+		{
+			return value;
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			return static_cast<double>(value);
+		}
+		else
+		{
+			static_assert(std::is_integral_v<T>, "Tipo de miembro no admitido");
+			return static_cast<int64_t>(value);
+		}
+	}
+
+	template <typename T>
+	static DbValue toValue(const std::optional<T>& value)
+	{
+		if (!value) return nullptr;
+		return toValue(*value);
+	}
+
+	template <typename T>
+	static void fromCell(const ResultSet& results, size_t row, size_t column, T& value)
+	{
+		if constexpr (std::is_same_v<T, std::string>)
+		{
+			value = std::string(results.getString(row, column));
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			value = static_cast<T>(results.getDouble(row, column).value_or(0));
+		}
+		else
+		{
+			value = static_cast<T>(results.getInt64(row, column).value_or(0));
+		}
+	}
+
+	template <typename T>
+	static void fromCell(const ResultSet& results, size_t row, size_t column, std::optional<T>& value)
+	{
+		if (results.isNull(row, column))
+		{
+			value.reset();
+			return;
+		}
+
+		fromCell(results, row, column, value.emplace());
+	}
+};
+
+#endif // TABLESCHEMA_H
@@ -0,0 +1,87 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#pragma once
+
+#include "IDatabaseConnector.h"
+
+/**
+ * @class Transaction
+ * @brief Transacción RAII sobre un conector de base de datos.
+ *
+ * Inicia la transacción al construirse y la revierte al salir de ámbito
+ * si no se llamó a commit(). Las transacciones pueden anidarse: una
+ * Transaction creada dentro de otra en el mismo hilo usa un savepoint.
+ *
+ * Ejemplo:
+ * @code
+ * Transaction transaction(*PluginTemplate::pointsDB);
+ * if (!transaction) return false;
+ * PluginTemplate::pointsDB->execute(query, params);
+ * return transaction.commit();
+ * @endcode
+ */
+class Transaction
+{
+public:
+	/**
+	 * @brief Inicia una transacción en el conector.
+	 *
+	 * @param connector Conector sobre el que se abre la transacción.
+	 */
+	explicit Transaction(IDatabaseConnector& connector)
+		: connector(connector), active(connector.beginTransaction())
+	{
+	}
+
+	Transaction(const Transaction&) = delete;
+	Transaction& operator=(const Transaction&) = delete;
+
+	/**
+	 * @brief Revierte la transacción si sigue activa.
+	 */
+	~Transaction()
+	{
+		if (active)
+		{
+			connector.rollback();
+		}
+	}
+
+	/**
+	 * @brief Confirma la transacción.
+	 *
+	 * @return true si los cambios se confirmaron, false en caso contrario.
+	 */
+	bool commit()
+	{
+		if (!active) return false;
+
+		active = false;
+		return connector.commit();
+	}
+
+	/**
+	 * @brief Revierte la transacción.
+	 *
+	 * @return true si los cambios se revirtieron, false en caso contrario.
+	 */
+	bool rollback()
+	{
+		if (!active) return false;
+
+		active = false;
+		return connector.rollback();
+	}
+
+	/**
+	 * @brief Indica si la transacción se inició y sigue activa.
+	 */
+	explicit operator bool() const { return active; }
+
+private:
+	IDatabaseConnector& connector;
+	bool active;
+};
+
+#endif // TRANSACTION_H
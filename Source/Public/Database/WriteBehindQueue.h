@@ -0,0 +1,237 @@
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#pragma once
+
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IDatabaseConnector.h"
+
+/**
+ * @class WriteBehindQueue
+ * @brief Buffer de escrituras diferidas que agrupa las filas por clave.
+ *
+ * Cada put() reemplaza la fila pendiente de la misma clave, por lo que
+ * varios cambios de un jugador entre dos vaciados se escriben una sola
+ * vez. Las filas iguales a la última escrita se descartan si esa escritura
+ * tiene menos de REMEMBER_FOR; pasado ese tiempo se vuelven a escribir, por
+ * si la fila cambió en la tabla por otro medio. flush() escribe
+ * todas las filas pendientes con un único upsert, que el conector ejecuta
+ * en una transacción.
+ *
+ * El vaciado ocurre cuando se alcanza el número máximo de filas o cuando
+ * due() indica que pasó el intervalo configurado. flush() hace la consulta
+ * en el hilo que lo llama.
+ */
+class WriteBehindQueue
+{
+public:
+	/**
+	 * @brief Constructor con la forma de las filas de la tabla.
+	 *
+	 * @param columns Columnas de cada fila.
+	 * @param conflictKey Columna única que identifica la fila.
+	 * @param updateColumns Columnas a actualizar si la fila ya existe.
+	 */
+	WriteBehindQueue(std::vector<std::string> columns, std::string conflictKey, std::vector<std::string> updateColumns)
+		: columns(std::move(columns)), conflictKey(std::move(conflictKey)), updateColumns(std::move(updateColumns))
+	{
+	}
+
+	/**
+	 * @brief Indica la tabla de destino y los límites de vaciado.
+	 *
+	 * @param connector Conector donde se escriben las filas.
+	 * @param tableName Nombre de la tabla.
+	 * @param interval Tiempo máximo que una fila puede quedar pendiente.
+	 * @param maxEntries Número de filas pendientes que provoca un vaciado inmediato.
+	 */
+	void configure(IDatabaseConnector* connector, const std::string& tableName, std::chrono::milliseconds interval, size_t maxEntries)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		this->connector = connector;
+		this->tableName = tableName;
+		this->interval = interval;
+		this->maxEntries = maxEntries > 0 ? maxEntries : 1;
+	}
+
+	/**
+	 * @brief Agrega o reemplaza la fila pendiente de una clave.
+	 *
+	 * Si se alcanza el número máximo de filas se vacía en el hilo que
+	 * llama, por lo que debe llamarse desde un hilo de AsyncDatabase.
+	 *
+	 * @param key Valor de conflictKey de la fila.
+	 * @param row Valores de la fila en el orden de las columnas.
+	 */
+	void put(const std::string& key, DbParams row)
+	{
+		bool full;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			auto written = lastWritten.find(key);
+			if (written != lastWritten.end() && written->second.row == row && std::chrono::steady_clock::now() - written->second.at < REMEMBER_FOR)
+			{
+				pending.erase(key);
+				return;
+			}
+
+			pending[key] = std::move(row);
+			full = pending.size() >= maxEntries;
+		}
+
+		if (full) flush();
+	}
+
+	/**
+	 * @brief Descarta la fila pendiente de una clave.
+	 *
+	 * Espera a que termine un vaciado en curso, de modo que una fila ya
+	 * enviada no pueda escribirse después de borrarla de la tabla.
+	 *
+	 * @param key Valor de conflictKey de la fila.
+	 */
+	void discard(const std::string& key)
+	{
+		std::lock_guard<std::mutex> flushLock(flushMutex);
+		std::lock_guard<std::mutex> lock(mutex);
+
+		pending.erase(key);
+		lastWritten.erase(key);
+	}
+
+	/**
+	 * @brief Indica si hay filas pendientes y pasó el intervalo desde el último vaciado.
+	 *
+	 * Devuelve true una sola vez por vaciado, para que el tick no encole
+	 * varios flush() mientras uno sigue pendiente.
+	 *
+	 * @return true si el que llama debe ejecutar flush().
+	 */
+	bool due()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (pending.empty() || flushScheduled) return false;
+		if (std::chrono::steady_clock::now() - lastFlush < interval) return false;
+
+		flushScheduled = true;
+		return true;
+	}
+
+	/**
+	 * @brief Escribe todas las filas pendientes en una transacción.
+	 *
+	 * Si la escritura falla las filas vuelven a quedar pendientes, salvo
+	 * las que recibieron un valor más reciente mientras tanto.
+	 *
+	 * @return true si no quedaban filas o se escribieron todas, false en caso contrario.
+	 */
+	bool flush()
+	{
+		std::lock_guard<std::mutex> flushLock(flushMutex);
+
+		std::unordered_map<std::string, DbParams> batch;
+		IDatabaseConnector* target;
+		std::string table;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			batch.swap(pending);
+			flushScheduled = false;
+			lastFlush = std::chrono::steady_clock::now();
+			target = connector;
+			table = tableName;
+		}
+
+		if (batch.empty()) return true;
+
+		std::vector<DbParams> rows;
+		rows.reserve(batch.size());
+		for (auto& [key, row] : batch)
+		{
+			rows.push_back(row);
+		}
+
+		if (target == nullptr || !target->upsert(table, columns, rows, conflictKey, updateColumns))
+		{
+			Log::GetLog()->error("Fallo al escribir {} filas diferidas en {}", batch.size(), table);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto& [key, row] : batch)
+			{
+				pending.try_emplace(key, std::move(row));
+			}
+			return false;
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Las filas recordadas que ya vencieron se eliminan cuando el mapa crece
+		if (lastWritten.size() + batch.size() > MAX_REMEMBERED)
+		{
+			for (auto it = lastWritten.begin(); it != lastWritten.end();)
+			{
+				it = now - it->second.at >= REMEMBER_FOR ? lastWritten.erase(it) : std::next(it);
+			}
+
+			// Olvidar una fila solo cuesta repetir su escritura
+			if (lastWritten.size() + batch.size() > MAX_REMEMBERED) lastWritten.clear();
+		}
+
+		for (auto& [key, row] : batch)
+		{
+			lastWritten[key] = { std::move(row), now };
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Número de filas pendientes.
+	 */
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return pending.size();
+	}
+
+private:
+	/**
+	 * @struct Written
+	 * @brief Última fila escrita de una clave y el momento de la escritura.
+	 */
+	struct Written
+	{
+		DbParams row;
+		std::chrono::steady_clock::time_point at;
+	};
+
+	static constexpr std::chrono::minutes REMEMBER_FOR{ 5 };
+	static constexpr size_t MAX_REMEMBERED = 4096;
+
+	std::vector<std::string> columns;
+	std::string conflictKey;
+	std::vector<std::string> updateColumns;
+
+	std::mutex mutex;
+	std::mutex flushMutex;
+	IDatabaseConnector* connector = nullptr;
+	std::string tableName;
+	std::chrono::steady_clock::duration interval = std::chrono::seconds(5);
+	size_t maxEntries = 200;
+	std::unordered_map<std::string, DbParams> pending;
+	std::unordered_map<std::string, Written> lastWritten;
+	std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+	bool flushScheduled = false;
+};
+
+#endif // WRITEBEHINDQUEUE_H
@@ -3,6 +3,16 @@
 #include "json.hpp"
 
 #include "Database/DatabaseFactory.h"
+#include "Database/AsyncDatabase.h"
+#include "Database/NonblockingPoller.h"
+#include "Database/SchemaMigrator.h"
+#include "Database/TableSchema.h"
+#include "Database/Transaction.h"
+#include "Database/WriteBehindQueue.h"
+
+#include <atomic>
+#include <future>
+#include <unordered_set>
 
 #include "Requests.h"
 
@@ -46,28 +56,111 @@ namespace PluginTemplate
 	 * @var pluginTemplateDB
 	 * @brief Conector a la base de datos principal del plugin.
 	 * 
-	 * Puntero único a un conector de base de datos que se utiliza para
+	 * Puntero compartido a un conector de base de datos que se utiliza para
 	 * almacenar y recuperar datos específicos del plugin.
 	 */
-	inline std::unique_ptr<IDatabaseConnector> pluginTemplateDB;
+	inline std::shared_ptr<IDatabaseConnector> pluginTemplateDB;
 
 	/**
 	 * @var permissionsDB
 	 * @brief Conector a la base de datos de permisos.
 	 * 
-	 * Puntero único a un conector de base de datos que se utiliza para
+	 * Puntero compartido a un conector de base de datos que se utiliza para
 	 * verificar y gestionar los permisos de los jugadores.
 	 */
-	inline std::unique_ptr<IDatabaseConnector> permissionsDB;
+	inline std::shared_ptr<IDatabaseConnector> permissionsDB;
 
 	/**
 	 * @var pointsDB
 	 * @brief Conector a la base de datos de puntos (ArkShop).
 	 * 
-	 * Puntero único a un conector de base de datos que se utiliza para
+	 * Puntero compartido a un conector de base de datos que se utiliza para
 	 * gestionar el sistema de puntos del plugin ArkShop.
 	 */
-	inline std::unique_ptr<IDatabaseConnector> pointsDB;
+	inline std::shared_ptr<IDatabaseConnector> pointsDB;
+
+	/**
+	 * @enum DatabaseState
+	 * @brief Estado de la carga de las bases de datos al iniciar el servidor.
+	 */
+	enum class DatabaseState
+	{
+		Initializing,
+		Ready,
+		Failed
+	};
+
+	/**
+	 * @var started
+	 * @brief Indica si OnServerReady ya inicializó el plugin.
+	 * 
+	 * BeginPlay y Plugin_Init pueden llamar a OnServerReady; solo la
+	 * primera llamada inicializa.
+	 */
+	inline std::atomic<bool> started{ false };
+
+	/**
+	 * @var databaseState
+	 * @brief Estado de las conexiones que abre LoadDatabase en segundo plano.
+	 * 
+	 * Los conectores de pluginTemplateDB, permissionsDB y pointsDB solo
+	 * se usan desde el hilo del juego cuando vale Ready.
+	 */
+	inline std::atomic<DatabaseState> databaseState{ DatabaseState::Initializing };
+
+	/**
+	 * @var databaseLoad
+	 * @brief Carga en curso de las bases de datos, esperada al descargar el plugin.
+	 */
+	inline std::future<void> databaseLoad;
+
+	/**
+	 * @var pendingCommands
+	 * @brief Jugadores con un comando esperando respuesta de la base de datos.
+	 * 
+	 * Solo se accede desde el hilo del juego. Evita que un jugador lance
+	 * el mismo comando varias veces antes de que se descuenten los puntos.
+	 */
+	inline std::unordered_set<uint64> pendingCommands;
+
+	/**
+	 * @struct PlayerRecord
+	 * @brief Fila de la tabla de jugadores del plugin.
+	 */
+	struct PlayerRecord
+	{
+		int64_t id = 0;
+		std::string eosId;
+		std::string playerId;
+		std::string playerName;
+		std::optional<std::string> createAt;
+	};
+
+	/**
+	 * @typedef PlayersTable
+	 * @brief Esquema de la tabla de jugadores; el nombre real es TableName de PluginDBSettings.
+	 */
+	using PlayersTable = Table<"PluginTemplate",
+		Col<"Id", Integer, NotNull | PrimaryKey | AutoIncrement>,
+		Col<"EosId", Varchar<50>, NotNull | Unique>,
+		Col<"PlayerId", Varchar<50>, NotNull>,
+		Col<"PlayerName", Varchar<50>, NotNull>,
+		Col<"CreateAt", DateTime, DefaultNow>>;
+
+	/**
+	 * @typedef PlayersMapping
+	 * @brief Enlace entre las columnas de PlayersTable y PlayerRecord.
+	 */
+	using PlayersMapping = RowMapping<PlayersTable, &PlayerRecord::id, &PlayerRecord::eosId, &PlayerRecord::playerId, &PlayerRecord::playerName, &PlayerRecord::createAt>;
+
+	/**
+	 * @var playerWrites
+	 * @brief Escrituras diferidas de la tabla de jugadores del plugin.
+	 * 
+	 * Agrupa los cambios por EosId y los escribe en pluginTemplateDB en un
+	 * solo upsert cada WriteBehindFlushMs o al llegar a WriteBehindMaxEntries.
+	 */
+	inline WriteBehindQueue playerWrites{ PlayersTable::insertColumns(), "EosId", { "PlayerName" } };
 
 	/**
 	 * @var req
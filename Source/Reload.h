@@ -7,6 +7,9 @@
  */
 void Reload()
 {
+	// Ningún hilo de base de datos debe leer la configuración mientras se reemplaza
+	AsyncDatabase::Get().drain();
+
 	ReadConfig();
 
 	//AddOrRemoveCommands(false);
@@ -71,27 +74,111 @@ void ReloadConfigRcon(RCONClientConnection* rcon_connection, RCONPacket* rcon_pa
 	rcon_connection->SendMessageW(rcon_packet->Id, 0, &reply);
 }
 
+/**
+ * @brief Construye el informe de DbStats.
+ * 
+ * Une las latencias de QueryStats con los contadores de la caché de
+ * cada base de datos que tenga QueryCache activado.
+ * 
+ * @return Texto del informe.
+ */
+std::string DatabaseStatsReport()
+{
+	std::string report = QueryStats::Get().report();
+
+	// Los conectores se asignan en segundo plano hasta que la carga termina
+	if (PluginTemplate::databaseState != PluginTemplate::DatabaseState::Ready) return report;
+
+	const std::pair<const char*, IDatabaseConnector*> databases[] = {
+		{ "PluginDB", PluginTemplate::pluginTemplateDB.get() },
+		{ "Permissions", PluginTemplate::permissionsDB.get() },
+		{ "Points", PluginTemplate::pointsDB.get() }
+	};
+
+	// Los bloques que apuntan a la misma base de datos comparten la caché y se informan juntos
+	std::vector<std::pair<CachingConnector*, std::string>> caches;
+	for (const auto& [name, database] : databases)
+	{
+		auto* cache = dynamic_cast<CachingConnector*>(database);
+		if (!cache) continue;
+
+		auto it = std::find_if(caches.begin(), caches.end(), [cache](const auto& entry) { return entry.first == cache; });
+		if (it == caches.end())
+		{
+			caches.emplace_back(cache, name);
+		}
+		else
+		{
+			it->second += std::string("+") + name;
+		}
+	}
+
+	for (const auto& [cache, names] : caches)
+	{
+		report += cache->report(names);
+	}
+
+	return report;
+}
+
+/**
+ * @brief Muestra las latencias de las consultas a través de un comando de consola.
+ * 
+ * Envía al administrador el número de consultas y los percentiles
+ * p50, p95 y p99 de cada operación y de cada tabla, junto con los
+ * aciertos y fallos de la caché de lecturas.
+ * 
+ * @param pc Controlador del jugador que ejecuta el comando.
+ * @param param Parámetros adicionales del comando (no utilizados).
+ * @param unused Parámetro no utilizado.
+ */
+void DatabaseStats(APlayerController* pc, FString*, bool)
+{
+	auto* spc = static_cast<AShooterPlayerController*>(pc);
+
+	ArkApi::GetApiUtils().SendServerMessage(spc, FColorList::Green, "{}", DatabaseStatsReport());
+}
+
+/**
+ * @brief Muestra las latencias de las consultas a través de RCON.
+ * 
+ * @param rcon_connection Conexión RCON del cliente.
+ * @param rcon_packet Paquete RCON recibido.
+ * @param unused Parámetro no utilizado.
+ */
+void DatabaseStatsRcon(RCONClientConnection* rcon_connection, RCONPacket* rcon_packet, UWorld*)
+{
+	FString reply = DatabaseStatsReport().c_str();
+	rcon_connection->SendMessageW(rcon_packet->Id, 0, &reply);
+}
+
 /**
  * @brief Agrega o elimina los comandos de recarga.
  * 
  * Esta función se encarga de registrar o desregistrar los comandos
  * de consola y RCON utilizados para recargar la configuración
- * del plugin en tiempo de ejecución.
+ * del plugin en tiempo de ejecución y para consultar las latencias
+ * de la base de datos.
  * 
  * @param addCmd Bandera que indica si se deben agregar (true) o eliminar (false) los comandos.
  */
 void AddReloadCommands(bool addCmd = true)
 {
 	FString reloadCmd = std::string(PROJECT_NAME + std::string(".Reload")).c_str();
+	FString statsCmd = std::string(PROJECT_NAME + std::string(".DbStats")).c_str();
 
 	if (addCmd)
 	{
 		ArkApi::GetCommands().AddConsoleCommand(reloadCmd, &ReloadConfig);
 		ArkApi::GetCommands().AddRconCommand(reloadCmd, &ReloadConfigRcon);
+		ArkApi::GetCommands().AddConsoleCommand(statsCmd, &DatabaseStats);
+		ArkApi::GetCommands().AddRconCommand(statsCmd, &DatabaseStatsRcon);
 	}
 	else
 	{
 		ArkApi::GetCommands().RemoveConsoleCommand(reloadCmd);
 		ArkApi::GetCommands().RemoveRconCommand(reloadCmd);
+		ArkApi::GetCommands().RemoveConsoleCommand(statsCmd);
+		ArkApi::GetCommands().RemoveRconCommand(statsCmd);
 	}
 }
\ No newline at end of file
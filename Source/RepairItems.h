@@ -1,58 +1,144 @@
 /**
- * @brief Callback para el comando de reparación de objetos.
- * 
- * Esta función se ejecuta cuando un jugador utiliza el comando de reparación
- * de objetos. Verifica los permisos del jugador, el costo en puntos (si aplica),
- * y repara todos los objetos dañados en el inventario del jugador.
- * 
- * @param pc Controlador del jugador que ejecuta el comando.
- * @param param Parámetros adicionales del comando (no utilizados).
- * @param unused Parámetro no utilizado.
+ * @brief Libera el bloqueo de comando de un jugador.
+ *
+ * Debe llamarse en cada salida de un comando asíncrono para que el
+ * jugador pueda volver a usar comandos.
+ *
+ * @param steam_id ID del jugador.
  */
-void RepairItemsCallback(AShooterPlayerController* pc, FString* param, int)
+void ReleasePlayerCommand(uint64 steam_id)
 {
-	Log::GetLog()->warn("Función: {}", __FUNCTION__);
-
-	// Verificación de permisos
-	FString steamid = FString(std::to_string(pc->GetLinkedPlayerID64()));
-	FString perms = GetPriorPermByEOSID(steamid);
-	nlohmann::json command = GetCommandString(perms.ToString(), "RepairItemCMD");
+	PluginTemplate::pendingCommands.erase(steam_id);
+}
 
-	FString playername;
-	pc->GetPlayerCharacterName(&playername);
+/**
+ * @brief Libera el bloqueo de comando de un jugador cuando falla una consulta.
+ *
+ * Se usa como continuación de error de AsyncDatabase::run y avisa al
+ * jugador con DatabaseErrorMSG si sigue conectado.
+ *
+ * @param steam_id ID del jugador.
+ */
+void FailPlayerCommand(uint64 steam_id)
+{
+	ReleasePlayerCommand(steam_id);
 
-	if (command.is_null() || (!command.is_null() && command.value("Enabled", false) == false))
-	{
-		if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
-		{
-			Log::GetLog()->info("{} No tiene permisos. Comando: {}", playername.ToString(), __FUNCTION__);
-		}
+	AShooterPlayerController* pc = ArkApi::GetApiUtils().FindPlayerFromSteamId(steam_id);
+	if (!pc) return;
 
-		ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PermErrorMSG", "No tienes permiso para usar este comando.").c_str());
+	ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("DatabaseErrorMSG", "La base de datos no está disponible.").c_str());
+}
 
+/**
+ * @brief Verifica los permisos y puntos de un comando sin bloquear el hilo del juego.
+ *
+ * Mientras las bases de datos se cargan responde al jugador con
+ * InitializingMSG y no ejecuta el comando.
+ *
+ * Las consultas de permisos y puntos se ejecutan en AsyncDatabase, o con
+ * consultas no bloqueantes si General.MysqlNonblocking está activado. Si el
+ * jugador puede usar el comando, onAllowed se ejecuta en el hilo del juego
+ * con el controlador actual del jugador y el costo del comando. A partir
+ * de ese momento onAllowed es responsable de llamar a ReleasePlayerCommand.
+ * Si una consulta falla se llama a FailPlayerCommand.
+ *
+ * @param pc Controlador del jugador que ejecuta el comando.
+ * @param commandName Clave del comando en la configuración de permisos.
+ * @param functionName Nombre del callback, usado en los mensajes de depuración.
+ * @param onAllowed Continuación a ejecutar si el jugador tiene permisos y puntos.
+ */
+void CheckCommandAsync(AShooterPlayerController* pc, const std::string& commandName, const std::string& functionName, std::function<void(AShooterPlayerController*, int)> onAllowed)
+{
+	std::string message;
+	if (!IsDatabaseReady(message))
+	{
+		ArkApi::GetApiUtils().SendNotification(pc, FColorList::Orange, 1.3f, 15.0f, nullptr, message.c_str());
 		return;
 	}
-	 
-	// Verificación de puntos
-	if (Points(steamid, command.value("Cost", 0), true) == false)
-	{
-		if (PluginTemplate::config["Debug"].value("Points", false) == true)
-		{
-			Log::GetLog()->info("{} no tiene suficientes puntos. Comando: {}", playername.ToString(), __FUNCTION__);
-		}
 
-		ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PointsErrorMSG", "No tienes suficientes puntos.").c_str());
+	const uint64 steam_id = pc->GetLinkedPlayerID64();
 
-		return;
-	}
+	// Un comando a la vez por jugador
+	if (!PluginTemplate::pendingCommands.insert(steam_id).second) return;
+
+	FString steamid = FString(std::to_string(steam_id));
+
+	FString playername;
+	pc->GetPlayerCharacterName(&playername);
 
-	// Ejecución
+	// Verificación de permisos
+	GetPriorPermByEOSIDAsync(steamid,
+		[steam_id, steamid, playername, commandName, functionName, onAllowed](FString perms)
+		{
+			AShooterPlayerController* pc = ArkApi::GetApiUtils().FindPlayerFromSteamId(steam_id);
+			if (!pc)
+			{
+				ReleasePlayerCommand(steam_id);
+				return;
+			}
+
+			nlohmann::json command = GetCommandString(perms.ToString(), commandName);
+
+			if (command.is_null() || (!command.is_null() && command.value("Enabled", false) == false))
+			{
+				if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
+				{
+					Log::GetLog()->info("{} No tiene permisos. Comando: {}", playername.ToString(), functionName);
+				}
+
+				ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PermErrorMSG", "No tienes permiso para usar este comando.").c_str());
+
+				ReleasePlayerCommand(steam_id);
+				return;
+			}
+
+			int cost = command.value("Cost", 0);
+
+			// Verificación de puntos
+			PointsAsync(steamid, cost, true,
+				[steam_id, playername, functionName, cost, onAllowed](bool hasPoints)
+				{
+					AShooterPlayerController* pc = ArkApi::GetApiUtils().FindPlayerFromSteamId(steam_id);
+					if (!pc)
+					{
+						ReleasePlayerCommand(steam_id);
+						return;
+					}
+
+					if (!hasPoints)
+					{
+						if (PluginTemplate::config["Debug"].value("Points", false) == true)
+						{
+							Log::GetLog()->info("{} no tiene suficientes puntos. Comando: {}", playername.ToString(), functionName);
+						}
+
+						ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PointsErrorMSG", "No tienes suficientes puntos.").c_str());
+
+						ReleasePlayerCommand(steam_id);
+						return;
+					}
+
+					onAllowed(pc, cost);
+				},
+				[steam_id]() { FailPlayerCommand(steam_id); });
+		},
+		[steam_id]() { FailPlayerCommand(steam_id); });
+}
+
+/**
+ * @brief Repara los objetos dañados del inventario de un jugador.
+ *
+ * @param pc Controlador del jugador.
+ * @return Cantidad de objetos reparados, o -1 si el jugador no tiene personaje o inventario.
+ */
+int RepairInventory(AShooterPlayerController* pc)
+{
 	ACharacter* character = pc->CharacterField();
-	if (!character) return;
+	if (!character) return -1;
 	APrimalCharacter* primalCharacter = static_cast<APrimalCharacter*>(character);
 
 	UPrimalInventoryComponent* invComp = primalCharacter->MyInventoryComponentField();
-	if (!invComp) return;
+	if (!invComp) return -1;
 
 	TArray<UPrimalItem*> playerInv = invComp->InventoryItemsField();
 
@@ -84,85 +170,145 @@ void RepairItemsCallback(AShooterPlayerController* pc, FString* param, int)
 		affectedItemsCounter += 1;
 	}
 
-	if (ReadPlayer(steamid))
-	{
-		UpdatePlayer(steamid, playername);
-	}
-	else
-	{
-		AddPlayer(steamid, pc->GetLinkedPlayerID64(), playername);
-	}
-
-	// Deducción de puntos
-	Points(steamid, command.value("Cost", 0));
-
-	if (affectedItemsCounter > 0)
-	{
-		ArkApi::GetApiUtils().SendNotification(pc, FColorList::Green, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("RepairItemsMSG", "Todos los objetos han sido reparados. {}").c_str(), playername.ToString());
-
-		std::string msg = fmt::format("El jugador {} reparó sus objetos. cantidad {}", playername.ToString(), affectedItemsCounter);
-
-		//SendMessageToDiscord(msg);
-	}
+	return affectedItemsCounter;
 }
 
 /**
- * @brief Callback para el comando de eliminación de jugador.
- * 
- * Esta función se ejecuta cuando un jugador utiliza el comando de eliminación
- * de jugador. Verifica los permisos del jugador, el costo en puntos (si aplica),
- * y elimina los datos del jugador de la base de datos del plugin.
- * 
+ * @brief Callback para el comando de reparación de objetos.
+ *
+ * Esta función se ejecuta cuando un jugador utiliza el comando de reparación
+ * de objetos. Verifica los permisos del jugador, el costo en puntos (si aplica),
+ * y repara todos los objetos dañados en el inventario del jugador.
+ * Los puntos se descuentan primero con PointsAsync; la reparación se
+ * realiza en el hilo del juego solo si el descuento se hizo, y si para
+ * entonces el jugador ya no tiene personaje o inventario se le devuelven.
+ *
  * @param pc Controlador del jugador que ejecuta el comando.
  * @param param Parámetros adicionales del comando (no utilizados).
  * @param unused Parámetro no utilizado.
  */
-void DeletePlayerCallback(AShooterPlayerController* pc, FString* param, int)
+void RepairItemsCallback(AShooterPlayerController* pc, FString* /*param*/, int)
 {
 	Log::GetLog()->warn("Función: {}", __FUNCTION__);
 
+	CheckCommandAsync(pc, "RepairItemCMD", __FUNCTION__, [](AShooterPlayerController* pc, int cost)
+	{
+		const uint64 steam_id = pc->GetLinkedPlayerID64();
+		FString steamid = FString(std::to_string(steam_id));
 
-	//pc->GetEOSId(), pc->GetLinkedPlayerID(), pc->GetCharacterName()
+		FString playername;
+		pc->GetPlayerCharacterName(&playername);
 
-	FString playername;
-	pc->GetPlayerCharacterName(&playername);
+		// Sin personaje o inventario no hay nada que reparar y no se cobra
+		ACharacter* character = pc->CharacterField();
+		if (!character || !static_cast<APrimalCharacter*>(character)->MyInventoryComponentField())
+		{
+			ReleasePlayerCommand(steam_id);
+			return;
+		}
 
-	FString steamid = FString(std::to_string(pc->GetLinkedPlayerID64()));
+		AsyncDatabase::Get().run([steamid, steam_id, playername]() { QueuePlayerWrite(steamid, steam_id, playername); });
 
-	// Verificación de permisos
-	FString perms = GetPriorPermByEOSID(steamid);
-	nlohmann::json command = GetCommandString(perms.ToString(), "DeletePlayerCMD");
+		// Deducción de puntos
+		PointsAsync(steamid, cost, false,
+			[steam_id, steamid, playername, cost](bool paid)
+			{
+				ReleasePlayerCommand(steam_id);
 
-	if (command.is_null() || (!command.is_null() && command.value("Enabled", false) == false))
-	{
-		if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
-		{
-			Log::GetLog()->info("{} No tiene permisos. Comando: {}", playername.ToString(), __FUNCTION__);
-		}
+				AShooterPlayerController* pc = ArkApi::GetApiUtils().FindPlayerFromSteamId(steam_id);
 
-		ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PermErrorMSG", "No tienes permiso para usar este comando.").c_str());
+				if (!paid)
+				{
+					if (pc) ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PointsErrorMSG", "No tienes suficientes puntos.").c_str());
+					return;
+				}
 
-		return;
-	}
+				// Ejecución
+				int affectedItemsCounter = pc ? RepairInventory(pc) : -1;
 
-	// Verificación de puntos
-	if (Points(steamid, command.value("Cost", 0), true) == false)
-	{
-		if (PluginTemplate::config["Debug"].value("Points", false) == true)
-		{
-			Log::GetLog()->info("{} no tiene suficientes puntos. Comando: {}", playername.ToString(), __FUNCTION__);
-		}
+				// El jugador se desconectó o perdió el personaje después del cobro
+				if (affectedItemsCounter < 0)
+				{
+					AsyncDatabase::Get().run([steamid, cost]() { RefundPoints(steamid, cost); });
+					return;
+				}
 
-		ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PointsErrorMSG", "No tienes suficientes puntos.").c_str());
+				if (affectedItemsCounter > 0)
+				{
+					ArkApi::GetApiUtils().SendNotification(pc, FColorList::Green, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("RepairItemsMSG", "Todos los objetos han sido reparados. {}").c_str(), playername.ToString());
 
-		return;
-	}
+					std::string msg = fmt::format("El jugador {} reparó sus objetos. cantidad {}", playername.ToString(), affectedItemsCounter);
 
+					//SendMessageToDiscord(msg);
+				}
+			},
+			[steam_id]() { FailPlayerCommand(steam_id); });
+	});
+}
+
+/**
+ * @brief Callback para el comando de eliminación de jugador.
+ *
+ * Esta función se ejecuta cuando un jugador utiliza el comando de eliminación
+ * de jugador. Verifica los permisos del jugador, el costo en puntos (si aplica),
+ * y elimina los datos del jugador de la base de datos del plugin.
+ * Los puntos se descuentan con PointsAsync y el jugador solo se elimina
+ * en AsyncDatabase si el descuento se hizo; si el borrado falla se le
+ * devuelven los puntos.
+ *
+ * @param pc Controlador del jugador que ejecuta el comando.
+ * @param param Parámetros adicionales del comando (no utilizados).
+ * @param unused Parámetro no utilizado.
+ */
+void DeletePlayerCallback(AShooterPlayerController* pc, FString* /*param*/, int)
+{
+	Log::GetLog()->warn("Función: {}", __FUNCTION__);
 
-	DeletePlayer(steamid);
 
-	// Deducción de puntos
-	Points(steamid, command.value("Cost", 0));
+	//pc->GetEOSId(), pc->GetLinkedPlayerID(), pc->GetCharacterName()
 
-	ArkApi::GetApiUtils().SendNotification(pc, FColorList::Orange, 1.3f, 15.0f, nullptr, "Jugador eliminado");
-}
\ No newline at end of file
+	CheckCommandAsync(pc, "DeletePlayerCMD", __FUNCTION__, [](AShooterPlayerController* pc, int cost)
+	{
+		const uint64 steam_id = pc->GetLinkedPlayerID64();
+		FString steamid = FString(std::to_string(steam_id));
+
+		// Deducción de puntos; sin ella el jugador no se elimina
+		PointsAsync(steamid, cost, false,
+			[steam_id, steamid, cost](bool paid)
+			{
+				if (!paid)
+				{
+					ReleasePlayerCommand(steam_id);
+
+					AShooterPlayerController* pc = ArkApi::GetApiUtils().FindPlayerFromSteamId(steam_id);
+					if (pc) ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("PointsErrorMSG", "No tienes suficientes puntos.").c_str());
+					return;
+				}
+
+				AsyncDatabase::Get().run([steamid, cost]()
+					{
+						bool deleted = DeletePlayer(steamid);
+						if (!deleted) RefundPoints(steamid, cost);
+
+						return deleted;
+					},
+					[steam_id](bool deleted)
+					{
+						ReleasePlayerCommand(steam_id);
+
+						AShooterPlayerController* pc = ArkApi::GetApiUtils().FindPlayerFromSteamId(steam_id);
+						if (!pc) return;
+
+						if (!deleted)
+						{
+							ArkApi::GetApiUtils().SendNotification(pc, FColorList::Red, 1.3f, 15.0f, nullptr, PluginTemplate::config["Messages"].value("DatabaseErrorMSG", "La base de datos no está disponible.").c_str());
+							return;
+						}
+
+						ArkApi::GetApiUtils().SendNotification(pc, FColorList::Orange, 1.3f, 15.0f, nullptr, "Jugador eliminado");
+					},
+					[steam_id]() { FailPlayerCommand(steam_id); });
+			},
+			[steam_id]() { FailPlayerCommand(steam_id); });
+	});
+}
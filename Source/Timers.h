@@ -31,6 +31,27 @@ void TimerCallback()
 	PluginTemplate::counter++;
 }
 
+/**
+ * @brief Función de devolución de llamada para cada tick del servidor.
+ * 
+ * Ejecuta en el hilo del juego las continuaciones de las consultas
+ * de base de datos que ya terminaron en AsyncDatabase, avanza las
+ * consultas no bloqueantes de NonblockingPoller y encola el vaciado
+ * de las escrituras diferidas cuando corresponde.
+ * 
+ * @param deltaSeconds Tiempo transcurrido desde el tick anterior.
+ */
+void DatabaseTickCallback(float /*deltaSeconds*/)
+{
+	AsyncDatabase::Get().poll();
+	NonblockingPoller::Get().poll();
+
+	if (PluginTemplate::playerWrites.due())
+	{
+		AsyncDatabase::Get().run([]() { PluginTemplate::playerWrites.flush(); });
+	}
+}
+
 /**
  * @brief Configura o elimina los temporizadores del plugin.
  * 
@@ -45,9 +66,11 @@ void SetTimers(bool addTmr = true)
 	if (addTmr)
 	{
 		ArkApi::GetCommands().AddOnTimerCallback("PluginTemplateTimerTick", &TimerCallback);
+		ArkApi::GetCommands().AddOnTickCallback("PluginTemplateDatabaseTick", &DatabaseTickCallback);
 	}
 	else
 	{
 		ArkApi::GetCommands().RemoveOnTimerCallback("PluginTemplateTimerTick");
+		ArkApi::GetCommands().RemoveOnTickCallback("PluginTemplateDatabaseTick");
 	}
 }
\ No newline at end of file
@@ -208,18 +208,40 @@ void SendMessageToDiscord(std::string msg)
 #endif
 
 /**
- * @brief Gestiona el sistema de puntos del jugador.
- * 
- * Esta función verifica si un jugador tiene suficientes puntos para
- * ejecutar un comando, y si no es una verificación, deduce el costo
- * del comando del saldo del jugador.
- * 
- * @param eos_id ID de EOS del jugador.
+ * @brief Tabla y columnas de la base de datos de puntos (ArkShop).
+ */
+struct PointsColumns
+{
+	std::string table;
+	std::string uniqueId;
+	std::string points;
+	std::string totalSpent;
+};
+
+/**
+ * @brief Lee la tabla y las columnas de puntos de PointsDBSettings.
+ *
+ * @return Tabla y columnas de la base de datos de puntos.
+ */
+PointsColumns GetPointsColumns()
+{
+	nlohmann::json config = PluginTemplate::config["PointsDBSettings"];
+
+	PointsColumns columns;
+	columns.table = config.value("TableName", "ArkShopPlayers");
+	columns.uniqueId = config.value("UniqueIDField", "EosId");
+	columns.points = config.value("PointsField", "Points");
+	columns.totalSpent = config.value("TotalSpentField", "TotalSpent");
+	return columns;
+}
+
+/**
+ * @brief Resuelve los casos de Points que no consultan la base de datos.
+ *
  * @param cost Costo en puntos del comando a ejecutar.
- * @param check_points Bandera que indica si solo se debe verificar (true) o también deducir puntos (false).
- * @return true si el jugador tiene suficientes puntos o si la operación fue exitosa, false en caso contrario.
+ * @return El resultado de Points, o std::nullopt si hay que consultar la base de datos de puntos.
  */
-bool Points(FString eos_id, int cost, bool check_points = false)
+std::optional<bool> PointsWithoutQuery(int cost)
 {
 	if (cost == -1)
 	{
@@ -240,9 +262,7 @@ bool Points(FString eos_id, int cost, bool check_points = false)
 		return true;
 	}
 
-	nlohmann::json config = PluginTemplate::config["PointsDBSettings"];
-
-	if (config.value("Enabled", false) == false)
+	if (PluginTemplate::config["PointsDBSettings"].value("Enabled", false) == false)
 	{
 		if (PluginTemplate::config["Debug"].value("Points", false) == true)
 		{
@@ -252,12 +272,9 @@ bool Points(FString eos_id, int cost, bool check_points = false)
 		return true;
 	}
 
-	std::string tablename = config.value("TableName", "ArkShopPlayers");
-	std::string unique_id = config.value("UniqueIDField", "EosId");
-	std::string points_field = config.value("PointsField", "Points");
-	std::string totalspent_field = config.value("TotalSpentField", "TotalSpent");
+	PointsColumns columns = GetPointsColumns();
 
-	if (tablename.empty() || unique_id.empty() || points_field.empty())
+	if (columns.table.empty() || columns.uniqueId.empty() || columns.points.empty())
 	{
 		if (PluginTemplate::config["Debug"].value("Points", false) == true)
 		{
@@ -266,72 +283,196 @@ bool Points(FString eos_id, int cost, bool check_points = false)
 		return false;
 	}
 
-	std::string escaped_eos_id = PluginTemplate::pointsDB->escapeString(eos_id.ToString());
+	return std::nullopt;
+}
+
+/**
+ * @brief Sentencia que descuenta el costo solo si el saldo alcanza.
+ *
+ * @param eos_id ID de EOS del jugador.
+ * @param cost Costo en puntos del comando.
+ * @return UPDATE con sus parámetros; no cambia ninguna fila si el saldo no alcanza.
+ */
+BatchStatement PointsDeduction(FString eos_id, int cost)
+{
+	PointsColumns columns = GetPointsColumns();
+
+	if (columns.totalSpent != "")
+	{
+		return { fmt::format("UPDATE {0} SET {1}=COALESCE({1}, 0)-?, {2}=COALESCE({2}, 0)+? WHERE {3}=? AND {1}>=?", columns.table, columns.points, columns.totalSpent, columns.uniqueId),
+			{ int64_t{ cost }, int64_t{ cost }, eos_id.ToString(), int64_t{ cost } } };
+	}
+
+	return { fmt::format("UPDATE {0} SET {1}=COALESCE({1}, 0)-? WHERE {2}=? AND {1}>=?", columns.table, columns.points, columns.uniqueId),
+		{ int64_t{ cost }, eos_id.ToString(), int64_t{ cost } } };
+}
+
+/**
+ * @brief Consulta de la fila de puntos de un jugador.
+ *
+ * @param eos_id ID de EOS del jugador.
+ * @return SELECT con sus parámetros.
+ */
+BatchStatement PointsBalance(FString eos_id)
+{
+	PointsColumns columns = GetPointsColumns();
 
-	std::string query = fmt::format("SELECT * FROM {} WHERE {}='{}'", tablename, unique_id, escaped_eos_id);
+	return { fmt::format("SELECT * FROM {} WHERE {}=?", columns.table, columns.uniqueId), { eos_id.ToString() } };
+}
 
-	std::vector<std::map<std::string, std::string>> results;
+/**
+ * @brief Comprueba con la fila de PointsBalance si el saldo alcanza para el costo.
+ *
+ * @param results Fila de puntos del jugador.
+ * @param cost Costo en puntos del comando.
+ * @return true si el jugador tiene suficientes puntos, false en caso contrario.
+ */
+bool HasPoints(const ResultSet& results, int cost)
+{
+	PointsColumns columns = GetPointsColumns();
 
-	if (!PluginTemplate::pointsDB->read(query, results))
+	if (results.empty())
 	{
 		if (PluginTemplate::config["Debug"].value("Points", false) == true)
 		{
-			Log::GetLog()->warn("Error al leer la base de datos de puntos");
+			Log::GetLog()->warn("No se encontró ningún registro");
 		}
+		return false;
+	}
 
+	if (results.columnIndex(columns.points) < 0)
+	{
+		Log::GetLog()->warn("La columna {} no existe en la tabla {}", columns.points, columns.table);
 		return false;
 	}
 
-	if (results.size() <= 0)
+	int points = static_cast<int>(results.getInt64(0, columns.points).value_or(0));
+
+	if (PluginTemplate::config["Debug"].value("Points", false) == true)
+	{
+		Log::GetLog()->warn("El jugador tiene {} puntos", points);
+	}
+
+	return points >= cost;
+}
+
+/**
+ * @brief Gestiona el sistema de puntos del jugador.
+ * 
+ * Esta función verifica si un jugador tiene suficientes puntos para
+ * ejecutar un comando, y si no es una verificación, deduce el costo
+ * del comando del saldo del jugador.
+ * 
+ * @param eos_id ID de EOS del jugador.
+ * @param cost Costo en puntos del comando a ejecutar.
+ * @param check_points Bandera que indica si solo se debe verificar (true) o también deducir puntos (false).
+ * @return true si el jugador tiene suficientes puntos o si la operación fue exitosa, false en caso contrario.
+ *         Un descuento sin saldo suficiente no modifica la base de datos y devuelve false.
+ */
+bool Points(FString eos_id, int cost, bool check_points = false)
+{
+	if (std::optional<bool> result = PointsWithoutQuery(cost)) return *result;
+
+	// Tras un descuento, las lecturas del jugador van al servidor principal
+	ReadAffinity affinity(eos_id.ToString());
+
+	if (!check_points)
 	{
+		PointsColumns columns = GetPointsColumns();
+
+		// La lectura del saldo y el descuento van en un solo lote: un viaje a MySQL en lugar de cuatro.
+		// FOR UPDATE bloquea la fila hasta el COMMIT del lote (SQLite ya serializa las escrituras con
+		// BEGIN IMMEDIATE), y la condición del UPDATE impide que el saldo quede negativo.
+		BatchStatement balance{ fmt::format("SELECT {} FROM {} WHERE {}=?{}", columns.points, columns.table, columns.uniqueId, PluginTemplate::pointsDB->dialect() == SqlDialect::MySQL ? " FOR UPDATE" : ""), { eos_id.ToString() } };
+
+		std::vector<ResultSet> results;
+		if (!PluginTemplate::pointsDB->executeBatch({ balance, PointsDeduction(eos_id, cost) }, results) || results[0].empty())
+		{
+			if (PluginTemplate::config["Debug"].value("Points", false) == true)
+			{
+				Log::GetLog()->warn("Error al actualizar la base de datos de puntos o no se encontró ningún registro");
+			}
+
+			return false;
+		}
+
+		// Con la fila bloqueada, el UPDATE solo descontó si el saldo leído alcanzaba
+		int64_t points = results[0].getInt64(0, 0).value_or(0);
+		if (points < cost)
+		{
+			if (PluginTemplate::config["Debug"].value("Points", false) == true)
+			{
+				Log::GetLog()->info("{} puntos, no alcanzan para {}", points, cost);
+			}
+
+			return false;
+		}
+
 		if (PluginTemplate::config["Debug"].value("Points", false) == true)
 		{
-			Log::GetLog()->warn("No se encontró ningún registro");
+			Log::GetLog()->info("{} Base de datos de puntos actualizada", points - cost);
 		}
-		return false;
+
+		return true;
 	}
 
-	int points = std::atoi(results[0].at(points_field).c_str());
+	BatchStatement balance = PointsBalance(eos_id);
 
-	if (check_points)
+	ResultSet results;
+
+	if (!PluginTemplate::pointsDB->read(balance.query, balance.params, results))
 	{
 		if (PluginTemplate::config["Debug"].value("Points", false) == true)
 		{
-			Log::GetLog()->warn("El jugador tiene {} puntos", points);
+			Log::GetLog()->warn("Error al leer la base de datos de puntos");
 		}
 
-		if (points >= cost) return true;
+		return false;
 	}
-	else
-	{
-		int amount = points - cost;
 
-		std::vector<std::pair<std::string, std::string>> data;
+	return HasPoints(results, cost);
+}
+
+/**
+ * @brief Devuelve al jugador los puntos de un comando que no se completó.
+ *
+ * Deshace un descuento hecho con Points: suma el costo al saldo y lo
+ * resta del total gastado.
+ *
+ * @param eos_id ID de EOS del jugador.
+ * @param cost Cantidad de puntos a devolver.
+ * @return true si los puntos se devolvieron, false en caso contrario.
+ */
+bool RefundPoints(FString eos_id, int cost)
+{
+	if (cost <= 0) return true;
 
-		data.push_back({ points_field, std::to_string(amount) });
+	if (PluginTemplate::config["PointsDBSettings"].value("Enabled", false) == false) return true;
 
-		if (totalspent_field != "")
-		{
-			int total_spent = std::atoi(results[0].at(totalspent_field).c_str());
-			std::string total_ts = std::to_string(total_spent + cost);
+	PointsColumns columns = GetPointsColumns();
 
-			data.push_back({totalspent_field, total_ts});
-		}
+	if (columns.table.empty() || columns.uniqueId.empty() || columns.points.empty()) return false;
 
-		std::string condition = fmt::format("{}='{}'", unique_id, escaped_eos_id);
+	ReadAffinity affinity(eos_id.ToString());
 
-		if (PluginTemplate::pointsDB->update(tablename, data, condition))
-		{
-			if (PluginTemplate::config["Debug"].value("Points", false) == true)
-			{
-				Log::GetLog()->info("{} Base de datos de puntos actualizada", amount);
-			}
+	bool refunded;
+	if (columns.totalSpent != "")
+	{
+		refunded = PluginTemplate::pointsDB->execute(fmt::format("UPDATE {0} SET {1}=COALESCE({1}, 0)+?, {2}=COALESCE({2}, 0)-? WHERE {3}=?", columns.table, columns.points, columns.totalSpent, columns.uniqueId),
+			{ int64_t{ cost }, int64_t{ cost }, eos_id.ToString() });
+	}
+	else
+	{
+		refunded = PluginTemplate::pointsDB->execute(fmt::format("UPDATE {0} SET {1}=COALESCE({1}, 0)+? WHERE {2}=?", columns.table, columns.points, columns.uniqueId),
+			{ int64_t{ cost }, eos_id.ToString() });
+	}
 
-			return true;
-		}
+	if (!refunded)
+	{
+		Log::GetLog()->error("No se pudieron devolver {} puntos a {}", cost, eos_id.ToString());
 	}
 
-	return false;
+	return refunded;
 }
 
 /**
@@ -358,42 +499,35 @@ nlohmann::json GetCommandString(const std::string permission, const std::string
 }
 
 /**
- * @brief Obtiene los grupos de permisos de un jugador.
- * 
- * Esta función consulta la base de datos de permisos para obtener
- * todos los grupos de permisos asignados a un jugador específico.
- * 
+ * @brief Consulta de la fila de permisos de un jugador.
+ *
  * @param eos_id ID de EOS del jugador.
- * @return TArray de FString con los grupos de permisos del jugador.
+ * @return SELECT con sus parámetros.
  */
-TArray<FString> GetPlayerPermissions(FString eos_id)
+BatchStatement PermissionsQuery(FString eos_id)
 {
-	TArray<FString> PlayerPerms = { "Default" };
-
-	std::string escaped_eos_id = PluginTemplate::permissionsDB->escapeString(eos_id.ToString());
-
 	std::string tablename = PluginTemplate::config["PermissionsDBSettings"].value("TableName", "Players");
 
 	std::string condition = PluginTemplate::config["PermissionsDBSettings"].value("UniqueIDField", "EOS_Id");
 
-	std::string query = fmt::format("SELECT * FROM {} WHERE {}='{}';", tablename, condition, escaped_eos_id);
-
-	std::vector<std::map<std::string, std::string>> results;
-	if (!PluginTemplate::permissionsDB->read(query, results))
-	{
-		if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
-		{
-			Log::GetLog()->warn("Error al leer la base de datos de permisos");
-		}
+	return { fmt::format("SELECT * FROM {} WHERE {}=?", tablename, condition), { eos_id.ToString() } };
+}
 
-		return PlayerPerms;
-	}
+/**
+ * @brief Obtiene los grupos de permisos de la fila leída con PermissionsQuery.
+ *
+ * @param results Fila de permisos del jugador.
+ * @return TArray de FString con los grupos de permisos del jugador, o Default si no tiene fila.
+ */
+TArray<FString> ParsePlayerPermissions(const ResultSet& results)
+{
+	TArray<FString> PlayerPerms = { "Default" };
 
-	if (results.size() <= 0) return PlayerPerms;
+	if (results.empty()) return PlayerPerms;
 
 	std::string permsfield = PluginTemplate::config["PermissionsDBSettings"].value("PermissionGroupField","PermissionGroups");
 
-	FString playerperms = FString(results[0].at(permsfield));
+	FString playerperms = FString(std::string(results.getString(0, permsfield)));
 
 	if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
 	{
@@ -406,18 +540,42 @@ TArray<FString> GetPlayerPermissions(FString eos_id)
 }
 
 /**
- * @brief Obtiene el grupo de permisos con mayor prioridad de un jugador.
+ * @brief Obtiene los grupos de permisos de un jugador.
  * 
- * Esta función determina cuál de los grupos de permisos asignados
- * a un jugador tiene la prioridad más alta (número más bajo).
+ * Esta función consulta la base de datos de permisos para obtener
+ * todos los grupos de permisos asignados a un jugador específico.
  * 
  * @param eos_id ID de EOS del jugador.
- * @return FString con el nombre del grupo de permisos de mayor prioridad.
+ * @return TArray de FString con los grupos de permisos del jugador.
  */
-FString GetPriorPermByEOSID(FString eos_id)
+TArray<FString> GetPlayerPermissions(FString eos_id)
 {
-	TArray<FString> player_groups = GetPlayerPermissions(eos_id);
+	BatchStatement query = PermissionsQuery(eos_id);
+
+	ReadAffinity affinity(eos_id.ToString());
 
+	ResultSet results;
+	if (!PluginTemplate::permissionsDB->read(query.query, query.params, results))
+	{
+		if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
+		{
+			Log::GetLog()->warn("Error al leer la base de datos de permisos");
+		}
+
+		results.clear();
+	}
+
+	return ParsePlayerPermissions(results);
+}
+
+/**
+ * @brief Elige el grupo de permisos con mayor prioridad (número más bajo).
+ *
+ * @param player_groups Grupos de permisos del jugador.
+ * @return FString con el nombre del grupo elegido, o Default si ninguno está configurado.
+ */
+FString GetPriorPerm(const TArray<FString>& player_groups)
+{
 	const nlohmann::json permGroups = PluginTemplate::config["PermissionGroups"];
 
 	std::string defaultGroup = "Default";
@@ -455,6 +613,143 @@ FString GetPriorPermByEOSID(FString eos_id)
 	return selectedPerm;
 }
 
+/**
+ * @brief Obtiene el grupo de permisos con mayor prioridad de un jugador.
+ * 
+ * Esta función determina cuál de los grupos de permisos asignados
+ * a un jugador tiene la prioridad más alta (número más bajo).
+ * 
+ * @param eos_id ID de EOS del jugador.
+ * @return FString con el nombre del grupo de permisos de mayor prioridad.
+ */
+FString GetPriorPermByEOSID(FString eos_id)
+{
+	return GetPriorPerm(GetPlayerPermissions(eos_id));
+}
+
+#ifndef PLUGINTEMPLATE_NO_MYSQL
+/**
+ * @brief Conector que atiende las consultas no bloqueantes de una base de datos.
+ *
+ * @param database Conector de la base de datos.
+ * @return El MySQLConnector si General.MysqlNonblocking está activado y la base de datos
+ *         es MySQL sin QueryCache ni réplicas, o nullptr para usar AsyncDatabase.
+ */
+MySQLConnector* NonblockingConnector(const std::shared_ptr<IDatabaseConnector>& database)
+{
+	if (PluginTemplate::config["General"].value("MysqlNonblocking", false) == false) return nullptr;
+
+	return dynamic_cast<MySQLConnector*>(database.get());
+}
+#endif
+
+/**
+ * @brief Indica si una base de datos admite el modo no bloqueante de MySQL.
+ *
+ * @param database Conector de la base de datos, o nullptr si está deshabilitada.
+ * @return true si startQuery puede atender sus consultas o no tiene ninguna.
+ */
+bool SupportsNonblocking(const std::shared_ptr<IDatabaseConnector>& database)
+{
+#ifdef PLUGINTEMPLATE_NO_MYSQL
+	return database == nullptr;
+#else
+	return database == nullptr || dynamic_cast<MySQLConnector*>(database.get()) != nullptr;
+#endif
+}
+
+/**
+ * @brief Obtiene el grupo de permisos de mayor prioridad sin bloquear el hilo del juego.
+ *
+ * Con General.MysqlNonblocking la consulta avanza en el tick con
+ * MySQLConnector::startQuery; si no, se ejecuta en AsyncDatabase. En ambos
+ * casos la continuación se ejecuta en el hilo del juego.
+ *
+ * @param eos_id ID de EOS del jugador.
+ * @param then Continuación que recibe el grupo de permisos.
+ * @param onError Continuación a ejecutar si la consulta lanza una excepción.
+ */
+void GetPriorPermByEOSIDAsync(FString eos_id, std::function<void(FString)> then, std::function<void()> onError)
+{
+#ifndef PLUGINTEMPLATE_NO_MYSQL
+	if (MySQLConnector* mysql = NonblockingConnector(PluginTemplate::permissionsDB))
+	{
+		mysql->startQuery(PermissionsQuery(eos_id), [then](bool success, ResultSet& results, uint64_t)
+		{
+			if (!success)
+			{
+				if (PluginTemplate::config["Debug"].value("Permissions", false) == true)
+				{
+					Log::GetLog()->warn("Error al leer la base de datos de permisos");
+				}
+
+				results.clear();
+			}
+
+			then(GetPriorPerm(ParsePlayerPermissions(results)));
+		});
+		return;
+	}
+#endif
+
+	AsyncDatabase::Get().run([eos_id]() { return GetPriorPermByEOSID(eos_id); }, std::move(then), std::move(onError));
+}
+
+/**
+ * @brief Versión de Points que no bloquea el hilo del juego.
+ *
+ * Con General.MysqlNonblocking la comprobación lee la fila con
+ * MySQLConnector::startQuery y el descuento es un único UPDATE condicional,
+ * que solo cambia la fila si el saldo alcanza. Si no, Points se ejecuta en
+ * AsyncDatabase. En ambos casos la continuación se ejecuta en el hilo del juego.
+ *
+ * @param eos_id ID de EOS del jugador.
+ * @param cost Costo en puntos del comando a ejecutar.
+ * @param check_points true para solo verificar el saldo, false para descontar el costo.
+ * @param then Continuación que recibe el resultado de Points.
+ * @param onError Continuación a ejecutar si la consulta lanza una excepción.
+ */
+void PointsAsync(FString eos_id, int cost, bool check_points, std::function<void(bool)> then, std::function<void()> onError)
+{
+#ifndef PLUGINTEMPLATE_NO_MYSQL
+	if (MySQLConnector* mysql = NonblockingConnector(PluginTemplate::pointsDB))
+	{
+		if (std::optional<bool> result = PointsWithoutQuery(cost))
+		{
+			then(*result);
+			return;
+		}
+
+		if (check_points)
+		{
+			mysql->startQuery(PointsBalance(eos_id), [cost, then](bool success, ResultSet& results, uint64_t)
+			{
+				if (!success && PluginTemplate::config["Debug"].value("Points", false) == true)
+				{
+					Log::GetLog()->warn("Error al leer la base de datos de puntos");
+				}
+
+				then(success && HasPoints(results, cost));
+			});
+			return;
+		}
+
+		mysql->startQuery(PointsDeduction(eos_id, cost), [then](bool success, ResultSet&, uint64_t affectedRows)
+		{
+			if (affectedRows == 0 && PluginTemplate::config["Debug"].value("Points", false) == true)
+			{
+				Log::GetLog()->warn("Error al actualizar la base de datos de puntos o el saldo no alcanza");
+			}
+
+			then(success && affectedRows > 0);
+		});
+		return;
+	}
+#endif
+
+	AsyncDatabase::Get().run([eos_id, cost, check_points]() { return Points(eos_id, cost, check_points); }, std::move(then), std::move(onError));
+}
+
 /**
  * @brief Agrega un nuevo jugador a la base de datos del plugin.
  * 
@@ -468,13 +763,40 @@ FString GetPriorPermByEOSID(FString eos_id)
  */
 bool AddPlayer(FString eosID, int playerID, FString playerName)
 {
-	std::vector<std::pair<std::string, std::string>> data = {
-		{"EosId", eosID.ToString()},
-		{"PlayerId", std::to_string(playerID)},
-		{"PlayerName", playerName.ToString()}
-	};
+	std::string query = PluginTemplate::PlayersTable::insert(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>());
+
+	ReadAffinity affinity(eosID.ToString());
+
+	PluginTemplate::PlayerRecord player;
+	player.eosId = eosID.ToString();
+	player.playerId = std::to_string(playerID);
+	player.playerName = playerName.ToString();
+
+	return PluginTemplate::pluginTemplateDB->execute(query, PluginTemplate::PlayersMapping::insertParams(player));
+}
+
+/**
+ * @brief Busca un jugador en la base de datos del plugin.
+ * 
+ * @param eosID ID de EOS del jugador.
+ * @return La fila del jugador, o std::nullopt si no existe o hubo un error.
+ */
+std::optional<PluginTemplate::PlayerRecord> FindPlayer(FString eosID)
+{
+	std::string query = PluginTemplate::PlayersTable::selectBy<"EosId">(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>());
+
+	ReadAffinity affinity(eosID.ToString());
+
+	ResultSet results;
+	if (!PluginTemplate::pluginTemplateDB->read(query, { eosID.ToString() }, results) || results.empty())
+	{
+		return std::nullopt;
+	}
 
-	return PluginTemplate::pluginTemplateDB->create(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>(), data);
+	PluginTemplate::PlayerRecord player;
+	PluginTemplate::PlayersMapping::read(results, 0, player);
+
+	return player;
 }
 
 /**
@@ -488,14 +810,7 @@ bool AddPlayer(FString eosID, int playerID, FString playerName)
  */
 bool ReadPlayer(FString eosID)
 {
-	std::string escaped_id = PluginTemplate::pluginTemplateDB->escapeString(eosID.ToString());
-
-	std::string query = fmt::format("SELECT * FROM {} WHERE EosId='{}'", PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>(), escaped_id);
-
-	std::vector<std::map<std::string, std::string>> results;
-	PluginTemplate::pluginTemplateDB->read(query, results);
-
-	return results.size() <= 0 ? false : true;
+	return FindPlayer(eosID).has_value();
 }
 
 /**
@@ -510,17 +825,61 @@ bool ReadPlayer(FString eosID)
  */
 bool UpdatePlayer(FString eosID, FString playerName)
 {
-	std::string unique_id = "EosId";
+	std::string query = PluginTemplate::PlayersTable::updateBy<"EosId", "PlayerName">(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>());
 
-	std::string escaped_id = PluginTemplate::pluginTemplateDB->escapeString(eosID.ToString());
+	ReadAffinity affinity(eosID.ToString());
 
-	std::vector<std::pair<std::string, std::string>> data = {
-		{"PlayerName", playerName.ToString() + "123"}
-	};
+	PluginTemplate::PlayerRecord player;
+	player.eosId = eosID.ToString();
+	player.playerName = playerName.ToString() + "123";
+
+	return PluginTemplate::pluginTemplateDB->execute(query, PluginTemplate::PlayersMapping::params<"PlayerName", "EosId">(player));
+}
+
+/**
+ * @brief Registra un jugador o actualiza su nombre si ya existe.
+ * 
+ * Usa una sola sentencia upsert sobre la columna única EosId, por lo que
+ * no necesita consultar antes si el jugador existe.
+ * 
+ * @param eosID ID de EOS del jugador.
+ * @param playerID ID del jugador.
+ * @param playerName Nombre del jugador.
+ * @return true si el jugador fue guardado exitosamente, false en caso contrario.
+ */
+bool UpsertPlayer(FString eosID, uint64 playerID, FString playerName)
+{
+	ReadAffinity affinity(eosID.ToString());
 
-	std::string condition = fmt::format("{}='{}'", unique_id, escaped_id);
+	PluginTemplate::PlayerRecord player;
+	player.eosId = eosID.ToString();
+	player.playerId = std::to_string(playerID);
+	player.playerName = playerName.ToString();
+
+	return PluginTemplate::pluginTemplateDB->upsert(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>(),
+		PluginTemplate::PlayersTable::insertColumns(),
+		{ PluginTemplate::PlayersMapping::insertParams(player) },
+		"EosId", { "PlayerName" });
+}
+
+/**
+ * @brief Encola el registro de un jugador en las escrituras diferidas.
+ * 
+ * La fila se escribe con UpsertPlayer en el siguiente vaciado de
+ * PluginTemplate::playerWrites; si el jugador no cambió no se escribe.
+ * 
+ * @param eosID ID de EOS del jugador.
+ * @param playerID ID del jugador.
+ * @param playerName Nombre del jugador.
+ */
+void QueuePlayerWrite(FString eosID, uint64 playerID, FString playerName)
+{
+	PluginTemplate::PlayerRecord player;
+	player.eosId = eosID.ToString();
+	player.playerId = std::to_string(playerID);
+	player.playerName = playerName.ToString();
 
-	return PluginTemplate::pluginTemplateDB->update(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>(), data, condition);
+	PluginTemplate::playerWrites.put(player.eosId, PluginTemplate::PlayersMapping::insertParams(player));
 }
 
 /**
@@ -534,11 +893,14 @@ bool UpdatePlayer(FString eosID, FString playerName)
  */
 bool DeletePlayer(FString eosID)
 {
-	std::string escaped_id = PluginTemplate::pluginTemplateDB->escapeString(eosID.ToString());
+	// Una escritura diferida no debe volver a crear al jugador
+	PluginTemplate::playerWrites.discard(eosID.ToString());
 
-	std::string condition = fmt::format("EosId='{}'", escaped_id);
+	std::string query = PluginTemplate::PlayersTable::deleteBy<"EosId">(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>());
 
-	return PluginTemplate::pluginTemplateDB->deleteRow(PluginTemplate::config["PluginDBSettings"]["TableName"].get<std::string>(), condition);
+	ReadAffinity affinity(eosID.ToString());
+
+	return PluginTemplate::pluginTemplateDB->execute(query, { eosID.ToString() });
 }
 
 /**
@@ -566,6 +928,8 @@ void ReadConfig()
 
 		Log::GetLog()->warn("Depuración {}", PluginTemplate::isDebug);
 
+		QueryStats::Get().configure(PluginTemplate::config["General"].value("SlowQueryMs", 200));
+
 	}
 	catch(const std::exception& error)
 	{
@@ -574,56 +938,145 @@ void ReadConfig()
 	}
 }
 
+/**
+ * @brief Migraciones de la tabla de jugadores del plugin.
+ * 
+ * Las migraciones nuevas se agregan al final con la versión siguiente;
+ * las ya publicadas no deben modificarse porque no se vuelven a ejecutar.
+ * 
+ * @param tableName Nombre de la tabla configurado en PluginDBSettings.
+ * @return Migraciones de la tabla en orden de versión.
+ */
+std::vector<Migration> PluginTableMigrations(const std::string& tableName)
+{
+	return {
+		{
+			1, "Tabla de jugadores",
+			{ PluginTemplate::PlayersTable::createTable(SqlDialect::MySQL, tableName) },
+			{ PluginTemplate::PlayersTable::createTable(SqlDialect::SQLite, tableName) }
+		}
+	};
+}
+
 /**
  * @brief Carga las conexiones a las bases de datos del plugin.
  * 
  * Esta función inicializa las conexiones a las bases de datos
  * utilizadas por el plugin, incluyendo la base de datos principal,
  * la base de datos de permisos y la base de datos de puntos.
- * También crea las tablas necesarias si no existen.
+ * Las tres conexiones se abren en paralelo y las que apuntan al mismo
+ * servidor o archivo comparten la conexión. También aplica las
+ * migraciones pendientes de la tabla del plugin.
+ * 
+ * Lanza una excepción si una conexión o una migración falla.
+ * 
+ * Se ejecuta fuera del hilo del juego, por lo que recibe una copia de
+ * la configuración en lugar de leer PluginTemplate::config.
+ * 
+ * @param config Copia de la configuración del plugin.
  */
-void LoadDatabase()
+void LoadDatabase(const nlohmann::json& config)
 {
 	Log::GetLog()->warn("Cargar base de datos");
-	PluginTemplate::pluginTemplateDB = DatabaseFactory::createConnector(PluginTemplate::config["PluginDBSettings"]);
 
-	nlohmann::ordered_json tableDefinition = {};
-	if (PluginTemplate::config["PluginDBSettings"].value("UseMySQL", true) == true)
+	auto open = [](const nlohmann::json& settings)
 	{
-		tableDefinition = {
-			{"Id", "INT NOT NULL AUTO_INCREMENT"},
-			{"EosId", "VARCHAR(50) NOT NULL"},
-			{"PlayerId", "VARCHAR(50) NOT NULL"},
-			{"PlayerName", "VARCHAR(50) NOT NULL"},
-			{"CreateAt", "DATETIME DEFAULT CURRENT_TIMESTAMP"},
-			{"PRIMARY", "KEY(Id)"},
-			{"UNIQUE", "INDEX EosId_UNIQUE (EosId ASC)"}
-		};
-	}
-	else
+		return std::async(std::launch::async, [&settings]()
+		{
+			return settings.value("Enabled", true) == true ? DatabaseFactory::createConnector(settings) : nullptr;
+		});
+	};
+
+	// Base de datos de permisos y de puntos (ArkShop)
+	std::future<std::shared_ptr<IDatabaseConnector>> permissionsDB = open(config["PermissionsDBSettings"]);
+	std::future<std::shared_ptr<IDatabaseConnector>> pointsDB = open(config["PointsDBSettings"]);
+
+	const nlohmann::json& pluginSettings = config["PluginDBSettings"];
+	PluginTemplate::pluginTemplateDB = DatabaseFactory::createConnector(pluginSettings);
+
+	std::string tableName = pluginSettings.value("TableName", "");
+
+	SchemaMigrator migrator(*PluginTemplate::pluginTemplateDB, tableName);
+	if (!migrator.migrate(PluginTableMigrations(tableName)))
 	{
-		tableDefinition = {
-			{"Id","INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT"},
-			{"EosId","TEXT NOT NULL UNIQUE"},
-			{"PlayerId","TEXT"},
-			{"PlayerName","TEXT"},
-			{"CreateAt","TIMESTAMP DEFAULT CURRENT_TIMESTAMP"}
-		};
+		throw std::runtime_error(fmt::format("No se pudieron aplicar las migraciones de {}.", tableName));
 	}
 
-	PluginTemplate::pluginTemplateDB->createTableIfNotExist(PluginTemplate::config["PluginDBSettings"].value("TableName", ""), tableDefinition);
+	PluginTemplate::playerWrites.configure(PluginTemplate::pluginTemplateDB.get(), tableName,
+		std::chrono::milliseconds(pluginSettings.value("WriteBehindFlushMs", 5000)),
+		pluginSettings.value("WriteBehindMaxEntries", 200));
 
+	PluginTemplate::permissionsDB = permissionsDB.get();
+	PluginTemplate::pointsDB = pointsDB.get();
+}
 
-	// Base de datos de permisos
-	if (PluginTemplate::config["PermissionsDBSettings"].value("Enabled", true) == true)
+/**
+ * @brief Inicia la carga de las bases de datos en segundo plano.
+ * 
+ * El hilo del juego sigue arrancando el servidor mientras se conecta.
+ * Al terminar, databaseState pasa a Ready, o a Failed si alguna
+ * conexión o migración lanzó una excepción.
+ */
+void StartDatabase()
+{
+	PluginTemplate::databaseLoad = std::async(std::launch::async, [config = PluginTemplate::config]()
 	{
-		PluginTemplate::permissionsDB = DatabaseFactory::createConnector(PluginTemplate::config["PermissionsDBSettings"]);
-	}
+		try
+		{
+			LoadDatabase(config);
 
-	// Base de datos de puntos (ArkShop)
-	if (PluginTemplate::config["PointsDBSettings"].value("Enabled", true) == true)
+			// Sin MySQL directo en permisos o puntos, sus consultas vuelven a AsyncDatabase y necesitan los hilos
+			if (config["General"].value("MysqlNonblocking", false) == true
+				&& (!SupportsNonblocking(PluginTemplate::permissionsDB) || !SupportsNonblocking(PluginTemplate::pointsDB)))
+			{
+				Log::GetLog()->warn("MysqlNonblocking requiere MySQL sin QueryCache ni réplicas en permisos y puntos; se usan los hilos de AsyncDatabase");
+				AsyncDatabase::Get().start(config["General"].value("DatabaseWorkers", 2));
+			}
+
+			PluginTemplate::databaseState = PluginTemplate::DatabaseState::Ready;
+			Log::GetLog()->info("Bases de datos listas");
+		}
+		catch (const std::exception& error)
+		{
+			PluginTemplate::databaseState = PluginTemplate::DatabaseState::Failed;
+			Log::GetLog()->error("Fallo al cargar las bases de datos. ERROR: {}", error.what());
+		}
+	});
+}
+
+/**
+ * @brief Inicia los hilos de AsyncDatabase.
+ *
+ * Con General.MysqlNonblocking no se inician: las consultas de permisos
+ * y puntos avanzan en el tick con MySQLConnector::startQuery, y el resto
+ * del trabajo de AsyncDatabase se ejecuta en el hilo del juego.
+ * StartDatabase los inicia igualmente si una de esas bases de datos no es
+ * MySQL directo.
+ */
+void StartDatabaseWorkers()
+{
+	if (PluginTemplate::config["General"].value("MysqlNonblocking", false) == true) return;
+
+	AsyncDatabase::Get().start(PluginTemplate::config["General"].value("DatabaseWorkers", 2));
+}
+
+/**
+ * @brief Comprueba si los comandos ya pueden usar las bases de datos.
+ * 
+ * @param message Recibe el mensaje para el jugador cuando todavía no pueden.
+ * @return true si las bases de datos están cargadas, false en caso contrario.
+ */
+bool IsDatabaseReady(std::string& message)
+{
+	switch (PluginTemplate::databaseState.load())
 	{
-		PluginTemplate::pointsDB = DatabaseFactory::createConnector(PluginTemplate::config["PointsDBSettings"]);
+	case PluginTemplate::DatabaseState::Ready:
+		return true;
+	case PluginTemplate::DatabaseState::Failed:
+		message = PluginTemplate::config["Messages"].value("DatabaseErrorMSG", "La base de datos no está disponible.");
+		return false;
+	default:
+		message = PluginTemplate::config["Messages"].value("InitializingMSG", "El plugin se está iniciando, inténtalo en unos segundos.");
+		return false;
 	}
-	
-}
\ No newline at end of file
+}
@@ -0,0 +1,527 @@
+#ifndef ARKAPI_STUB_ARK_H
+#define ARKAPI_STUB_ARK_H
+
+#pragma once
+
+/**
+ * @file Ark.h
+ * @brief Sustituto mínimo del API de AseApi para compilar el núcleo del plugin en Linux.
+ *
+ * Declara solo la parte del API que usa el plugin: FString, TArray, Log,
+ * los controladores e inventarios de los comandos y ArkApi::GetApiUtils,
+ * GetCommands y GetHooks. No hay servidor detrás: los comandos, ticks y
+ * jugadores se registran en memoria para que las herramientas de medición
+ * puedan invocarlos, y los mensajes a jugadores solo se cuentan.
+ *
+ * No debe usarse para compilar el plugin que se instala en el servidor.
+ */
+
+#include <atomic>
+#include <codecvt>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <initializer_list>
+#include <locale>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#ifndef _MSC_VER
+#define __declspec(x)
+#define __stdcall
+#endif
+
+using uint64 = unsigned long long;
+using uint32 = unsigned int;
+using int64 = long long;
+using int32 = int;
+
+namespace spdlog
+{
+	namespace level
+	{
+		enum level_enum
+		{
+			trace,
+			debug,
+			info,
+			warn,
+			err,
+			critical,
+			off
+		};
+	}
+}
+
+/**
+ * @class Logger
+ * @brief Registro con la interfaz de spdlog que escribe en stderr.
+ */
+class Logger
+{
+public:
+	void set_level(spdlog::level::level_enum value)
+	{
+		level.store(value, std::memory_order_relaxed);
+	}
+
+	template <typename... Args>
+	void debug(fmt::format_string<Args...> format, Args&&... args)
+	{
+		write(spdlog::level::debug, "debug", fmt::format(format, std::forward<Args>(args)...));
+	}
+
+	template <typename... Args>
+	void info(fmt::format_string<Args...> format, Args&&... args)
+	{
+		write(spdlog::level::info, "info", fmt::format(format, std::forward<Args>(args)...));
+	}
+
+	template <typename... Args>
+	void warn(fmt::format_string<Args...> format, Args&&... args)
+	{
+		write(spdlog::level::warn, "warning", fmt::format(format, std::forward<Args>(args)...));
+	}
+
+	template <typename... Args>
+	void error(fmt::format_string<Args...> format, Args&&... args)
+	{
+		write(spdlog::level::err, "error", fmt::format(format, std::forward<Args>(args)...));
+	}
+
+	template <typename... Args>
+	void critical(fmt::format_string<Args...> format, Args&&... args)
+	{
+		write(spdlog::level::critical, "critical", fmt::format(format, std::forward<Args>(args)...));
+	}
+
+private:
+	std::atomic<spdlog::level::level_enum> level{ spdlog::level::info };
+	std::mutex mutex;
+
+	void write(spdlog::level::level_enum messageLevel, const char* name, const std::string& message)
+	{
+		if (messageLevel < level.load(std::memory_order_relaxed)) return;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		std::fprintf(stderr, "[%s] %s\n", name, message.c_str());
+	}
+};
+
+/**
+ * @class Log
+ * @brief Acceso al registro del plugin, como el Log de AseApi.
+ */
+class Log
+{
+public:
+	static Log& Get()
+	{
+		static Log instance;
+		return instance;
+	}
+
+	void Init(const std::string& /*name*/)
+	{
+	}
+
+	static std::shared_ptr<Logger>& GetLog()
+	{
+		static std::shared_ptr<Logger> logger = std::make_shared<Logger>();
+		return logger;
+	}
+};
+
+template <typename T>
+class TArray
+{
+public:
+	TArray() = default;
+
+	TArray(std::initializer_list<T> values)
+		: items(values)
+	{
+	}
+
+	int Num() const { return static_cast<int>(items.size()); }
+	void Add(const T& value) { items.push_back(value); }
+	void Empty() { items.clear(); }
+
+	T& operator[](int index) { return items[index]; }
+	const T& operator[](int index) const { return items[index]; }
+
+	auto begin() { return items.begin(); }
+	auto end() { return items.end(); }
+	auto begin() const { return items.begin(); }
+	auto end() const { return items.end(); }
+
+private:
+	std::vector<T> items;
+};
+
+/**
+ * @class FString
+ * @brief Cadena ancha con la parte de la interfaz de FString que usa el plugin.
+ */
+class FString
+{
+public:
+	FString() = default;
+
+	FString(const std::string& value)
+		: text(fromUtf8(value))
+	{
+	}
+
+	FString(const char* value)
+		: FString(std::string(value))
+	{
+	}
+
+	FString(const wchar_t* value)
+		: text(value)
+	{
+	}
+
+	std::string ToString() const
+	{
+		return toUtf8(text);
+	}
+
+	bool IsEmpty() const { return text.empty(); }
+	const wchar_t* operator*() const { return text.c_str(); }
+	bool operator==(const FString& other) const { return text == other.text; }
+
+	int ParseIntoArray(TArray<FString>& out, const wchar_t* delimiter, bool cullEmpty) const
+	{
+		out.Empty();
+
+		std::wstring separator(delimiter);
+		size_t start = 0;
+
+		while (true)
+		{
+			size_t position = text.find(separator, start);
+			std::wstring part = text.substr(start, position == std::wstring::npos ? std::wstring::npos : position - start);
+
+			if (!(cullEmpty && part.empty()))
+			{
+				FString value;
+				value.text = std::move(part);
+				out.Add(value);
+			}
+
+			if (position == std::wstring::npos) break;
+			start = position + separator.size();
+		}
+
+		return out.Num();
+	}
+
+	template <typename... Args>
+	static FString Format(const char* format, Args&&... args)
+	{
+		return FString(fmt::format(fmt::runtime(format), std::forward<Args>(args)...));
+	}
+
+	template <typename... Args>
+	static FString Format(const wchar_t* format, Args&&... args)
+	{
+		return Format(toUtf8(format).c_str(), std::forward<Args>(args)...);
+	}
+
+private:
+	std::wstring text;
+
+	static std::wstring fromUtf8(const std::string& value)
+	{
+		return std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(value);
+	}
+
+	static std::string toUtf8(const std::wstring& value)
+	{
+		return std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(value);
+	}
+};
+
+struct FLinearColor
+{
+	float R, G, B, A;
+};
+
+namespace FColorList
+{
+	inline const FLinearColor Red{ 1.0f, 0.0f, 0.0f, 1.0f };
+	inline const FLinearColor Green{ 0.0f, 1.0f, 0.0f, 1.0f };
+	inline const FLinearColor Blue{ 0.0f, 0.0f, 1.0f, 1.0f };
+	inline const FLinearColor Orange{ 1.0f, 0.5f, 0.0f, 1.0f };
+}
+
+struct UTexture2D;
+struct UWorld;
+struct FDamageEvent {};
+
+/**
+ * @brief Objeto de inventario con la durabilidad que usa RepairInventory.
+ */
+struct UPrimalItem
+{
+	struct BitField
+	{
+		bool value = false;
+		bool Get() const { return value; }
+	};
+
+	BitField engram;
+	BitField skin;
+	bool usesDurability = true;
+	float durability = 0.0f;
+	float savedDurability = 100.0f;
+
+	BitField& bIsEngram() { return engram; }
+	BitField& bIsItemSkin() { return skin; }
+	bool UsesDurability() { return usesDurability; }
+	float& ItemDurabilityField() { return durability; }
+	float& SavedDurabilityField() { return savedDurability; }
+	void RepairItem(bool, float, float) { durability = savedDurability; }
+	void UpdatedItem(bool) {}
+};
+
+struct UPrimalInventoryComponent
+{
+	TArray<UPrimalItem*> items;
+	TArray<UPrimalItem*>& InventoryItemsField() { return items; }
+};
+
+struct AActor {};
+struct AController : AActor {};
+struct ACharacter : AActor {};
+
+struct APrimalCharacter : ACharacter
+{
+	UPrimalInventoryComponent* inventory = nullptr;
+	FString playerName;
+
+	UPrimalInventoryComponent*& MyInventoryComponentField() { return inventory; }
+	FString& PlayerNameField() { return playerName; }
+};
+
+struct AShooterCharacter : APrimalCharacter
+{
+	bool Die(float, FDamageEvent*, AController*, AActor*) { return true; }
+};
+
+struct APlayerController : AController {};
+
+struct AShooterPlayerController : APlayerController
+{
+	uint64 playerId = 0;
+	FString characterName;
+	ACharacter* character = nullptr;
+
+	uint64 GetLinkedPlayerID64() { return playerId; }
+	ACharacter*& CharacterField() { return character; }
+
+	FString* GetPlayerCharacterName(FString* result)
+	{
+		*result = characterName;
+		return result;
+	}
+};
+
+struct AShooterGameMode {};
+
+struct RCONPacket
+{
+	int Id = 0;
+};
+
+struct RCONClientConnection
+{
+	void SendMessageW(int, int, FString*) {}
+};
+
+#define DECLARE_HOOK(name, returnType, ...) \
+	typedef returnType(__stdcall* name ## _Func)(__VA_ARGS__); \
+	inline name ## _Func name ## _original; \
+	returnType Hook_ ## name(__VA_ARGS__)
+
+namespace ArkApi
+{
+	enum class ServerStatus
+	{
+		Loading,
+		Ready
+	};
+
+	/**
+	 * @class IApiUtils
+	 * @brief Jugadores conectados y mensajes, registrados en memoria.
+	 */
+	class IApiUtils
+	{
+	public:
+		ServerStatus GetStatus() const { return ServerStatus::Ready; }
+
+		/**
+		 * @brief Registra un jugador para que FindPlayerFromSteamId lo encuentre.
+		 */
+		void AddPlayer(AShooterPlayerController* player)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			players[player->playerId] = player;
+		}
+
+		void RemovePlayer(uint64 playerId)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			players.erase(playerId);
+		}
+
+		AShooterPlayerController* FindPlayerFromSteamId(uint64 playerId)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = players.find(playerId);
+			return it != players.end() ? it->second : nullptr;
+		}
+
+		template <typename T, typename... Args>
+		void SendNotification(AShooterPlayerController*, FLinearColor, float, float, UTexture2D*, const T*, Args&&...)
+		{
+			notifications.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		template <typename T, typename... Args>
+		void SendServerMessage(AShooterPlayerController*, FLinearColor, const T*, Args&&...)
+		{
+			serverMessages.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		template <typename T, typename... Args>
+		void SendNotificationToAll(FLinearColor, float, float, UTexture2D*, const T*, Args&&...)
+		{
+			notifications.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		template <typename T, typename... Args>
+		void SendChatMessageToAll(const FString&, const T*, Args&&...)
+		{
+			serverMessages.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::atomic<uint64> notifications{ 0 };
+		std::atomic<uint64> serverMessages{ 0 };
+
+	private:
+		std::mutex mutex;
+		std::unordered_map<uint64, AShooterPlayerController*> players;
+	};
+
+	inline IApiUtils& GetApiUtils()
+	{
+		static IApiUtils instance;
+		return instance;
+	}
+
+	/**
+	 * @class ICommands
+	 * @brief Comandos y callbacks registrados, que las herramientas invocan por nombre.
+	 */
+	class ICommands
+	{
+	public:
+		using ChatCommand = std::function<void(AShooterPlayerController*, FString*, int)>;
+		using ConsoleCommand = std::function<void(APlayerController*, FString*, bool)>;
+		using RconCommand = std::function<void(RCONClientConnection*, RCONPacket*, UWorld*)>;
+
+		void AddChatCommand(const FString& command, const ChatCommand& callback) { chatCommands[command.ToString()] = callback; }
+		bool RemoveChatCommand(const FString& command) { return chatCommands.erase(command.ToString()) > 0; }
+		void AddConsoleCommand(const FString& command, const ConsoleCommand& callback) { consoleCommands[command.ToString()] = callback; }
+		bool RemoveConsoleCommand(const FString& command) { return consoleCommands.erase(command.ToString()) > 0; }
+		void AddRconCommand(const FString& command, const RconCommand& callback) { rconCommands[command.ToString()] = callback; }
+		bool RemoveRconCommand(const FString& command) { return rconCommands.erase(command.ToString()) > 0; }
+		void AddOnTimerCallback(const FString& id, const std::function<void()>& callback) { timerCallbacks[id.ToString()] = callback; }
+		bool RemoveOnTimerCallback(const FString& id) { return timerCallbacks.erase(id.ToString()) > 0; }
+		void AddOnTickCallback(const FString& id, const std::function<void(float)>& callback) { tickCallbacks[id.ToString()] = callback; }
+		bool RemoveOnTickCallback(const FString& id) { return tickCallbacks.erase(id.ToString()) > 0; }
+
+		/**
+		 * @brief Ejecuta un comando de chat registrado, como si lo escribiera el jugador.
+		 *
+		 * @return false si el comando no está registrado.
+		 */
+		bool RunChatCommand(const std::string& command, AShooterPlayerController* player)
+		{
+			auto it = chatCommands.find(command);
+			if (it == chatCommands.end()) return false;
+
+			FString message(command);
+			it->second(player, &message, 0);
+			return true;
+		}
+
+		/**
+		 * @brief Ejecuta los callbacks de tick, como un tick del servidor.
+		 */
+		void Tick(float deltaSeconds)
+		{
+			for (auto& [id, callback] : tickCallbacks) callback(deltaSeconds);
+		}
+
+		/**
+		 * @brief Ejecuta los callbacks del temporizador de un segundo.
+		 */
+		void Timer()
+		{
+			for (auto& [id, callback] : timerCallbacks) callback();
+		}
+
+	private:
+		std::unordered_map<std::string, ChatCommand> chatCommands;
+		std::unordered_map<std::string, ConsoleCommand> consoleCommands;
+		std::unordered_map<std::string, RconCommand> rconCommands;
+		std::unordered_map<std::string, std::function<void()>> timerCallbacks;
+		std::unordered_map<std::string, std::function<void(float)>> tickCallbacks;
+	};
+
+	inline ICommands& GetCommands()
+	{
+		static ICommands instance;
+		return instance;
+	}
+
+	class IHooks
+	{
+	public:
+		template <typename Hook, typename Original>
+		bool SetHook(const std::string&, Hook, Original) { return true; }
+
+		template <typename Hook>
+		bool DisableHook(const std::string&, Hook) { return true; }
+	};
+
+	inline IHooks& GetHooks()
+	{
+		static IHooks instance;
+		return instance;
+	}
+
+	namespace Tools
+	{
+		/**
+		 * @brief Directorio del servidor; en el sustituto, el directorio de trabajo.
+		 */
+		inline std::string GetCurrentDir()
+		{
+			return ".";
+		}
+	}
+}
+
+#endif // ARKAPI_STUB_ARK_H
@@ -0,0 +1,41 @@
+#ifndef ARKAPI_STUB_REQUESTS_H
+#define ARKAPI_STUB_REQUESTS_H
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace API
+{
+	/**
+	 * @class Requests
+	 * @brief Sustituto de las peticiones HTTP de AseApi: no envía nada y responde con error.
+	 */
+	class Requests
+	{
+	public:
+		static Requests& Get()
+		{
+			static Requests instance;
+			return instance;
+		}
+
+		bool CreateGetRequest(const std::string& /*url*/, const std::function<void(bool, std::string)>& callback, std::vector<std::string> /*headers*/ = {})
+		{
+			callback(false, "");
+			return true;
+		}
+
+		bool CreatePostRequest(const std::string& /*url*/, const std::function<void(bool, std::string)>& callback, const std::string& /*content*/, const std::string& /*contentType*/,
+			std::vector<std::string> /*headers*/ = {})
+		{
+			callback(false, "");
+			return true;
+		}
+	};
+}
+
+#endif // ARKAPI_STUB_REQUESTS_H
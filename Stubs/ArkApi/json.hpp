@@ -0,0 +1,9 @@
+#ifndef ARKAPI_STUB_JSON_HPP
+#define ARKAPI_STUB_JSON_HPP
+
+#pragma once
+
+// AseApi incluye nlohmann/json como json.hpp; en Linux se usa el del sistema
+#include <nlohmann/json.hpp>
+
+#endif // ARKAPI_STUB_JSON_HPP